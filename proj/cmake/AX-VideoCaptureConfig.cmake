@@ -1,29 +1,82 @@
-if( NOT TARGET AX-VideoCapture )
+if( NOT TARGET AX-VideoCaptureCore )
+
+	# Headless builds drop Cinder and GL entirely. Captures run in software mode and hand
+	# out core Frames, there's no Surface / gl::Texture API.
+	option( AX_VIDEOCAPTURE_HEADLESS "Build AX-VideoCapture without Cinder or GL" OFF )
 
 	get_filename_component( AXMP_SOURCE_PATH "${CMAKE_CURRENT_LIST_DIR}/../../src" ABSOLUTE )
 	get_filename_component( CINDER_PATH "${CMAKE_CURRENT_LIST_DIR}/../../../" ABSOLUTE )
 
+	# Frame types, pooling, CPU frame processing, bandwidth planning, profile benchmarking, stats, logging, the flight recorder, the executor and pipeline stages. No Cinder, no GL and no device code, so it
+	# can be linked (and benchmarked) on its own.
+	set( AXMP_CORE_FILES
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureBandwidth.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureBandwidth.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureBenchmark.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureBenchmark.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureCore.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureCore.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureDeinterlace.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureDeinterlace.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureDenoise.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureDenoise.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureDerived.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureDerived.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureExecutor.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureExecutor.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureFlicker.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureFlicker.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureFlightRecorder.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureFlightRecorder.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureFramePool.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureFramePool.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureLog.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureLog.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureOcclusion.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureOcclusion.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureQueue.h"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureRemap.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureRemap.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureStabilize.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureStabilize.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureStage.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureStage.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureStats.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureStats.cxx"
+		"${AXMP_SOURCE_PATH}/AX-VideoCaptureViewport.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureViewport.cxx"
+	)
+
+	add_library( AX-VideoCaptureCore ${AXMP_CORE_FILES} )
+	target_include_directories( AX-VideoCaptureCore PUBLIC "${AXMP_SOURCE_PATH}" )
+	target_compile_features( AX-VideoCaptureCore PUBLIC cxx_std_17 )
+
+	find_package( Threads REQUIRED )
+	target_link_libraries( AX-VideoCaptureCore PUBLIC Threads::Threads )
+
 	if ( WIN32 )
 		file ( GLOB_RECURSE AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/msw/*.h" "${AXMP_SOURCE_PATH}/msw/*.cxx" )
 	elseif ( APPLE )
 		file ( GLOB_RECURSE AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/osx/*.h" "${AXMP_SOURCE_PATH}/osx/*.mm" )
 	else()
-		error ( "Unsupported platform" )
+		# No capture backend here, but the core still builds (and is what the tests link)
+		message( STATUS "AX-VideoCapture: unsupported platform, only AX-VideoCaptureCore is available" )
+		return()
 	endif()
 
 	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCapture.h" "${AXMP_SOURCE_PATH}/AX-VideoCapture.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureBandwidthDevice.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureBatch.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureBatch.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureBenchmarkDevice.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureMetrics.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureMetrics.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCapturePipeline.h" "${AXMP_SOURCE_PATH}/AX-VideoCapturePipeline.cxx" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureRuntime.h" )
+	list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureStitch.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureStitch.cxx" )
+
+	if( NOT AX_VIDEOCAPTURE_HEADLESS )
+		list( APPEND AXMP_SOURCE_FILES "${AXMP_SOURCE_PATH}/AX-VideoCaptureCinder.h" "${AXMP_SOURCE_PATH}/AX-VideoCaptureCinder.cxx" )
+	endif()
 
 	add_library( AX-VideoCapture ${AXMP_SOURCE_FILES} )
 
 	target_include_directories( AX-VideoCapture PUBLIC "${AXMP_SOURCE_PATH}" )
-	target_include_directories( AX-VideoCapture SYSTEM BEFORE PUBLIC "${CINDER_PATH}/include" )
+	target_link_libraries( AX-VideoCapture PUBLIC AX-VideoCaptureCore )
 
-	if( NOT TARGET cinder )
-		include( "${CINDER_PATH}/proj/cmake/configure.cmake" )
-		find_package( cinder REQUIRED PATHS "${CINDER_PATH}/${CINDER_LIB_DIRECTORY}" "$ENV{CINDER_PATH}/${CINDER_LIB_DIRECTORY}" )
-	endif()
+	if( AX_VIDEOCAPTURE_HEADLESS )
+		target_compile_definitions( AX-VideoCapture PUBLIC AX_VIDEOCAPTURE_HEADLESS )
+	else()
+		target_include_directories( AX-VideoCapture SYSTEM BEFORE PUBLIC "${CINDER_PATH}/include" )
 
-	target_link_libraries( AX-VideoCapture PRIVATE cinder )
+		if( NOT TARGET cinder )
+			include( "${CINDER_PATH}/proj/cmake/configure.cmake" )
+			find_package( cinder REQUIRED PATHS "${CINDER_PATH}/${CINDER_LIB_DIRECTORY}" "$ENV{CINDER_PATH}/${CINDER_LIB_DIRECTORY}" )
+		endif()
+
+		target_link_libraries( AX-VideoCapture PRIVATE cinder )
+	endif()
 	
 endif()
 
@@ -0,0 +1,169 @@
+//
+//  ProfileBenchmark.cxx
+//  ProfileBenchmark
+//
+//  Created by Andrew Wright on 18/10/26.
+//  (c) 2026 AX Interactive
+//
+//  Steps through every profile a camera advertises and reports what it really delivers.
+//
+//  ProfileBenchmark [--device <index|name>] [--seconds 5] [--warmup 1] [--subtype MJPG]
+//                   [--hardware] [--csv out.csv] [--json out.json] [--synthetic] [--list]
+//
+
+#include "AX-VideoCapture.h"
+#include "AX-VideoCaptureBenchmark.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <objbase.h>
+#endif
+
+using namespace AX::Video;
+
+static std::vector<ProfileBenchmark::SyntheticMode> MakeSyntheticModes ( )
+{
+    using PixelFormat = Capture::PixelFormat;
+
+    // A camera that over-promises at high frame rates, and has one mode that won't start
+    std::vector<ProfileBenchmark::SyntheticMode> modes;
+    auto add = [&] ( int w, int h, int fps, PixelFormat subtype, double sustained, double dropRate, bool fails = false )
+    {
+        ProfileBenchmark::SyntheticMode mode;
+        mode.Profile = { { w, h }, { fps, 1 }, subtype };
+        mode.SustainedFPS = sustained;
+        mode.DropRate = dropRate;
+        mode.FailsToStart = fails;
+        modes.push_back ( mode );
+    };
+
+    add ( 1920, 1080, 60, PixelFormat::MJPEG, 30.0, 0.00 );
+    add ( 1920, 1080, 30, PixelFormat::MJPEG, 0.0, 0.01 );
+    add ( 1280, 720, 60, PixelFormat::MJPEG, 0.0, 0.02 );
+    add ( 1920, 1080, 5, PixelFormat::YUY2, 0.0, 0.0, true );
+    add ( 640, 480, 30, PixelFormat::YUY2, 0.0, 0.0 );
+    return modes;
+}
+
+static Capture::PixelFormat ParseSubtype ( const std::string& name )
+{
+    for ( int i = 0; i <= (int)Capture::PixelFormat::H264; i++ )
+    {
+        auto format = (Capture::PixelFormat)i;
+        if ( name == Capture::ToString ( format ) ) return format;
+    }
+
+    return Capture::PixelFormat::Unknown;
+}
+
+int main ( int argc, char** argv )
+{
+#ifdef _WIN32
+    CoInitializeEx ( nullptr, COINIT_MULTITHREADED );
+#endif
+
+    std::string device;
+    std::string csv;
+    std::string json;
+    bool synthetic = false;
+    bool hardware = false;
+    bool list = false;
+    ProfileBenchmark::Options options;
+    std::vector<Capture::PixelFormat> subtypes;
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        auto arg = std::string ( argv[i] );
+        auto next = [&] { return i + 1 < argc ? std::string ( argv[++i] ) : std::string ( ); };
+
+        if ( arg == "--device" ) device = next ( );
+        else if ( arg == "--seconds" ) options.Duration ( std::atof ( next ( ).c_str ( ) ) );
+        else if ( arg == "--warmup" ) options.Warmup ( std::atof ( next ( ).c_str ( ) ) );
+        else if ( arg == "--subtype" ) subtypes.push_back ( ParseSubtype ( next ( ) ) );
+        else if ( arg == "--csv" ) csv = next ( );
+        else if ( arg == "--json" ) json = next ( );
+        else if ( arg == "--hardware" ) hardware = true;
+        else if ( arg == "--synthetic" ) synthetic = true;
+        else if ( arg == "--list" ) list = true;
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    options.Subtypes ( subtypes );
+
+    Capture::DeviceDescriptor descriptor;
+    ProfileBenchmark::SourceRef source;
+
+    if ( synthetic )
+    {
+        descriptor = { "Synthetic Camera", "synthetic" };
+        source = ProfileBenchmark::CreateSyntheticSource ( descriptor.Name, MakeSyntheticModes ( ) );
+    } else
+    {
+        auto devices = Capture::GetDevices ( );
+        if ( list )
+        {
+            for ( size_t i = 0; i < devices.size ( ); i++ ) std::cout << i << ": " << devices[i] << "\n";
+            return 0;
+        }
+
+        if ( devices.empty ( ) )
+        {
+            std::cerr << "No capture devices found.\n";
+            return 1;
+        }
+
+        descriptor = devices[0];
+        if ( !device.empty ( ) )
+        {
+            bool isIndex = std::all_of ( device.begin ( ), device.end ( ), ::isdigit );
+            auto found = std::find_if ( devices.begin ( ), devices.end ( ), [&] ( const auto& d ) { return d.Name.find ( device ) != std::string::npos; } );
+
+            if ( isIndex && std::stoul ( device ) < devices.size ( ) ) descriptor = devices[std::stoul ( device )];
+            else if ( found != devices.end ( ) ) descriptor = *found;
+            else
+            {
+                std::cerr << "No device matching '" << device << "'\n";
+                return 1;
+            }
+        }
+
+        source = ProfileBenchmark::CreateDeviceSource ( descriptor, hardware );
+    }
+
+    std::cout << "Benchmarking " << descriptor << "\n";
+
+    auto results = ProfileBenchmark ( options ).Run ( *source, [] ( const ProfileBenchmark::Result& r )
+    {
+        if ( !r.Started )
+        {
+            std::printf ( "  %-24s failed to start\n", r.Profile.Key ( ).c_str ( ) );
+            return;
+        }
+
+        std::printf ( "  %-24s %6.2f / %6.2f fps  jitter %5.2fms  latency %6.2fms (p95 %6.2fms)  cpu %5.1f%%  drops %llu\n",
+                      r.Profile.Key ( ).c_str ( ), r.DeliveredFPS, r.AdvertisedFPS, r.JitterMs, r.LatencyMs, r.LatencyP95Ms, r.CPUPercent, (unsigned long long)r.Drops );
+    } );
+
+    // Synthetic results would stand in for a real camera's in the profile cache
+    if ( !synthetic ) ProfileBenchmark::Publish ( descriptor, results );
+
+    if ( !csv.empty ( ) && !ProfileBenchmark::WriteCSV ( csv, results ) ) std::cerr << "Couldn't write " << csv << "\n";
+    if ( !json.empty ( ) && !ProfileBenchmark::WriteJSON ( json, descriptor.Name, results ) ) std::cerr << "Couldn't write " << json << "\n";
+
+    source = nullptr;
+
+#ifdef _WIN32
+    CoUninitialize ( );
+#endif
+
+    return 0;
+}
@@ -39,6 +39,7 @@ public:
     void setup ( ) override;
     void update ( ) override;
     void draw ( ) override;
+    void cleanup ( ) override;
     
 protected:
 
@@ -47,6 +48,7 @@ protected:
     
     void                                MakeCapture ( const DeviceDescriptor& device, std::optional<DeviceProfile> profile = {} );
 
+    AX::Video::CaptureRuntimeRef        _runtime;
     AX::Video::CaptureRef               _capture;
     bool                                _hardwareAccelerated{ true };
     gl::TextureRef                      _texture;
@@ -63,6 +65,11 @@ void SimpleCaptureApp::setup ( )
     console() << gl::getString(GL_RENDERER) << std::endl;
     console() << gl::getString(GL_VERSION) << std::endl;
 
+    // Pay for Media Foundation and the D3D device once, up front, rather than in MakeCapture
+    _runtime = AX::Video::CaptureRuntime::Prewarm ( _hardwareAccelerated );
+    auto timings = AX::Video::CaptureRuntime::GetTimings ( );
+    console() << "Capture runtime: " << timings.StartupMs << "ms, device: " << timings.DeviceStartupMs << "ms" << std::endl;
+
     if ( !AX::Video::Capture::GetDevices ( ).empty ( ) )
     {
         MakeCapture ( AX::Video::Capture::GetDevices ( ).back ( ) );
@@ -93,9 +100,15 @@ void SimpleCaptureApp::MakeCapture ( const AX::Video::Capture::DeviceDescriptor&
 
     if ( profile ) fmt.Profile ( *profile );
 
+    // The old device shuts down in the background rather than hitching this frame
+    AX::Video::Capture::DestroyAsync ( _capture );
     _capture = AX::Video::Capture::Create ( fmt );
     _capture->OnStart.connect ( [] { std::cout << "Device started.\n"; } );
     _capture->OnStop.connect ( [] { std::cout << "Device stopped.\n"; } );
+    _capture->OnFormatChanged.connect ( [] ( const AX::Video::Capture::Format& format )
+    {
+        std::printf ( "Format changed: %dx%d @ %d/%d\n", format.Size ( ).x, format.Size ( ).y, format.FPS ( ).x, format.FPS ( ).y );
+    } );
     _capture->OnControlChanged.connect ( []( const AX::Video::Capture::Control& control )
     {
         std::printf ( "Device control '%s' is now %d\n", control.Name ( ).c_str ( ), control.Value ( ) );
@@ -126,12 +139,17 @@ void SimpleCaptureApp::MakeCapture ( const AX::Video::Capture::DeviceDescriptor&
     _capture->OnDeviceLost.connect ( [=] 
     { 
         std::cout << "Device lost.\n"; 
-        // Destroy the CaptureRef next frame, doing so from
-        // directly within the event signal would crash.
-        dispatchAsync ( [=] { _capture = nullptr; } );
+        AX::Video::Capture::DestroyAsync ( _capture );
     } );
 }
 
+void SimpleCaptureApp::cleanup ( )
+{
+    _capture = nullptr;
+    _runtime = nullptr;
+    AX::Video::CaptureRuntime::Shutdown ( );
+}
+
 void SimpleCaptureApp::update ( )
 {
     if ( _capture )
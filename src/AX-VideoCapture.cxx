@@ -8,10 +8,14 @@
 //
 
 #include "AX-VideoCapture.h"
-#include "cinder/app/App.h"
+#include "AX-VideoCaptureExecutor.h"
+#include "AX-VideoCaptureLog.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <unordered_map>
 
 #ifdef WIN32
@@ -20,8 +24,6 @@
     #error "Unsupported platform"
 #endif
 
-using namespace ci;
-
 namespace AX
 {
     namespace Video
@@ -42,25 +44,114 @@ namespace AX
             return Impl::GetDevices ( refresh );
         }
 
-        std::vector<Capture::DeviceProfile> Capture::GetProfiles ( const DeviceDescriptor& descriptor )
+        namespace
+        {
+            struct ProfileCache
+            {
+                std::mutex                                                      Mutex;
+                std::unordered_map<std::string, std::vector<Capture::DeviceProfile>> Profiles;
+                std::unordered_map<std::string, Capture::ProfileMeasurement>    Measurements;
+
+                static std::string MeasurementKey ( const Capture::DeviceDescriptor& descriptor, const Capture::DeviceProfile& profile )
+                {
+                    return descriptor.ID + "|" + profile.Key ( );
+                }
+            };
+
+            ProfileCache& GetProfileCache ( )
+            {
+                static ProfileCache kCache;
+                return kCache;
+            }
+
+            // Raw pointers, removed by ~Capture, so a visitor can never end up holding the
+            // last reference and destroying a capture on its own thread
+            struct CaptureRegistry
+            {
+                std::mutex                      Mutex;
+                std::vector<const Capture *>    Captures;
+            };
+
+            CaptureRegistry& GetCaptureRegistry ( )
+            {
+                static CaptureRegistry kRegistry;
+                return kRegistry;
+            }
+        }
+
+        void Capture::ForEachCapture ( const std::function<void ( const Capture& capture )>& fn )
+        {
+            auto& registry = GetCaptureRegistry ( );
+            std::lock_guard<std::mutex> lock ( registry.Mutex );
+            for ( auto capture : registry.Captures ) fn ( *capture );
+        }
+
+        std::vector<Capture::DeviceProfile> Capture::GetProfiles ( const DeviceDescriptor& descriptor, bool refresh )
+        {
+            auto& cache = GetProfileCache ( );
+            {
+                std::lock_guard<std::mutex> lock ( cache.Mutex );
+                auto it = cache.Profiles.find ( descriptor.ID );
+                if ( it != cache.Profiles.end ( ) && !refresh ) return it->second;
+            }
+
+            // Enumerating activates the device source, which is slow, so don't hold the lock for it
+            auto profiles = Impl::GetProfiles ( descriptor );
+
+            std::lock_guard<std::mutex> lock ( cache.Mutex );
+            for ( auto& profile : profiles )
+            {
+                auto measured = cache.Measurements.find ( ProfileCache::MeasurementKey ( descriptor, profile ) );
+                if ( measured != cache.Measurements.end ( ) ) profile.Measured = measured->second;
+            }
+
+            cache.Profiles[descriptor.ID] = profiles;
+            return profiles;
+        }
+
+        void Capture::SetMeasurement ( const DeviceDescriptor& descriptor, const DeviceProfile& profile, const ProfileMeasurement& measurement )
+        {
+            auto& cache = GetProfileCache ( );
+            std::lock_guard<std::mutex> lock ( cache.Mutex );
+            cache.Measurements[ProfileCache::MeasurementKey ( descriptor, profile )] = measurement;
+
+            auto it = cache.Profiles.find ( descriptor.ID );
+            if ( it != cache.Profiles.end ( ) )
+            {
+                for ( auto& p : it->second )
+                {
+                    if ( p == profile ) p.Measured = measurement;
+                }
+            }
+        }
+
+        Capture::DeviceTopology Capture::GetDeviceTopology ( const DeviceDescriptor& descriptor )
+        {
+            return Impl::GetDeviceTopology ( descriptor );
+        }
+
+        double Capture::GetTime ( )
         {
-            return Impl::GetProfiles ( descriptor );
+            return Impl::GetTime ( );
         }
 
-        signals::Signal<void ( AX::Video::Capture::DeviceDescriptor )>& Capture::OnDeviceAdded ( )
+        Capture::DeviceSignal& Capture::OnDeviceAdded ( )
         {
-            static signals::Signal<void ( AX::Video::Capture::DeviceDescriptor )> kSignal;
+            Impl::WatchDevices ( );
+            static DeviceSignal kSignal;
             return kSignal;
         }
 
-        signals::Signal<void ( AX::Video::Capture::DeviceDescriptor )>& Capture::OnDeviceRemoved ( )
+        Capture::DeviceSignal& Capture::OnDeviceRemoved ( )
         {
-            static signals::Signal<void ( AX::Video::Capture::DeviceDescriptor )> kSignal;
+            Impl::WatchDevices ( );
+            static DeviceSignal kSignal;
             return kSignal;
         }
 
         Capture::Capture ( const Format& fmt )
             : _format ( fmt )
+            , _viewport ( fmt.ElectronicPTZ ( ) )
         {
             GetDevices ( );
 
@@ -73,28 +164,72 @@ namespace AX
                 }
             }
             
-            _impl = std::make_unique<Impl> ( *this, _format );
+#ifdef AX_VIDEOCAPTURE_HEADLESS
+            // There's no GL context to share textures with
+            _format.HardwareAccelerated ( false );
+#endif
+
+            _flightRecorder = FlightRecorder::Create ( );
+            _flightRecorder->SetThumbnails ( _format.FlightRecordThumbnails ( ) );
+
+            _impl.reset ( new Impl ( *this, _format ) );
             _isValid = _impl->IsValid ( );
+
+            auto& registry = GetCaptureRegistry ( );
+            std::lock_guard<std::mutex> lock ( registry.Mutex );
+            registry.Captures.push_back ( this );
+        }
+
+        void Capture::ImplDeleter::operator() ( Impl* impl ) const
+        {
+            impl->Detach ( );
+            impl->Teardown ( );
+            impl->Release ( );
+        }
+
+        void Capture::DestroyAsync ( CaptureRef& capture )
+        {
+            if ( !capture ) return;
+
+            {
+                // Out of the registry first, so nothing visiting it sees _impl go away
+                auto& registry = GetCaptureRegistry ( );
+                std::lock_guard<std::mutex> lock ( registry.Mutex );
+                registry.Captures.erase ( std::remove ( registry.Captures.begin ( ), registry.Captures.end ( ), capture.get ( ) ), registry.Captures.end ( ) );
+            }
+
+            if ( auto impl = capture->_impl.release ( ) )
+            {
+                impl->Detach ( );
+                Executor::Get ( )->Submit ( [impl]
+                {
+                    impl->Teardown ( );
+                    impl->Release ( );
+                }, Executor::Priority::Background );
+            }
+
+            capture->_isValid = false;
+            capture = nullptr;
         }
 
         void Capture::Start ( )
         {
-            _impl->Start ( );
+            if ( _impl ) _impl->Start ( );
         }
 
         void Capture::Stop ( )
         {
-            _impl->Stop ( );
+            if ( _impl ) _impl->Stop ( );
         }
 
         bool Capture::IsStarted ( ) const
         {
-            return _impl->IsStarted ( );
+            return _impl && _impl->IsStarted ( );
         }
 
         bool Capture::IsStopped ( ) const
         {
-            return _impl->IsStopped ( );
+            return !_impl || _impl->IsStopped ( );
         }
 
         bool Capture::IsValid ( ) const
@@ -104,26 +239,109 @@ namespace AX
 
         bool Capture::CheckNewFrame ( ) const
         {
-            return _impl->CheckNewFrame ( );
+            return _impl && _impl->CheckNewFrame ( );
+        }
+
+        bool Capture::WaitForFrame ( double timeout ) const
+        {
+            return _impl && _impl->WaitForFrame ( timeout );
+        }
+
+        Capture::Stats Capture::GetStats ( ) const
+        {
+            return _impl ? _impl->GetStats ( ) : Stats ( );
+        }
+
+        void Capture::ResetStats ( )
+        {
+            if ( _impl ) _impl->ResetStats ( );
+        }
+
+        void Capture::SetBufferProvider ( const BufferProvider& provider )
+        {
+            if ( _impl ) _impl->SetBufferProvider ( provider );
+        }
+
+        const Vec2i& Capture::GetSize ( ) const
+        {
+            return _impl ? _impl->GetSize ( ) : _format.Size ( );
         }
 
-        const ivec2& Capture::GetSize ( ) const
+        FrameRef Capture::GetFrame ( ) const
         {
-            return _impl->GetSize ( );
+            return _impl ? _impl->GetFrame ( ) : nullptr;
         }
 
-        const Surface8uRef & Capture::GetSurface ( ) const
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        ci::Surface8uRef Capture::GetSurface ( ) const
         {
-            return _impl->GetSurface ( );
+            return _impl ? _impl->GetSurface ( ) : nullptr;
         }
 
         Capture::FrameLeaseRef Capture::GetTexture ( ) const
         {
-            return _impl->GetTexture ( );
+            return _impl ? _impl->GetTexture ( ) : nullptr;
+        }
+#endif
+
+        void Capture::DumpFlightRecord ( const std::string& reason )
+        {
+            if ( _format.FlightRecordPath ( ).empty ( ) ) return;
+
+            // Snapshot now, before the events that matter are overwritten, and write it out on the side
+            static std::atomic<uint32_t> kDumpCount{ 0 };
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds> ( std::chrono::system_clock::now ( ).time_since_epoch ( ) ).count ( );
+            auto path = _format.FlightRecordPath ( ) + "-" + std::to_string ( seconds ) + "-" + std::to_string ( kDumpCount++ ) + ( _format.FlightRecordBinary ( ) ? ".bin" : ".json" );
+            auto snapshot = std::make_shared<FlightRecorder::Snapshot> ( _flightRecorder->TakeSnapshot ( reason ) );
+            bool binary = _format.FlightRecordBinary ( );
+
+            Executor::Get ( )->Submit ( [=]
+            {
+                bool written = binary ? FlightRecorder::WriteBinary ( *snapshot, path ) : FlightRecorder::WriteJSON ( *snapshot, path );
+                if ( !written ) AX_LOG ( LogLevel::Warning, "Unable to write flight record to %s", path.c_str ( ) );
+            }, Executor::Priority::Background );
+        }
+
+        uint64_t Capture::AddFrameCallback ( const FrameCallback& callback )
+        {
+            std::lock_guard<std::mutex> lock ( _frameCallbackMutex );
+            auto callbacks = _frameCallbacks ? std::make_shared<FrameCallbackList> ( *_frameCallbacks ) : std::make_shared<FrameCallbackList> ( );
+            uint64_t id = _nextFrameCallbackID++;
+            callbacks->emplace_back ( id, callback );
+            std::atomic_store ( &_frameCallbacks, std::shared_ptr<const FrameCallbackList> ( callbacks ) );
+            return id;
+        }
+
+        void Capture::RemoveFrameCallback ( uint64_t id )
+        {
+            std::lock_guard<std::mutex> lock ( _frameCallbackMutex );
+            if ( !_frameCallbacks ) return;
+
+            auto callbacks = std::make_shared<FrameCallbackList> ( *_frameCallbacks );
+            callbacks->erase ( std::remove_if ( callbacks->begin ( ), callbacks->end ( ), [=] ( const auto& c ) { return c.first == id; } ), callbacks->end ( ) );
+            std::atomic_store ( &_frameCallbacks, std::shared_ptr<const FrameCallbackList> ( callbacks ) );
+        }
+
+        void Capture::DispatchFrame ( const FrameRef& frame )
+        {
+            // Copy-on-write list, so the capture thread never waits on (Add|Remove)FrameCallback
+            auto callbacks = std::atomic_load ( &_frameCallbacks );
+            if ( !callbacks ) return;
+
+            for ( auto& [id, callback] : *callbacks )
+            {
+                callback ( frame );
+            }
         }
 
         Capture::~Capture ( )
         {
+            {
+                auto& registry = GetCaptureRegistry ( );
+                std::lock_guard<std::mutex> lock ( registry.Mutex );
+                registry.Captures.erase ( std::remove ( registry.Captures.begin ( ), registry.Captures.end ( ), this ), registry.Captures.end ( ) );
+            }
+
             _impl = nullptr;
         }
     }
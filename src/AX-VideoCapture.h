@@ -9,75 +9,56 @@
 
 #pragma once
 
-#include "cinder/Cinder.h"
-#include "cinder/Surface.h"
-#include "cinder/Signals.h"
-#include "cinder/gl/Texture.h"
-#include "cinder/Filesystem.h"
-#include "cinder/DataSource.h"
-#include "cinder/Noncopyable.h"
+#include "AX-VideoCaptureCore.h"
+#include "AX-VideoCaptureDeinterlace.h"
+#include "AX-VideoCaptureDenoise.h"
+#include "AX-VideoCaptureDerived.h"
+#include "AX-VideoCaptureFlicker.h"
+#include "AX-VideoCaptureOcclusion.h"
+#include "AX-VideoCaptureRemap.h"
+#include "AX-VideoCaptureStabilize.h"
+#include "AX-VideoCaptureViewport.h"
+#include "AX-VideoCaptureFlightRecorder.h"
+#include "AX-VideoCaptureRuntime.h"
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+    #include "AX-VideoCaptureCinder.h"
+    #include "cinder/Signals.h"
+    #include "cinder/Area.h"
+#endif
+
+#include <functional>
+#include <mutex>
 
 namespace AX::Video
 {
+#ifdef AX_VIDEOCAPTURE_HEADLESS
+    template <typename Signature> using CaptureSignal = Signal<Signature>;
+#else
+    template <typename Signature> using CaptureSignal = ci::signals::Signal<Signature>;
+#endif
+
     using CaptureRef = std::shared_ptr<class Capture>;
-    class Capture : public ci::Noncopyable
+    class Capture : public std::enable_shared_from_this<Capture>
     {
     public:
 
         class Impl;
-        
-        class FrameLease
-        {
-        public:
-            virtual ~FrameLease ( ) { };
-
-            operator bool ( ) const { return IsValid ( ); }
-            operator ci::gl::TextureRef ( ) const { return ToTexture ( ); }
-            virtual ci::gl::TextureRef ToTexture ( ) const { return nullptr; }
-
-        protected:
-            virtual bool IsValid ( ) const { return false; };
-        };
 
-        struct DeviceProfile
-        {
-            ci::ivec2 Size;
-            ci::ivec2 FPS;
-
-            bool operator == ( const DeviceProfile& other ) const
-            {
-                return Size == other.Size && FPS == other.FPS;
-            }
-
-            bool operator < ( const DeviceProfile& other ) const
-            {
-                return Key ( ) < other.Key ( );
-            }
-
-            std::string Key ( ) const
-            {
-                char buffer[32] = {};
-                float fps = ( (float)( FPS.x ) / (float)( FPS.y ) );
-                std::snprintf ( buffer, sizeof(buffer), "%dx%d@%g", Size.x, Size.y, fps );
-                return buffer;
-            }
-        };
-
-        struct DeviceDescriptor
-        {
-            std::string Name;
-            std::string ID;
-            
-            bool operator == ( const DeviceDescriptor& other ) const
-            {
-                return Name == other.Name && ID == other.ID;
-            }
-
-            bool operator < ( const DeviceDescriptor& other ) const
-            {
-                return Name < other.Name && ID < other.ID;
-            }
-        };
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        using  FrameLease           = Video::FrameLease;
+        using  FrameLeaseRef        = Video::FrameLeaseRef;
+#endif
+        using  PixelFormat          = Video::PixelFormat;
+        using  ProfileMeasurement   = Video::ProfileMeasurement;
+        using  DeviceProfile        = Video::DeviceProfile;
+        using  DeviceDescriptor     = Video::DeviceDescriptor;
+        using  BusSpeed             = Video::BusSpeed;
+        using  DeviceTopology       = Video::DeviceTopology;
+        using  Stats                = CaptureStats;
+        using  BufferProvider       = Video::BufferProvider;
+
+        static const char *             ToString ( PixelFormat format ) { return Video::ToString ( format ); }
 
         enum class Rotation
         {
@@ -123,64 +104,150 @@ namespace AX::Video
         {
             Format ( ) { };
     
-            Format& Size ( const ci::ivec2& size ) { _size = size; return *this; }
+            Format& Size ( const Vec2i& size ) { _size = size; return *this; }
             Format& FPS ( int fps ) { _fps.x = fps; return *this; }
             Format& FPS ( int numerator, int denominator ) { _fps = { numerator, denominator }; return *this; }
             Format& Device ( const DeviceDescriptor& device ) { _device = device; return *this; }
             Format& HardwareAccelerated ( bool accelerated ) { _hardwareAccelerated = accelerated; return *this; }
             Format& RotationAngle ( Rotation rotation ) { _rotation = rotation; return *this; }
             Format& AutoStart ( bool autoStart ) { _autoStart = autoStart; return *this; }
-            Format& Profile ( const DeviceProfile& profile ) { Size ( profile.Size ); FPS ( profile.FPS.x, profile.FPS.y ); return *this; }
-
-            const ci::ivec2& Size ( ) const { return _size; }
-            const ci::ivec2& FPS ( ) const { return _fps; }
+            Format& Subtype ( PixelFormat subtype ) { _subtype = subtype; return *this; }
+            Format& Profile ( const DeviceProfile& profile ) { Size ( profile.Size ); FPS ( profile.FPS.x, profile.FPS.y ); Subtype ( profile.Subtype ); return *this; }
+            // Where the flight recorder is dumped when the capture errors or loses its device,
+            // as <prefix>-<time>.json (or .bin). Empty (the default) records without dumping.
+            Format& FlightRecordPath ( const std::string& prefix ) { _flightRecordPath = prefix; return *this; }
+            Format& FlightRecordBinary ( bool binary ) { _flightRecordBinary = binary; return *this; }
+            Format& FlightRecordThumbnails ( size_t count ) { _flightRecordThumbnails = count; return *this; }
+            // Trades throughput and power for latency: asks the capture engine for low latency
+            // processing and flushes each hardware frame's copy to the GPU straight away. Pair
+            // with WaitForFrame ( ) or a frame callback, rather than polling CheckNewFrame ( ).
+            Format& LowLatency ( bool lowLatency ) { _lowLatency = lowLatency; return *this; }
+            // For interlaced sources (1080i off an SDI / HDMI card). Software frames are
+            // deinterlaced as they're copied out of the capture buffer, hardware frames by the
+            // capture engine's video processor, which picks its own method.
+            Format& Deinterlace ( const DeinterlaceOptions& options ) { _deinterlace = options; return *this; }
+            // Temporal noise reduction for low light, after deinterlacing. Software frames only.
+            Format& Denoise ( const DenoiseOptions& options ) { _denoise = options; return *this; }
+            // Lens undistortion or a perspective warp, applied as software frames are copied out
+            // of the capture buffer (after deinterlacing). Not applied to hardware frames.
+            Format& Remap ( const RemapOptions& options ) { _remap = options; return *this; }
+            // Takes out camera shake, applied as the last software stage. Not applied to hardware frames.
+            Format& Stabilize ( const StabilizeOptions& options ) { _stabilize = options; return *this; }
+            // Watches software frames for banding under mains lighting and sets the camera's
+            // anti-flicker control to match. See OnPowerLineDetected.
+            Format& FlickerDetection ( const FlickerOptions& options ) { _flicker = options; return *this; }
+            // While a lid or privacy shutter covers the camera, drop to a trickle of frames and
+            // skip the copy, stages and analytics, resuming as soon as it opens
+            Format& ThrottleWhenOccluded ( const OcclusionOptions& options ) { _occlusion = options; return *this; }
+            // Electronic pan / tilt / zoom, a crop of software frames resampled back to full size
+            // in the same pass as Remap or Stabilize when either's on. Driven by GetViewport ( ).
+            Format& ElectronicPTZ ( const ViewportOptions& options ) { _viewport = options; return *this; }
+
+            const Vec2i& Size ( ) const { return _size; }
+            const Vec2i& FPS ( ) const { return _fps; }
+            PixelFormat Subtype ( ) const { return _subtype; }
             const DeviceDescriptor& Device ( ) const { return _device; }
             bool  IsHardwareAccelerated ( ) const { return _hardwareAccelerated; }
             Rotation RotationAngle ( ) const { return _rotation; }
             bool AutoStart ( ) const { return _autoStart; }
+            const std::string& FlightRecordPath ( ) const { return _flightRecordPath; }
+            bool FlightRecordBinary ( ) const { return _flightRecordBinary; }
+            size_t FlightRecordThumbnails ( ) const { return _flightRecordThumbnails; }
+            bool IsLowLatency ( ) const { return _lowLatency; }
+            const DeinterlaceOptions& Deinterlace ( ) const { return _deinterlace; }
+            const DenoiseOptions& Denoise ( ) const { return _denoise; }
+            const RemapOptions& Remap ( ) const { return _remap; }
+            const StabilizeOptions& Stabilize ( ) const { return _stabilize; }
+            const FlickerOptions& FlickerDetection ( ) const { return _flicker; }
+            const OcclusionOptions& ThrottleWhenOccluded ( ) const { return _occlusion; }
+            const ViewportOptions& ElectronicPTZ ( ) const { return _viewport; }
 
         protected:
             
-            ci::ivec2               _size{ 640, 480 };
-            ci::ivec2               _fps{ 30, 1 };
+            Vec2i                   _size{ 640, 480 };
+            Vec2i                   _fps{ 30, 1 };
+            PixelFormat             _subtype{ PixelFormat::Unknown };
             DeviceDescriptor        _device;
+#ifdef AX_VIDEOCAPTURE_HEADLESS
+            bool                    _hardwareAccelerated{ false }; // No GL to share textures with
+#else
             bool                    _hardwareAccelerated{ true };
+#endif
             Rotation                _rotation{ Rotation::R0 };
             bool                    _autoStart{ true };
+            std::string             _flightRecordPath;
+            bool                    _flightRecordBinary{ false };
+            size_t                  _flightRecordThumbnails{ 0 };
+            bool                    _lowLatency{ false };
+            DeinterlaceOptions      _deinterlace;
+            DenoiseOptions          _denoise;
+            RemapOptions            _remap;
+            StabilizeOptions        _stabilize;
+            FlickerOptions          _flicker;
+            OcclusionOptions        _occlusion;
+            ViewportOptions         _viewport;
         };
 
         enum class OcclusionState
         {
             Open,
             OccludedByLid,
-            OccludedByHardware
+            OccludedByHardware,
+            LensCovered         // From the picture, by ThrottleWhenOccluded's luminance fallback
         };
 
-        using  FrameLeaseRef        = std::unique_ptr<FrameLease>;
-        using  EventSignal          = ci::signals::Signal<void ( )>;
-        using  ErrorSignal          = ci::signals::Signal<void ( int )>;
-        using  ControlChangedSignal = ci::signals::Signal<void ( Control& control )>;
-        using  OcclusionChangedSignal = ci::signals::Signal<void ( OcclusionState )>;
+        using  EventSignal          = CaptureSignal<void ( )>;
+        using  ErrorSignal          = CaptureSignal<void ( int )>;
+        using  ControlChangedSignal = CaptureSignal<void ( Control& control )>;
+        using  OcclusionChangedSignal = CaptureSignal<void ( OcclusionState )>;
+        using  DeviceSignal         = CaptureSignal<void ( DeviceDescriptor )>;
+        using  FormatChangedSignal  = CaptureSignal<void ( const Format& format )>;
+        using  PowerLineSignal      = CaptureSignal<void ( PowerLineFrequency frequency )>;
+        using  FrameCallback        = std::function<void ( const FrameRef& frame )>;
 
         static std::vector<DeviceDescriptor> GetDevices ( bool refresh = false );
-        static std::vector<DeviceProfile>    GetProfiles ( const DeviceDescriptor& descriptor );
-        static ci::signals::Signal<void ( DeviceDescriptor )>& OnDeviceAdded ( );
-        static ci::signals::Signal<void ( DeviceDescriptor )>& OnDeviceRemoved ( );
+        static std::vector<DeviceProfile>    GetProfiles ( const DeviceDescriptor& descriptor, bool refresh = false );
+        static void                          SetMeasurement ( const DeviceDescriptor& descriptor, const DeviceProfile& profile, const ProfileMeasurement& measurement );
+        static DeviceTopology                GetDeviceTopology ( const DeviceDescriptor& descriptor );
+        // Now, in seconds on the clock frames are timestamped with
+        static double                        GetTime ( );
+        static DeviceSignal&                 OnDeviceAdded ( );
+        static DeviceSignal&                 OnDeviceRemoved ( );
         
         static  CaptureRef              Create ( const Format & fmt = Format ( ) );
+
+        // Stops all callbacks and signals before returning, then stops and releases the device
+        // on the shared executor, so switching cameras doesn't stall the caller. Resets the
+        // reference passed in. Any other references are left holding an invalid capture.
+        // Dropping the last reference instead tears down synchronously.
+        static void                     DestroyAsync ( CaptureRef& capture );
+
+        // Visits every live capture while holding the registry lock, so keep fn short and
+        // don't create or destroy captures from inside it
+        static void                     ForEachCapture ( const std::function<void ( const Capture& capture )>& fn );
         
         const Format &                  GetFormat ( ) const { return _format; }
 
-        const   ci::ivec2&              GetSize ( ) const;
-        inline  ci::Area                GetBounds ( ) const { return ci::Area ( ci::ivec2(0), GetSize() ); }
+        const   Vec2i&                  GetSize ( ) const;
         inline  bool                    IsHardwareAccelerated ( ) const { return _format.IsHardwareAccelerated ( ); }
         bool                            IsValid ( ) const;
 
         bool                            CheckNewFrame ( ) const;
+        // Blocks until there's a frame CheckNewFrame ( ) would report, for up to timeout seconds.
+        // Woken by the capture thread as the frame is published.
+        bool                            WaitForFrame ( double timeout ) const;
+        Stats                           GetStats ( ) const;
+        void                            ResetStats ( );
         const DeviceDescriptor&         GetDevice ( ) const { return _format.Device ( ); }
 
-        const ci::Surface8uRef &        GetSurface ( ) const;
+        // The latest CPU frame (software mode only)
+        FrameRef                        GetFrame ( ) const;
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        inline  ci::Area                GetBounds ( ) const { return ci::Area ( ci::ivec2 ( 0 ), ci::ivec2 ( GetSize ( ) ) ); }
+        ci::Surface8uRef                GetSurface ( ) const;
         FrameLeaseRef                   GetTexture ( ) const;
+#endif
 
         void                            Start ( );
         void                            Stop ( );
@@ -189,6 +256,25 @@ namespace AX::Video
 
         const std::vector<ControlRef>&  GetControls ( ) const { return _controls; }
 
+        // Pan, tilt and zoom from any thread, when the format has ElectronicPTZ on
+        ViewportController&             GetViewport ( ) { return _viewport; }
+        const ViewportController&       GetViewport ( ) const { return _viewport; }
+
+        // Called on the capture thread as each CPU frame lands (so not in hardware accelerated
+        // mode), timestamped with its arrival in seconds. Holding on to the frame is fine, the
+        // capture writes the next one elsewhere. Keep the callback itself short.
+        uint64_t                        AddFrameCallback ( const FrameCallback& callback );
+        void                            RemoveFrameCallback ( uint64_t id );
+
+        // Always recording. DumpFlightRecord() snapshots it now and writes it to FlightRecordPath
+        // in the background, for hosts that detect stalls themselves.
+        const FlightRecorderRef&        GetFlightRecorder ( ) const { return _flightRecorder; }
+        void                            DumpFlightRecord ( const std::string& reason );
+
+        // Pass an empty provider to go back to internal storage. Frames already delivered keep
+        // the buffers they were written into.
+        void                            SetBufferProvider ( const BufferProvider& provider );
+
         EventSignal                     OnInitialize;
         EventSignal                     OnStart;
         EventSignal                     OnStop;
@@ -196,21 +282,37 @@ namespace AX::Video
         ErrorSignal                     OnError;
         ControlChangedSignal            OnControlChanged;
         OcclusionChangedSignal          OnOcclusionChanged;
+        // The source changed size, frame rate or subtype mid-stream (an HDMI card following its
+        // input, say). Frames, pool and textures have already been reallocated, and GetFormat ( )
+        // reflects the change. Frames are dropped while the textures are being replaced.
+        FormatChangedSignal             OnFormatChanged;
+        // Flicker detection found banding from the given mains frequency. The anti-flicker
+        // control (and exposure, if asked for) has already been set when AutoApply is on.
+        PowerLineSignal                 OnPowerLineDetected;
         
+        Capture ( const Capture& ) = delete;
+        Capture& operator = ( const Capture& ) = delete;
         ~Capture ( );
 
     protected:
 
         Capture ( const Format & format );
+
+        struct ImplDeleter { void operator() ( Impl* impl ) const; };
+
+        void                            DispatchFrame ( const FrameRef& frame );
+
+        using FrameCallbackList = std::vector<std::pair<uint64_t, FrameCallback>>;
         
         Format                          _format;
-        std::unique_ptr<Impl>           _impl;
+        ViewportController              _viewport;
+        std::unique_ptr<Impl, ImplDeleter> _impl;
         std::vector<ControlRef>         _controls;
+        FlightRecorderRef               _flightRecorder;
         bool                            _isValid{ false };
+
+        std::mutex                      _frameCallbackMutex;
+        std::shared_ptr<const FrameCallbackList> _frameCallbacks;
+        uint64_t                        _nextFrameCallbackID{ 1 };
     };
 }
-
-inline std::ostream& operator << ( std::ostream& stream, const AX::Video::Capture::DeviceDescriptor& descriptor )
-{
-    return stream << descriptor.Name << " (" << descriptor.ID << ")";
-}
\ No newline at end of file
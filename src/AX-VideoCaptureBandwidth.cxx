@@ -0,0 +1,338 @@
+//
+//  AX-VideoCaptureBandwidth.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureBandwidth.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace AX::Video
+{
+    namespace
+    {
+        // Charged per device left without a profile so that a plan which starts every camera
+        // always beats one with a higher total quality that leaves a camera off.
+        constexpr double kUnassignedPenalty = 1.0e6;
+
+        struct Candidate
+        {
+            size_t  Profile{ 0 };
+            double  Bandwidth{ 0.0 };
+            double  Quality{ 0.0 };
+        };
+
+        struct Slot
+        {
+            size_t                  Device{ 0 };
+            std::vector<Candidate>  Candidates; // Sorted by descending quality
+            std::vector<size_t>     Links;      // Into the group's links, every one the device's traffic crosses
+        };
+
+        struct Link
+        {
+            std::string             Name;
+            BusSpeed                Speed{ BusSpeed::Unknown };
+            bool                    IsUnconstrained{ false };
+            double                  Budget{ 0.0 };
+        };
+
+        // Devices whose traffic meets on some link, so have to be planned together
+        struct Group
+        {
+            std::vector<Slot>       Slots;
+            std::vector<Link>       Links;
+
+            size_t                  FindLink ( const std::string& name )
+            {
+                for ( size_t i = 0; i < Links.size ( ); i++ )
+                {
+                    if ( Links[i].Name == name ) return i;
+                }
+
+                Links.push_back ( { name } );
+                return Links.size ( ) - 1;
+            }
+        };
+
+        struct Search
+        {
+            const std::vector<Slot>&    Slots;
+            const std::vector<Link>&    Links;
+            size_t                      MaxIterations{ 0 };
+            std::vector<double>         BestRemaining;
+            std::vector<double>         Used;
+
+            std::vector<int>            Current;
+            std::vector<int>            Best;
+            double                      BestQuality{ -std::numeric_limits<double>::infinity ( ) };
+            size_t                      Iterations{ 0 };
+
+            Search ( const std::vector<Slot>& slots, const std::vector<Link>& links, size_t maxIterations )
+                : Slots ( slots )
+                , Links ( links )
+                , MaxIterations ( maxIterations )
+                , BestRemaining ( slots.size ( ) + 1, 0.0 )
+                , Used ( links.size ( ), 0.0 )
+                , Current ( slots.size ( ), -1 )
+                , Best ( slots.size ( ), -1 )
+            {
+                for ( size_t i = slots.size ( ); i-- > 0; )
+                {
+                    double best = slots[i].Candidates.empty ( ) ? -kUnassignedPenalty : slots[i].Candidates.front ( ).Quality;
+                    BestRemaining[i] = BestRemaining[i + 1] + best;
+                }
+            }
+
+            bool Fits ( const Slot& slot, double bandwidth ) const
+            {
+                for ( size_t link : slot.Links )
+                {
+                    if ( Used[link] + bandwidth > Links[link].Budget ) return false;
+                }
+
+                return true;
+            }
+
+            void Run ( size_t index, double quality )
+            {
+                if ( ++Iterations > MaxIterations ) return;
+                if ( quality + BestRemaining[index] <= BestQuality ) return;
+
+                if ( index == Slots.size ( ) )
+                {
+                    BestQuality = quality;
+                    Best = Current;
+                    return;
+                }
+
+                const auto& slot = Slots[index];
+                for ( size_t c = 0; c < slot.Candidates.size ( ); c++ )
+                {
+                    const auto& candidate = slot.Candidates[c];
+                    if ( !Fits ( slot, candidate.Bandwidth ) ) continue;
+
+                    Current[index] = (int)c;
+                    for ( size_t link : slot.Links ) Used[link] += candidate.Bandwidth;
+                    Run ( index + 1, quality + candidate.Quality );
+                    for ( size_t link : slot.Links ) Used[link] -= candidate.Bandwidth;
+                }
+
+                Current[index] = -1;
+                Run ( index + 1, quality - kUnassignedPenalty );
+            }
+        };
+    }
+
+    double BandwidthPlanner::Options::Budget ( BusSpeed speed ) const
+    {
+        auto it = _budgets.find ( speed );
+        if ( it != _budgets.end ( ) ) return it->second;
+
+        switch ( speed )
+        {
+            case BusSpeed::USB3: return 5.0e9 / 8.0;
+            case BusSpeed::USB2:
+            default:             return 480.0e6 / 8.0; // Assume the worst when we couldn't tell
+        }
+    }
+
+    const BandwidthPlanner::Assignment * BandwidthPlanner::Plan::Find ( const DeviceDescriptor& device ) const
+    {
+        for ( auto& assignment : Assignments )
+        {
+            if ( assignment.Descriptor == device ) return &assignment;
+        }
+
+        return nullptr;
+    }
+
+    double BandwidthPlanner::EstimateBandwidth ( const DeviceProfile& profile, const Options& options )
+    {
+        double bytesPerPixel = 2.0;
+        switch ( profile.Subtype )
+        {
+            case PixelFormat::RGB32: bytesPerPixel = 4.0; break;
+            case PixelFormat::RGB24: bytesPerPixel = 3.0; break;
+            case PixelFormat::YUY2:
+            case PixelFormat::UYVY:  bytesPerPixel = 2.0; break;
+            case PixelFormat::NV12:
+            case PixelFormat::I420:  bytesPerPixel = 1.5; break;
+            case PixelFormat::MJPEG: bytesPerPixel = 2.0 * options.MJPEGCompression ( ); break;
+            case PixelFormat::H264:  bytesPerPixel = 2.0 * options.MJPEGCompression ( ) * 0.2; break;
+            default: break;
+        }
+
+        double fps = profile.FPS.y != 0 ? (double)profile.FPS.x / (double)profile.FPS.y : 0.0;
+        return (double)profile.Size.x * (double)profile.Size.y * bytesPerPixel * fps;
+    }
+
+    double BandwidthPlanner::DefaultQuality ( const DeviceProfile& profile )
+    {
+        double pixels = std::max ( 1.0, (double)profile.Size.x * (double)profile.Size.y );
+        double fps = profile.FPS.y != 0 ? std::max ( 1.0, (double)profile.FPS.x / (double)profile.FPS.y ) : 1.0;
+        if ( profile.IsMeasured ( ) ) fps = std::max ( 1.0, std::min ( fps, (double)profile.Measured.FPS ) );
+
+        // Doubling resolution is worth the same as doubling frame rate, with a small
+        // nudge away from compressed formats that cost a decode and add artifacts
+        double quality = std::log2 ( pixels ) + std::log2 ( fps );
+        if ( profile.Subtype == PixelFormat::MJPEG || profile.Subtype == PixelFormat::H264 ) quality -= 0.1;
+        return quality;
+    }
+
+    BandwidthPlanner::BandwidthPlanner ( const Options& options )
+        : _options ( options )
+    {
+    }
+
+    BandwidthPlanner::Plan BandwidthPlanner::Solve ( const std::vector<PlannerDevice>& devices ) const
+    {
+        Plan plan;
+        plan.Assignments.resize ( devices.size ( ) );
+
+        QualityFn quality = _options.Quality ( ) ? _options.Quality ( ) : QualityFn ( DefaultQuality );
+
+        // Nothing says a device without a controller shares a link with anything else, so
+        // don't pile it onto a common one
+        auto getLinks = [&] ( size_t i )
+        {
+            const auto& topology = devices[i].Topology;
+            if ( topology.Controller.empty ( ) )
+            {
+                std::string own = "unknown:" + ( devices[i].Descriptor.ID.empty ( ) ? std::to_string ( i ) : devices[i].Descriptor.ID );
+                return std::make_pair ( own, own );
+            }
+
+            return std::make_pair ( topology.Controller, topology.Hub.empty ( ) ? topology.Controller : topology.Hub );
+        };
+
+        // The fastest device on each link says what it can carry
+        std::map<std::string, BusSpeed> speeds;
+        for ( size_t i = 0; i < devices.size ( ); i++ )
+        {
+            auto [controller, hub] = getLinks ( i );
+            for ( auto& link : { controller, hub } ) speeds[link] = std::max ( speeds[link], devices[i].Topology.Speed );
+        }
+
+        // Grouped by controller, everything below one shares its link
+        std::map<std::string, Group> groups;
+
+        for ( size_t i = 0; i < devices.size ( ); i++ )
+        {
+            const auto& device = devices[i];
+            auto [controller, hub] = getLinks ( i );
+
+            // With no speed either there's nothing to budget against at all
+            const bool isUnconstrained = device.Topology.Controller.empty ( ) && device.Topology.Speed == BusSpeed::Unknown;
+            const bool isByHub = _options.GroupBy ( ) == Grouping::Hub;
+            plan.Assignments[i].Descriptor = device.Descriptor;
+            plan.Assignments[i].Bus = isByHub ? hub : controller;
+
+            std::vector<Candidate> candidates;
+            for ( size_t p = 0; p < device.Profiles.size ( ); p++ )
+            {
+                const auto& profile = device.Profiles[p];
+                double fps = profile.FPS.y != 0 ? (double)profile.FPS.x / (double)profile.FPS.y : 0.0;
+                if ( fps < _options.MinimumFPS ( ) ) continue;
+
+                candidates.push_back ( { p, EstimateBandwidth ( profile, _options ), quality ( profile ) * device.Weight } );
+            }
+
+            // Drop dominated profiles (more bandwidth for no more quality), it keeps the search tiny
+            std::sort ( candidates.begin ( ), candidates.end ( ), [] ( const Candidate& a, const Candidate& b )
+            {
+                if ( a.Bandwidth == b.Bandwidth ) return a.Quality > b.Quality;
+                return a.Bandwidth < b.Bandwidth;
+            } );
+
+            std::vector<Candidate> frontier;
+            for ( auto& c : candidates )
+            {
+                if ( frontier.empty ( ) || c.Quality > frontier.back ( ).Quality ) frontier.push_back ( c );
+            }
+
+            std::reverse ( frontier.begin ( ), frontier.end ( ) );
+
+            // Hubs share the controller above them, so a device grouped by hub is held to both
+            auto& group = groups[controller];
+            Slot slot{ i, std::move ( frontier ) };
+
+            std::vector<std::string> links{ controller };
+            if ( isByHub && hub != controller ) links.push_back ( hub );
+            for ( auto& name : links )
+            {
+                auto link = group.FindLink ( name );
+                group.Links[link].Speed = speeds[name];
+                group.Links[link].IsUnconstrained = isUnconstrained;
+                slot.Links.push_back ( link );
+
+                // USB3 links carry USB2 traffic separately, at USB2 rates. Devices of unknown
+                // speed are assumed to be USB2.
+                if ( speeds[name] == BusSpeed::USB3 && device.Topology.Speed != BusSpeed::USB3 )
+                {
+                    link = group.FindLink ( name + ":usb2" );
+                    group.Links[link].Speed = BusSpeed::USB2;
+                    slot.Links.push_back ( link );
+                }
+            }
+
+            group.Slots.push_back ( std::move ( slot ) );
+        }
+
+        plan.IsComplete = true;
+
+        for ( auto& [controller, group] : groups )
+        {
+            for ( auto& link : group.Links )
+            {
+                link.Budget = link.IsUnconstrained ? std::numeric_limits<double>::infinity ( ) : _options.Budget ( link.Speed ) * _options.Headroom ( );
+                plan.Buses[link.Name].Budget = link.Budget;
+            }
+
+            auto& slots = group.Slots;
+
+            // Hungriest devices first so over-budget branches are cut as early as possible
+            std::sort ( slots.begin ( ), slots.end ( ), [] ( const Slot& a, const Slot& b )
+            {
+                double aB = a.Candidates.empty ( ) ? 0.0 : a.Candidates.front ( ).Bandwidth;
+                double bB = b.Candidates.empty ( ) ? 0.0 : b.Candidates.front ( ).Bandwidth;
+                return aB > bB;
+            } );
+
+            Search search{ slots, group.Links, _options.MaxIterations ( ) };
+            search.Run ( 0, 0.0 );
+
+            for ( size_t s = 0; s < slots.size ( ); s++ )
+            {
+                auto& assignment = plan.Assignments[slots[s].Device];
+                int choice = search.Best[s];
+                if ( choice < 0 )
+                {
+                    plan.IsComplete = false;
+                    continue;
+                }
+
+                const auto& candidate = slots[s].Candidates[choice];
+                assignment.Profile = devices[slots[s].Device].Profiles[candidate.Profile];
+                assignment.Bandwidth = candidate.Bandwidth;
+                assignment.IsAssigned = true;
+
+                for ( size_t link : slots[s].Links )
+                {
+                    auto& usage = plan.Buses[group.Links[link].Name];
+                    usage.Used += candidate.Bandwidth;
+                    usage.Devices++;
+                }
+
+                plan.Quality += candidate.Quality;
+            }
+        }
+
+        return plan;
+    }
+}
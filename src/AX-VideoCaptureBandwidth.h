@@ -0,0 +1,124 @@
+//
+//  AX-VideoCaptureBandwidth.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <functional>
+#include <map>
+
+namespace AX::Video
+{
+    // Picks a profile for each of a set of devices so that the devices sharing a USB
+    // controller (or hub) don't ask for more isochronous bandwidth than the link can carry.
+    // Everything operates on plain descriptions of the devices, so a topology can be faked
+    // by filling in PlannerDevice by hand rather than calling Discover(). Only Discover needs
+    // the device library, the rest is part of the core.
+    class BandwidthPlanner
+    {
+    public:
+
+        using DeviceDescriptor  = Video::DeviceDescriptor;
+        using DeviceProfile     = Video::DeviceProfile;
+        using DeviceTopology    = Video::DeviceTopology;
+        using PixelFormat       = Video::PixelFormat;
+        using BusSpeed          = Video::BusSpeed;
+        using QualityFn         = std::function<double ( const DeviceProfile& profile )>;
+
+        // Hub holds each hub to its own budget as well as the controller's above it
+        enum class Grouping
+        {
+            Controller,
+            Hub
+        };
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& GroupBy ( Grouping grouping ) { _grouping = grouping; return *this; }
+            Options& MJPEGCompression ( double ratio ) { _mjpegCompression = ratio; return *this; }
+            Options& Headroom ( double fraction ) { _headroom = fraction; return *this; }
+            Options& MinimumFPS ( double fps ) { _minimumFPS = fps; return *this; }
+            Options& Quality ( const QualityFn& quality ) { _quality = quality; return *this; }
+            Options& Budget ( BusSpeed speed, double bytesPerSecond ) { _budgets[speed] = bytesPerSecond; return *this; }
+            Options& MaxIterations ( size_t iterations ) { _maxIterations = iterations; return *this; }
+
+            Grouping        GroupBy ( ) const { return _grouping; }
+            double          MJPEGCompression ( ) const { return _mjpegCompression; }
+            double          Headroom ( ) const { return _headroom; }
+            double          MinimumFPS ( ) const { return _minimumFPS; }
+            const QualityFn& Quality ( ) const { return _quality; }
+            double          Budget ( BusSpeed speed ) const;
+            size_t          MaxIterations ( ) const { return _maxIterations; }
+
+        protected:
+
+            Grouping                    _grouping{ Grouping::Controller };
+            double                      _mjpegCompression{ 0.15 };  // Compressed bytes / YUY2 bytes
+            double                      _headroom{ 0.8 };           // Fraction of the raw link we're willing to schedule
+            double                      _minimumFPS{ 0.0 };
+            QualityFn                   _quality;
+            std::map<BusSpeed, double>  _budgets;
+            size_t                      _maxIterations{ 1000000 };
+        };
+
+        struct PlannerDevice
+        {
+            DeviceDescriptor            Descriptor;
+            DeviceTopology              Topology;
+            std::vector<DeviceProfile>  Profiles;
+            double                      Weight{ 1.0 };
+        };
+
+        struct Assignment
+        {
+            DeviceDescriptor            Descriptor;
+            DeviceProfile               Profile;
+            std::string                 Bus;        // Devices with no known topology get a bus of their own
+            double                      Bandwidth{ 0.0 };
+            bool                        IsAssigned{ false };
+        };
+
+        struct BusUsage
+        {
+            double                      Budget{ 0.0 };
+            double                      Used{ 0.0 };
+            size_t                      Devices{ 0 };
+        };
+
+        struct Plan
+        {
+            std::vector<Assignment>         Assignments;
+            std::map<std::string, BusUsage> Buses;              // Every link budgeted, controllers and (by hub) hubs. USB2
+                                                                // traffic on a USB3 link is also held to USB2's budget, as "<link>:usb2".
+            double                          Quality{ 0.0 };
+            bool                            IsComplete{ false };  // Every device got a profile
+
+            const Assignment *              Find ( const DeviceDescriptor& device ) const;
+        };
+
+        static double                       EstimateBandwidth ( const DeviceProfile& profile, const Options& options = Options ( ) );
+        static double                       DefaultQuality ( const DeviceProfile& profile );
+
+        // Snapshot the connected devices (or just the given ones), their profiles and where they
+        // sit on the bus
+        static std::vector<PlannerDevice>   Discover ( );
+        static std::vector<PlannerDevice>   Discover ( const std::vector<DeviceDescriptor>& devices );
+
+        BandwidthPlanner                    ( const Options& options = Options ( ) );
+
+        Plan                                Solve ( const std::vector<PlannerDevice>& devices ) const;
+        const Options&                      GetOptions ( ) const { return _options; }
+
+    protected:
+
+        Options                             _options;
+    };
+}
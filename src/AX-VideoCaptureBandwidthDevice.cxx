@@ -0,0 +1,36 @@
+//
+//  AX-VideoCaptureBandwidthDevice.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureBandwidth.h"
+#include "AX-VideoCapture.h"
+
+namespace AX::Video
+{
+    std::vector<BandwidthPlanner::PlannerDevice> BandwidthPlanner::Discover ( )
+    {
+        return Discover ( Capture::GetDevices ( ) );
+    }
+
+    std::vector<BandwidthPlanner::PlannerDevice> BandwidthPlanner::Discover ( const std::vector<DeviceDescriptor>& devices )
+    {
+        std::vector<PlannerDevice> result;
+        result.reserve ( devices.size ( ) );
+
+        for ( auto& device : devices )
+        {
+            PlannerDevice entry;
+            entry.Descriptor = device;
+            entry.Topology = Capture::GetDeviceTopology ( device );
+            entry.Profiles = Capture::GetProfiles ( device );
+            result.push_back ( std::move ( entry ) );
+        }
+
+        return result;
+    }
+}
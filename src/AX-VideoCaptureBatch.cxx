@@ -0,0 +1,285 @@
+//
+//  AX-VideoCaptureBatch.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+namespace AX::Video
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+    }
+
+    struct FrameBatcher::State
+    {
+        using BatchRef = std::shared_ptr<Batch>;
+
+        BatchFn                     OnBatch;
+        Options                     Settings;
+        size_t                      NumSources{ 0 };
+
+        std::mutex                  Mutex;
+        std::condition_variable     Changed;    // InFlight went down
+        std::condition_variable     Wake;       // The timer has a new deadline to wait for
+        BatchRef                    Open;
+        Clock::time_point           Deadline;
+        uint64_t                    NextSequence{ 0 };
+        size_t                      InFlight{ 0 };
+        bool                        IsAlive{ true };
+        std::thread                 Timer;
+
+        std::atomic<uint64_t>       Batches{ 0 };
+        std::atomic<uint64_t>       Frames{ 0 };
+        std::atomic<uint64_t>       Incomplete{ 0 };
+
+        // Capture thread
+        void Add ( const std::shared_ptr<State>& self, size_t source, const FrameRef& frame )
+        {
+            BatchRef closed[2];
+            {
+                std::lock_guard<std::mutex> lock ( Mutex );
+                if ( !IsAlive ) return;
+
+                // A second frame from the same source means this batch has waited long enough,
+                // and one that's outlived its window goes now rather than waiting on the timer
+                if ( Open )
+                {
+                    auto& frames = Open->Frames;
+                    if ( Clock::now ( ) >= Deadline || std::any_of ( frames.begin ( ), frames.end ( ), [=] ( const Entry& e ) { return e.Source == source; } ) )
+                    {
+                        closed[0] = Close ( );
+                    }
+                }
+
+                if ( !Open )
+                {
+                    Open = std::make_shared<Batch> ( );
+                    Open->Sequence = NextSequence++;
+                    Deadline = Clock::now ( ) + std::chrono::duration_cast<Clock::duration> ( std::chrono::duration<double> ( Settings.Window ( ) ) );
+
+                    if ( !Timer.joinable ( ) ) Timer = std::thread ( [this, self] { RunTimer ( self ); } );
+                    Wake.notify_all ( );
+                }
+
+                Open->Frames.push_back ( { source, frame } );
+                if ( Open->Frames.size ( ) == NumSources )
+                {
+                    Open->IsComplete = true;
+                    closed[1] = Close ( );
+                }
+            }
+
+            for ( auto& batch : closed )
+            {
+                if ( batch ) Dispatch ( self, batch );
+            }
+        }
+
+        // Call with the lock held. Only a closed batch is handed to the executor, so nothing
+        // there sits waiting out the window.
+        BatchRef Close ( )
+        {
+            if ( Open ) InFlight++;
+            return std::move ( Open );
+        }
+
+        void Dispatch ( const std::shared_ptr<State>& self, const BatchRef& batch )
+        {
+            Executor::Get ( )->Submit ( [self, batch] { self->Run ( *batch ); }, Settings.Priority ( ) );
+        }
+
+        // Flushes a batch whose window runs out before anything else closes it. Sleeps on a
+        // thread of its own, never on one of the executor's.
+        void RunTimer ( const std::shared_ptr<State>& self )
+        {
+            std::unique_lock<std::mutex> lock ( Mutex );
+            while ( IsAlive )
+            {
+                if ( !Open )
+                {
+                    Wake.wait ( lock );
+                    continue;
+                }
+
+                if ( Clock::now ( ) < Deadline )
+                {
+                    Wake.wait_until ( lock, Deadline );
+                    continue;
+                }
+
+                auto batch = Close ( );
+                lock.unlock ( );
+                Dispatch ( self, batch );
+                lock.lock ( );
+            }
+        }
+
+        // Executor
+        void Run ( Batch& batch )
+        {
+            std::sort ( batch.Frames.begin ( ), batch.Frames.end ( ), [] ( const Entry& a, const Entry& b ) { return a.Source < b.Source; } );
+
+            Batches++;
+            Frames += batch.Frames.size ( );
+            if ( !batch.IsComplete ) Incomplete++;
+
+            bool alive = false;
+            {
+                std::lock_guard<std::mutex> lock ( Mutex );
+                alive = IsAlive;
+            }
+
+            if ( alive && OnBatch ) OnBatch ( batch );
+
+            std::lock_guard<std::mutex> lock ( Mutex );
+            InFlight--;
+            Changed.notify_all ( );
+        }
+    };
+
+    FrameBatcherRef FrameBatcher::Create ( const std::vector<CaptureRef>& captures, const BatchFn& onBatch, const Options& options )
+    {
+        return FrameBatcherRef ( new FrameBatcher ( captures, onBatch, options ) );
+    }
+
+    FrameBatcher::FrameBatcher ( const std::vector<CaptureRef>& captures, const BatchFn& onBatch, const Options& options )
+        : _state ( std::make_shared<State> ( ) )
+    {
+        _state->OnBatch = onBatch;
+        _state->Settings = options;
+        _state->NumSources = captures.size ( );
+
+        for ( size_t i = 0; i < captures.size ( ); i++ )
+        {
+            auto& capture = captures[i];
+            _captures.push_back ( capture );
+            _callbacks.push_back ( capture ? capture->AddFrameCallback ( [state = _state, i] ( const FrameRef& frame )
+            {
+                state->Add ( state, i, frame );
+            } ) : 0 );
+        }
+    }
+
+    FrameBatcher::~FrameBatcher ( )
+    {
+        for ( size_t i = 0; i < _captures.size ( ); i++ )
+        {
+            if ( auto capture = _captures[i].lock ( ) ) capture->RemoveFrameCallback ( _callbacks[i] );
+        }
+
+        // A batch still gathering is dropped, there's no one left to hand it to
+        std::thread timer;
+        {
+            std::lock_guard<std::mutex> lock ( _state->Mutex );
+            _state->IsAlive = false;
+            _state->Open = nullptr;
+            timer = std::move ( _state->Timer );
+            _state->Wake.notify_all ( );
+        }
+
+        if ( timer.joinable ( ) ) timer.join ( );
+
+        // Don't return while a batch is still being handed to the callback. Which does mean
+        // the batcher mustn't be destroyed from inside its own callback.
+        std::unique_lock<std::mutex> lock ( _state->Mutex );
+        _state->Changed.wait ( lock, [&] { return _state->InFlight == 0; } );
+    }
+
+    FrameBatcher::Stats FrameBatcher::GetStats ( ) const
+    {
+        Stats stats;
+        stats.Batches = _state->Batches.load ( );
+        stats.Frames = _state->Frames.load ( );
+        stats.Incomplete = _state->Incomplete.load ( );
+        stats.MeanBatchSize = stats.Batches > 0 ? (double)stats.Frames / (double)stats.Batches : 0.0;
+        return stats;
+    }
+
+    BatchTensor::BatchTensor ( const Options& options )
+        : _options ( options )
+    {
+        // value / 255, minus mean, over std, for each of R, G and B
+        for ( int c = 0; c < 3; c++ )
+        {
+            for ( int v = 0; v < 256; v++ )
+            {
+                _lut[c][v] = ( (float)v / 255.0f - _options.Mean ( )[c] ) / _options.Std ( )[c];
+            }
+        }
+    }
+
+    void BatchTensor::UpdateTables ( const Vec2i& sourceSize )
+    {
+        if ( sourceSize == _tableSource ) return;
+        _tableSource = sourceSize;
+
+        const auto& size = _options.Size ( );
+        _columns.resize ( size.x );
+        _rows.resize ( size.y );
+
+        for ( int x = 0; x < size.x; x++ ) _columns[x] = std::min ( sourceSize.x - 1, (int32_t)( ( x + 0.5f ) * sourceSize.x / size.x ) ) * 4;
+        for ( int y = 0; y < size.y; y++ ) _rows[y] = std::min ( sourceSize.y - 1, (int32_t)( ( y + 0.5f ) * sourceSize.y / size.y ) );
+    }
+
+    void BatchTensor::Fill ( const FrameBatcher::Batch& batch, size_t numSources )
+    {
+        const auto& size = _options.Size ( );
+        const size_t channel = (size_t)size.x * (size_t)size.y;
+        const size_t perFrame = channel * 3;
+
+        _count = numSources;
+        _data.resize ( perFrame * numSources );
+        std::memset ( _data.data ( ), 0, _data.size ( ) * sizeof ( float ) );
+
+        for ( auto& entry : batch.Frames )
+        {
+            auto& frame = entry.Image;
+            if ( !frame || frame->GetFormat ( ) != PixelFormat::RGB32 || entry.Source >= numSources ) continue;
+
+            const auto& source = frame->GetPlane ( 0 );
+            UpdateTables ( source.Size );
+
+            // Frames from the capture are BGRA, tensors want RGB
+            float* out = _data.data ( ) + perFrame * entry.Source;
+            for ( int y = 0; y < size.y; y++ )
+            {
+                const uint8_t* row = source.Data + source.RowBytes * _rows[y];
+
+                if ( _options.Format ( ) == Layout::NCHW )
+                {
+                    float* r = out + y * size.x;
+                    float* g = r + channel;
+                    float* b = g + channel;
+                    for ( int x = 0; x < size.x; x++ )
+                    {
+                        const uint8_t* px = row + _columns[x];
+                        r[x] = _lut[0][px[2]];
+                        g[x] = _lut[1][px[1]];
+                        b[x] = _lut[2][px[0]];
+                    }
+                } else
+                {
+                    float* dst = out + (size_t)y * size.x * 3;
+                    for ( int x = 0; x < size.x; x++ )
+                    {
+                        const uint8_t* px = row + _columns[x];
+                        dst[x * 3 + 0] = _lut[0][px[2]];
+                        dst[x * 3 + 1] = _lut[1][px[1]];
+                        dst[x * 3 + 2] = _lut[2][px[0]];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//
+//  AX-VideoCaptureBatch.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCapture.h"
+#include "AX-VideoCaptureExecutor.h"
+
+namespace AX::Video
+{
+    using FrameBatcherRef = std::shared_ptr<class FrameBatcher>;
+
+    // Gathers the frames that several captures deliver within a short window of each other
+    // into one job, so N cameras cost one dispatch (and one wake-up) instead of N, and the
+    // job can run the same kernel over every frame while its tables are hot in cache.
+    // Works on CPU frames, so the captures need to be in software mode.
+    class FrameBatcher
+    {
+    public:
+
+        struct Entry
+        {
+            size_t              Source{ 0 };    // Index into the captures the batcher was made with
+            FrameRef            Image;
+        };
+
+        struct Batch
+        {
+            uint64_t            Sequence{ 0 };
+            std::vector<Entry>  Frames;         // At most one per source, ordered by source
+            bool                IsComplete{ false }; // Every source contributed
+        };
+
+        struct Stats
+        {
+            uint64_t            Batches{ 0 };
+            uint64_t            Frames{ 0 };
+            uint64_t            Incomplete{ 0 };    // Flushed by the window expiring
+            double              MeanBatchSize{ 0.0 };
+        };
+
+        using BatchFn = std::function<void ( const Batch& batch )>;
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& Window ( double seconds ) { _window = seconds; return *this; }
+            Options& Priority ( Executor::Priority priority ) { _priority = priority; return *this; }
+
+            double              Window ( ) const { return _window; }
+            Executor::Priority  Priority ( ) const { return _priority; }
+
+        protected:
+
+            double              _window{ 0.002 };
+            Executor::Priority  _priority{ Executor::Priority::Frame };
+        };
+
+        // onBatch runs on the shared executor
+        static FrameBatcherRef  Create ( const std::vector<CaptureRef>& captures, const BatchFn& onBatch, const Options& options = Options ( ) );
+
+        ~FrameBatcher           ( );
+
+        Stats                   GetStats ( ) const;
+
+    protected:
+
+        struct State;
+
+        FrameBatcher            ( const std::vector<CaptureRef>& captures, const BatchFn& onBatch, const Options& options );
+
+        std::shared_ptr<State>  _state;
+        std::vector<std::weak_ptr<Capture>> _captures;
+        std::vector<uint64_t>   _callbacks;
+    };
+
+    // Packs a batch into one float tensor ready for an inference runtime. The normalisation
+    // LUT and resampling tables are built once and shared by every frame in every batch.
+    class BatchTensor
+    {
+    public:
+
+        enum class Layout
+        {
+            NCHW,
+            NHWC
+        };
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& Size ( const Vec2i& size ) { _size = size; return *this; }
+            Options& Format ( Layout layout ) { _layout = layout; return *this; }
+            Options& Mean ( float r, float g, float b ) { _mean[0] = r; _mean[1] = g; _mean[2] = b; return *this; }
+            Options& Std ( float r, float g, float b ) { _std[0] = r; _std[1] = g; _std[2] = b; return *this; }
+
+            const Vec2i&    Size ( ) const { return _size; }
+            Layout              Format ( ) const { return _layout; }
+            const float*        Mean ( ) const { return _mean; }
+            const float*        Std ( ) const { return _std; }
+
+        protected:
+
+            Vec2i           _size{ 224, 224 };
+            Layout              _layout{ Layout::NCHW };
+            float               _mean[3]{ 0.0f, 0.0f, 0.0f }; // In 0..1 units, RGB order
+            float               _std[3]{ 1.0f, 1.0f, 1.0f };
+        };
+
+        BatchTensor             ( const Options& options = Options ( ) );
+
+        // Resizes (nearest) and normalises every RGB32 frame, slots for missing sources stay zeroed
+        void                    Fill ( const FrameBatcher::Batch& batch, size_t numSources );
+
+        const float*            Data ( ) const { return _data.data ( ); }
+        size_t                  Count ( ) const { return _count; }
+        const Options&          GetOptions ( ) const { return _options; }
+
+    protected:
+
+        void                    UpdateTables ( const Vec2i& sourceSize );
+
+        Options                 _options;
+        std::vector<float>      _data;
+        size_t                  _count{ 0 };
+        float                   _lut[3][256];
+        Vec2i               _tableSource{ 0, 0 };
+        std::vector<int32_t>    _columns;   // Source byte offset for each output column
+        std::vector<int32_t>    _rows;      // Source row for each output row
+    };
+}
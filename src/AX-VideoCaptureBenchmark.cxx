@@ -0,0 +1,275 @@
+//
+//  AX-VideoCaptureBenchmark.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureBenchmark.h"
+#include "AX-VideoCaptureStats.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <thread>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        inline double Seconds ( Clock::time_point t )
+        {
+            return std::chrono::duration<double> ( t.time_since_epoch ( ) ).count ( );
+        }
+
+        inline double ToFPS ( const Vec2i& fps )
+        {
+            return fps.y != 0 ? (double)fps.x / (double)fps.y : 0.0;
+        }
+
+        double ProcessCPUSeconds ( )
+        {
+#ifdef WIN32
+            FILETIME created, exited, kernel, user;
+            if ( GetProcessTimes ( GetCurrentProcess ( ), &created, &exited, &kernel, &user ) )
+            {
+                auto toSeconds = [] ( const FILETIME& t ) { return ( ( (uint64_t)t.dwHighDateTime << 32 ) | t.dwLowDateTime ) * 1.0e-7; };
+                return toSeconds ( kernel ) + toSeconds ( user );
+            }
+            return 0.0;
+#else
+            rusage usage{};
+            getrusage ( RUSAGE_SELF, &usage );
+            return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) * 1.0e-6;
+#endif
+        }
+
+        class SyntheticSource : public ProfileBenchmark::Source
+        {
+        public:
+
+            SyntheticSource ( const std::string& name, const std::vector<ProfileBenchmark::SyntheticMode>& modes )
+                : _name ( name )
+                , _modes ( modes )
+            {
+            }
+
+            ~SyntheticSource ( )
+            {
+                Close ( );
+            }
+
+            std::string Name ( ) const override { return _name; }
+
+            std::vector<DeviceProfile> GetProfiles ( ) override
+            {
+                std::vector<DeviceProfile> profiles;
+                for ( auto& mode : _modes ) profiles.push_back ( mode.Profile );
+                return profiles;
+            }
+
+            bool Open ( const DeviceProfile& profile, double timeoutSeconds ) override
+            {
+                Close ( );
+
+                auto mode = std::find_if ( _modes.begin ( ), _modes.end ( ), [&] ( const auto& m ) { return m.Profile == profile; } );
+                if ( mode == _modes.end ( ) || mode->FailsToStart ) return false;
+
+                _stats.SetExpectedFPS ( ToFPS ( profile.FPS ) );
+                _stats.Reset ( );
+                _running = true;
+                _thread = std::thread ( &SyntheticSource::Produce, this, *mode );
+
+                // Same rule as a real device, it's open once frames are flowing
+                auto deadline = Clock::now ( ) + std::chrono::duration<double> ( timeoutSeconds );
+                while ( Clock::now ( ) < deadline )
+                {
+                    if ( _stats.Snapshot ( ).FramesDelivered > 0 ) return true;
+                    std::this_thread::sleep_for ( std::chrono::milliseconds ( 10 ) );
+                }
+
+                Close ( );
+                return false;
+            }
+
+            CaptureStats GetStats ( ) const override { return _stats.Snapshot ( ); }
+            void ResetStats ( ) override { _stats.Reset ( ); }
+
+            void Close ( ) override
+            {
+                _running = false;
+                if ( _thread.joinable ( ) ) _thread.join ( );
+            }
+
+        protected:
+
+            void Produce ( ProfileBenchmark::SyntheticMode mode )
+            {
+                std::mt19937 rng{ std::random_device{ }( ) };
+                std::normal_distribution<double> jitter ( 0.0, mode.JitterMs * 1.0e-3 );
+                std::uniform_real_distribution<double> chance ( 0.0, 1.0 );
+
+                double fps = mode.SustainedFPS > 0.0 ? mode.SustainedFPS : ToFPS ( mode.Profile.FPS );
+                double interval = 1.0 / std::max ( 1.0, fps );
+                size_t bytes = (size_t)mode.Profile.Size.x * (size_t)mode.Profile.Size.y * 4;
+
+                double deviceTime = 0.0;
+                auto next = Clock::now ( );
+
+                while ( _running )
+                {
+                    deviceTime += interval;
+                    next += std::chrono::duration_cast<Clock::duration> ( std::chrono::duration<double> ( interval ) );
+
+                    double offset = std::max ( 0.0, jitter ( rng ) );
+                    std::this_thread::sleep_until ( next + std::chrono::duration_cast<Clock::duration> ( std::chrono::duration<double> ( offset ) ) );
+
+                    if ( chance ( rng ) < mode.DropRate ) continue;
+
+                    double latency = std::max ( 0.0, mode.LatencyMs * 1.0e-3 + jitter ( rng ) );
+                    _stats.RecordFrame ( Seconds ( Clock::now ( ) ), deviceTime + offset, latency, bytes );
+                }
+            }
+
+            std::string                                 _name;
+            std::vector<ProfileBenchmark::SyntheticMode> _modes;
+            FrameStatistics                             _stats;
+            std::atomic_bool                            _running{ false };
+            std::thread                                 _thread;
+        };
+    }
+
+    ProfileMeasurement ProfileBenchmark::Result::ToMeasurement ( ) const
+    {
+        ProfileMeasurement measurement;
+        measurement.FPS = (float)DeliveredFPS;
+        measurement.JitterMs = (float)JitterMs;
+        measurement.LatencyMs = (float)LatencyMs;
+        measurement.DropRate = Frames + Drops > 0 ? (float)Drops / (float)( Frames + Drops ) : 0.0f;
+        return measurement;
+    }
+
+    ProfileBenchmark::SourceRef ProfileBenchmark::CreateSyntheticSource ( const std::string& name, const std::vector<SyntheticMode>& modes )
+    {
+        return std::make_unique<SyntheticSource> ( name, modes );
+    }
+
+    ProfileBenchmark::ProfileBenchmark ( const Options& options )
+        : _options ( options )
+    {
+    }
+
+    std::vector<ProfileBenchmark::Result> ProfileBenchmark::Run ( Source& source, const ResultFn& onResult ) const
+    {
+        std::vector<Result> results;
+        const auto& subtypes = _options.Subtypes ( );
+
+        for ( auto& profile : source.GetProfiles ( ) )
+        {
+            if ( !subtypes.empty ( ) && std::find ( subtypes.begin ( ), subtypes.end ( ), profile.Subtype ) == subtypes.end ( ) ) continue;
+
+            Result result;
+            result.Profile = profile;
+            result.AdvertisedFPS = ToFPS ( profile.FPS );
+
+            if ( source.Open ( profile, _options.StartTimeout ( ) ) )
+            {
+                result.Started = true;
+                std::this_thread::sleep_for ( std::chrono::duration<double> ( _options.Warmup ( ) ) );
+
+                source.ResetStats ( );
+                double cpu = ProcessCPUSeconds ( );
+                auto start = Clock::now ( );
+
+                std::this_thread::sleep_for ( std::chrono::duration<double> ( _options.Duration ( ) ) );
+
+                auto stats = source.GetStats ( );
+                result.Seconds = std::chrono::duration<double> ( Clock::now ( ) - start ).count ( );
+                result.CPUPercent = result.Seconds > 0.0 ? ( ProcessCPUSeconds ( ) - cpu ) / result.Seconds * 100.0 : 0.0;
+                source.Close ( );
+
+                result.Frames = stats.FramesDelivered;
+                result.Drops = stats.FramesDropped;
+                result.DeliveredFPS = result.Seconds > 0.0 ? stats.FramesDelivered / result.Seconds : 0.0;
+                result.JitterMs = stats.JitterMs;
+                result.LatencyMs = stats.LatencyMs;
+                result.LatencyP95Ms = stats.LatencyP95Ms;
+            }
+
+            if ( onResult ) onResult ( result );
+            results.push_back ( result );
+        }
+
+        return results;
+    }
+
+    bool ProfileBenchmark::WriteCSV ( const std::string& path, const std::vector<Result>& results )
+    {
+        std::ofstream out ( path );
+        if ( !out ) return false;
+
+        out << "profile,width,height,subtype,started,advertised_fps,delivered_fps,jitter_ms,latency_ms,latency_p95_ms,cpu_percent,frames,drops\n";
+        for ( auto& r : results )
+        {
+            out << r.Profile.Key ( ) << ','
+                << r.Profile.Size.x << ',' << r.Profile.Size.y << ','
+                << ToString ( r.Profile.Subtype ) << ','
+                << ( r.Started ? 1 : 0 ) << ','
+                << r.AdvertisedFPS << ',' << r.DeliveredFPS << ','
+                << r.JitterMs << ',' << r.LatencyMs << ',' << r.LatencyP95Ms << ','
+                << r.CPUPercent << ',' << r.Frames << ',' << r.Drops << '\n';
+        }
+
+        return (bool)out;
+    }
+
+    bool ProfileBenchmark::WriteJSON ( const std::string& path, const std::string& device, const std::vector<Result>& results )
+    {
+        std::ofstream out ( path );
+        if ( !out ) return false;
+
+        auto escape = [] ( const std::string& s )
+        {
+            std::string r;
+            for ( char c : s )
+            {
+                if ( c == '"' || c == '\\' ) r += '\\';
+                r += c;
+            }
+            return r;
+        };
+
+        out << "{\n  \"device\": \"" << escape ( device ) << "\",\n  \"results\": [\n";
+        for ( size_t i = 0; i < results.size ( ); i++ )
+        {
+            auto& r = results[i];
+            out << "    { \"profile\": \"" << escape ( r.Profile.Key ( ) ) << "\""
+                << ", \"width\": " << r.Profile.Size.x
+                << ", \"height\": " << r.Profile.Size.y
+                << ", \"subtype\": \"" << ToString ( r.Profile.Subtype ) << "\""
+                << ", \"started\": " << ( r.Started ? "true" : "false" )
+                << ", \"advertised_fps\": " << r.AdvertisedFPS
+                << ", \"delivered_fps\": " << r.DeliveredFPS
+                << ", \"jitter_ms\": " << r.JitterMs
+                << ", \"latency_ms\": " << r.LatencyMs
+                << ", \"latency_p95_ms\": " << r.LatencyP95Ms
+                << ", \"cpu_percent\": " << r.CPUPercent
+                << ", \"frames\": " << r.Frames
+                << ", \"drops\": " << r.Drops
+                << " }" << ( i + 1 < results.size ( ) ? "," : "" ) << "\n";
+        }
+        out << "  ]\n}\n";
+
+        return (bool)out;
+    }
+}
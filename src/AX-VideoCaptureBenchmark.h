@@ -0,0 +1,118 @@
+//
+//  AX-VideoCaptureBenchmark.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <functional>
+
+namespace AX::Video
+{
+    // Streams each of a device's profiles in turn and records what it really delivers,
+    // since plenty of cameras advertise modes they can't sustain (60fps that drops to 30
+    // in low light etc). Results can be written out and published back to GetProfiles().
+    // The benchmark and its synthetic source are part of the core, the device source and
+    // Publish need the device library.
+    class ProfileBenchmark
+    {
+    public:
+
+        using DeviceDescriptor  = Video::DeviceDescriptor;
+        using DeviceProfile     = Video::DeviceProfile;
+        using PixelFormat       = Video::PixelFormat;
+
+        // Something that can be opened at a given profile and report its CaptureStats,
+        // either a real device or a synthetic one for exercising the tool without hardware
+        class Source
+        {
+        public:
+
+            virtual ~Source ( ) { };
+
+            virtual std::string                 Name ( ) const = 0;
+            virtual std::vector<DeviceProfile>  GetProfiles ( ) = 0;
+            virtual bool                        Open ( const DeviceProfile& profile, double timeoutSeconds ) = 0;
+            virtual CaptureStats                GetStats ( ) const = 0;
+            virtual void                        ResetStats ( ) = 0;
+            virtual void                        Close ( ) = 0;
+        };
+
+        using SourceRef = std::unique_ptr<Source>;
+
+        // Describes how a synthetic profile really behaves
+        struct SyntheticMode
+        {
+            DeviceProfile   Profile;
+            double          SustainedFPS{ 0.0 };    // <= 0 means it delivers what it advertises
+            double          JitterMs{ 0.5 };
+            double          LatencyMs{ 30.0 };
+            double          DropRate{ 0.0 };        // Probability of losing any given frame
+            bool            FailsToStart{ false };
+        };
+
+        static SourceRef    CreateDeviceSource ( const DeviceDescriptor& device, bool hardwareAccelerated = false );
+        static SourceRef    CreateSyntheticSource ( const std::string& name, const std::vector<SyntheticMode>& modes );
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& Duration ( double seconds ) { _duration = seconds; return *this; }
+            Options& Warmup ( double seconds ) { _warmup = seconds; return *this; }
+            Options& StartTimeout ( double seconds ) { _startTimeout = seconds; return *this; }
+            Options& Subtypes ( const std::vector<PixelFormat>& subtypes ) { _subtypes = subtypes; return *this; }
+
+            double   Duration ( ) const { return _duration; }
+            double   Warmup ( ) const { return _warmup; }
+            double   StartTimeout ( ) const { return _startTimeout; }
+            const std::vector<PixelFormat>& Subtypes ( ) const { return _subtypes; }  // Empty means all
+
+        protected:
+
+            double                      _duration{ 5.0 };
+            double                      _warmup{ 1.0 };
+            double                      _startTimeout{ 5.0 };
+            std::vector<PixelFormat>    _subtypes;
+        };
+
+        struct Result
+        {
+            DeviceProfile   Profile;
+            bool            Started{ false };
+            double          Seconds{ 0.0 };
+            double          AdvertisedFPS{ 0.0 };
+            double          DeliveredFPS{ 0.0 };
+            double          JitterMs{ 0.0 };
+            double          LatencyMs{ 0.0 };
+            double          LatencyP95Ms{ 0.0 };
+            double          CPUPercent{ 0.0 };      // Of one core, for the whole process
+            uint64_t        Frames{ 0 };
+            uint64_t        Drops{ 0 };
+
+            ProfileMeasurement ToMeasurement ( ) const;
+        };
+
+        using ResultFn = std::function<void ( const Result& result )>;
+
+        ProfileBenchmark                ( const Options& options = Options ( ) );
+
+        // Blocks for roughly (warmup + duration) per profile
+        std::vector<Result>             Run ( Source& source, const ResultFn& onResult = nullptr ) const;
+
+        static bool                     WriteCSV ( const std::string& path, const std::vector<Result>& results );
+        static bool                     WriteJSON ( const std::string& path, const std::string& device, const std::vector<Result>& results );
+
+        // Stores the results as measured capabilities on the device's cached profiles
+        static void                     Publish ( const DeviceDescriptor& device, const std::vector<Result>& results );
+
+    protected:
+
+        Options                         _options;
+    };
+}
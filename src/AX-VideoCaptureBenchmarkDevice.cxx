@@ -0,0 +1,78 @@
+//
+//  AX-VideoCaptureBenchmarkDevice.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureBenchmark.h"
+#include "AX-VideoCapture.h"
+#include <chrono>
+#include <thread>
+
+namespace AX::Video
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        class DeviceSource : public ProfileBenchmark::Source
+        {
+        public:
+
+            DeviceSource ( const Capture::DeviceDescriptor& device, bool hardwareAccelerated )
+                : _device ( device )
+                , _hardwareAccelerated ( hardwareAccelerated )
+            {
+            }
+
+            std::string Name ( ) const override { return _device.Name; }
+            std::vector<Capture::DeviceProfile> GetProfiles ( ) override { return Capture::GetProfiles ( _device ); }
+
+            bool Open ( const Capture::DeviceProfile& profile, double timeoutSeconds ) override
+            {
+                Capture::Format format;
+                format.Device ( _device ).Profile ( profile ).HardwareAccelerated ( _hardwareAccelerated ).AutoStart ( true );
+
+                _capture = Capture::Create ( format );
+                if ( !_capture ) return false;
+
+                // Consider it open once frames are actually flowing
+                auto deadline = Clock::now ( ) + std::chrono::duration<double> ( timeoutSeconds );
+                while ( Clock::now ( ) < deadline )
+                {
+                    if ( _capture->GetStats ( ).FramesDelivered > 0 ) return true;
+                    std::this_thread::sleep_for ( std::chrono::milliseconds ( 10 ) );
+                }
+
+                Close ( );
+                return false;
+            }
+
+            Capture::Stats GetStats ( ) const override { return _capture ? _capture->GetStats ( ) : Capture::Stats{ }; }
+            void ResetStats ( ) override { if ( _capture ) _capture->ResetStats ( ); }
+            void Close ( ) override { _capture = nullptr; }
+
+        protected:
+
+            Capture::DeviceDescriptor   _device;
+            bool                        _hardwareAccelerated{ false };
+            CaptureRef                  _capture;
+        };
+    }
+
+    ProfileBenchmark::SourceRef ProfileBenchmark::CreateDeviceSource ( const DeviceDescriptor& device, bool hardwareAccelerated )
+    {
+        return std::make_unique<DeviceSource> ( device, hardwareAccelerated );
+    }
+
+    void ProfileBenchmark::Publish ( const DeviceDescriptor& device, const std::vector<Result>& results )
+    {
+        for ( auto& r : results )
+        {
+            if ( r.Started ) Capture::SetMeasurement ( device, r.Profile, r.ToMeasurement ( ) );
+        }
+    }
+}
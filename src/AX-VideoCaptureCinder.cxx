@@ -0,0 +1,30 @@
+//
+//  AX-VideoCaptureCinder.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+
+#include "AX-VideoCaptureCinder.h"
+
+using namespace ci;
+
+namespace AX::Video
+{
+    Surface8uRef ToSurface ( const FrameRef& frame )
+    {
+        if ( !frame || frame->GetFormat ( ) != PixelFormat::RGB32 || frame->GetNumPlanes ( ) == 0 ) return nullptr;
+
+        auto& plane = frame->GetPlane ( 0 );
+        return Surface8uRef ( new Surface8u ( plane.Data, plane.Size.x, plane.Size.y, plane.RowBytes, SurfaceChannelOrder::BGRA ), [frame] ( Surface8u* surface )
+        {
+            delete surface;
+        } );
+    }
+}
+
+#endif
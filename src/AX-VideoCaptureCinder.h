@@ -0,0 +1,41 @@
+//
+//  AX-VideoCaptureCinder.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+// The thin layer between the core frame types and Cinder. Not compiled into headless
+// (AX_VIDEOCAPTURE_HEADLESS) builds.
+
+#include "AX-VideoCaptureCore.h"
+#include "cinder/Cinder.h"
+#include "cinder/Surface.h"
+#include "cinder/gl/Texture.h"
+
+namespace AX::Video
+{
+    // A GPU frame that stays valid (and untouched by the capture) for the lease's lifetime
+    class FrameLease
+    {
+    public:
+        virtual ~FrameLease ( ) { };
+
+        operator bool ( ) const { return IsValid ( ); }
+        operator ci::gl::TextureRef ( ) const { return ToTexture ( ); }
+        virtual ci::gl::TextureRef ToTexture ( ) const { return nullptr; }
+
+    protected:
+        virtual bool IsValid ( ) const { return false; };
+    };
+
+    using FrameLeaseRef = std::unique_ptr<FrameLease>;
+
+    // A Surface over the frame's first plane, without copying. The surface keeps the frame
+    // (and so its pixels) alive. Only RGB32 frames map onto a Surface8u.
+    ci::Surface8uRef    ToSurface ( const FrameRef& frame );
+}
@@ -0,0 +1,29 @@
+//
+//  AX-VideoCaptureCore.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureCore.h"
+
+namespace AX::Video
+{
+    const char * ToString ( PixelFormat format )
+    {
+        switch ( format )
+        {
+            case PixelFormat::RGB32: return "RGB32";
+            case PixelFormat::RGB24: return "RGB24";
+            case PixelFormat::YUY2:  return "YUY2";
+            case PixelFormat::UYVY:  return "UYVY";
+            case PixelFormat::NV12:  return "NV12";
+            case PixelFormat::I420:  return "I420";
+            case PixelFormat::MJPEG: return "MJPG";
+            case PixelFormat::H264:  return "H264";
+            default: return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,343 @@
+//
+//  AX-VideoCaptureCore.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+// The types everything else is built on, with no Cinder or GL dependency, so headless
+// hosts (ingest servers, tools) can capture and process frames without linking either.
+// The Cinder side (Surface views, gl::Texture leases) lives in AX-VideoCaptureCinder.h.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace AX::Video
+{
+    // Interchangeable with ci::ivec2 (or any vector type with an x, y constructor)
+    struct Vec2i
+    {
+        int32_t x{ 0 };
+        int32_t y{ 0 };
+
+        constexpr Vec2i ( ) = default;
+        constexpr Vec2i ( int32_t x_, int32_t y_ ) : x ( x_ ), y ( y_ ) { }
+
+        template <typename T, typename = decltype ( std::declval<const T&> ( ).x ), typename = std::enable_if_t<!std::is_same_v<T, Vec2i>>>
+        constexpr Vec2i ( const T& v ) : x ( (int32_t)v.x ), y ( (int32_t)v.y ) { }
+
+        template <typename T, typename = decltype ( T ( 0, 0 ).x ), typename = std::enable_if_t<!std::is_same_v<T, Vec2i>>>
+        constexpr operator T ( ) const { return T ( x, y ); }
+
+        constexpr bool operator == ( const Vec2i& other ) const { return x == other.x && y == other.y; }
+        constexpr bool operator != ( const Vec2i& other ) const { return !( *this == other ); }
+    };
+
+    enum class PixelFormat
+    {
+        Unknown,
+        RGB32,  // BGRA in memory
+        RGB24,
+        YUY2,
+        UYVY,
+        NV12,
+        I420,
+        MJPEG,
+        H264
+    };
+
+    const char * ToString ( PixelFormat format );
+
+    // What a profile actually delivered when benchmarked, as opposed to what it advertises
+    struct ProfileMeasurement
+    {
+        float FPS{ 0.0f };
+        float JitterMs{ 0.0f };
+        float LatencyMs{ 0.0f };
+        float DropRate{ 0.0f };
+    };
+
+    struct DeviceProfile
+    {
+        Vec2i Size;
+        Vec2i FPS;
+        PixelFormat Subtype{ PixelFormat::Unknown };
+        ProfileMeasurement Measured; // Not part of the profile's identity
+
+        bool IsMeasured ( ) const { return Measured.FPS > 0.0f; }
+
+        bool operator == ( const DeviceProfile& other ) const
+        {
+            return Size == other.Size && FPS == other.FPS && Subtype == other.Subtype;
+        }
+
+        bool operator < ( const DeviceProfile& other ) const
+        {
+            return Key ( ) < other.Key ( );
+        }
+
+        std::string Key ( ) const
+        {
+            char buffer[48] = {};
+            float fps = ( (float)( FPS.x ) / (float)( FPS.y ) );
+            if ( Subtype == PixelFormat::Unknown )
+            {
+                std::snprintf ( buffer, sizeof(buffer), "%dx%d@%g", Size.x, Size.y, fps );
+            } else
+            {
+                std::snprintf ( buffer, sizeof(buffer), "%dx%d@%g %s", Size.x, Size.y, fps, ToString ( Subtype ) );
+            }
+            return buffer;
+        }
+    };
+
+    struct DeviceDescriptor
+    {
+        std::string Name;
+        std::string ID;
+
+        bool operator == ( const DeviceDescriptor& other ) const
+        {
+            return Name == other.Name && ID == other.ID;
+        }
+
+        bool operator < ( const DeviceDescriptor& other ) const
+        {
+            return Name < other.Name && ID < other.ID;
+        }
+    };
+
+    enum class BusSpeed
+    {
+        Unknown,
+        USB2,
+        USB3
+    };
+
+    // Where a device hangs off the host. Devices that share a Controller
+    // (or Hub) also share that link's bandwidth.
+    struct DeviceTopology
+    {
+        std::string Controller;
+        std::string Hub;
+        BusSpeed    Speed{ BusSpeed::Unknown };     // The device's own link, a USB2 camera on a USB3 port is USB2
+    };
+
+    struct CaptureStats
+    {
+        uint64_t    FramesDelivered{ 0 };
+        uint64_t    FramesDropped{ 0 };
+        uint64_t    BytesDelivered{ 0 };
+        double      ElapsedSeconds{ 0.0 };
+        double      FPS{ 0.0 };
+        double      JitterMs{ 0.0 };
+        double      LatencyMs{ 0.0 };
+        double      LatencyP50Ms{ 0.0 };
+        double      LatencyP95Ms{ 0.0 };
+        double      LatencyP99Ms{ 0.0 };
+        uint64_t    LatencySamples{ 0 };    // Frames the latency figures are over, those with a device timestamp
+        // Where the rest of the latency comes from, past the device. Delivery is arrival to the
+        // frame being published (copies, frame callbacks), Pickup is published to the consumer
+        // taking it (GetFrame / GetSurface / GetTexture).
+        double      DeliveryMs{ 0.0 };
+        double      DeliveryP95Ms{ 0.0 };
+        double      PickupMs{ 0.0 };
+        double      PickupP95Ms{ 0.0 };
+        uint64_t    Errors{ 0 };
+        uint64_t    Restarts{ 0 };          // Starts after the first
+        uint64_t    MemoryBytes{ 0 };       // Frame storage the capture currently owns
+        double      StabilizeMs{ 0.0 };     // Mean motion estimate per frame, when stabilising
+        std::vector<std::pair<int64_t, uint64_t>> ErrorCodes; // Count per HRESULT / errno
+    };
+
+    // Memory the host owns (pinned upload staging, an inference runtime's input tensors...)
+    // that CPU frames are written straight into. Acquire is called on the capture thread
+    // for a BGRA image of the given size, and can return a null Data to have that frame
+    // fall back to internal storage. Release is called once the last reference to the
+    // frame goes away, on whichever thread that happens, even if the capture itself has
+    // already been destroyed.
+    struct BufferProvider
+    {
+        struct Buffer
+        {
+            uint8_t*    Data{ nullptr };
+            ptrdiff_t   RowBytes{ 0 };      // At least width * 4
+            void*       Context{ nullptr }; // Handed back to Release untouched
+        };
+
+        std::function<Buffer ( const Vec2i& size )>     Acquire;
+        std::function<void ( const Buffer& buffer )>    Release;
+
+        explicit operator bool ( ) const { return Acquire && Release; }
+    };
+
+    struct Plane
+    {
+        uint8_t*    Data{ nullptr };
+        ptrdiff_t   RowBytes{ 0 };
+        Vec2i       Size;
+    };
+
+    using FrameRef = std::shared_ptr<class Frame>;
+
+    // See AX-VideoCaptureDerived.h
+    class DerivedCache;
+    struct GrayPlane;
+    struct IntegralImage;
+    struct LumaHistogram;
+
+    // A CPU image and the time it arrived. The pixels are owned by Storage (pooled, or a
+    // host's BufferProvider buffer) and go back where they came from with the last reference.
+    class Frame
+    {
+    public:
+
+        static constexpr size_t kMaxPlanes = 3;
+
+        Frame ( ) { };
+        Frame ( PixelFormat format, const Vec2i& size, std::shared_ptr<void> storage )
+            : _format ( format ), _size ( size ), _storage ( std::move ( storage ) ) { }
+
+        PixelFormat                 GetFormat ( ) const { return _format; }
+        const Vec2i&                GetSize ( ) const { return _size; }
+        size_t                      GetNumPlanes ( ) const { return _numPlanes; }
+        const Plane&                GetPlane ( size_t index = 0 ) const { return _planes[index]; }
+        Plane&                      GetPlane ( size_t index = 0 ) { return _planes[index]; }
+        double                      GetTimestamp ( ) const { return _timestamp; }
+        uint64_t                    GetSequence ( ) const { return _sequence; }
+
+        void                        AddPlane ( const Plane& plane ) { if ( _numPlanes < kMaxPlanes ) _planes[_numPlanes++] = plane; }
+        void                        SetTimestamp ( double timestamp ) { _timestamp = timestamp; }
+        void                        SetSequence ( uint64_t sequence ) { _sequence = sequence; }
+
+        // Computed from the pixels by whichever consumer asks first and shared with the rest,
+        // so display, tracking and analytics don't each derive their own. Dropped with the frame,
+        // or when a capture writes new pixels into it. Only ask once the pixels are final (any
+        // frame a capture has handed out is).
+        const GrayPlane&            GetGray ( ) const;
+        // 0 is GetGray, each level after is half the size of the one before
+        const GrayPlane&            GetPyramidLevel ( size_t level ) const;
+        const IntegralImage&        GetIntegral ( ) const;
+        const LumaHistogram&        GetHistogram ( ) const;
+
+    protected:
+
+        // Captures write over frames nobody else holds rather than taking a new one each time
+        friend class Capture;
+
+        PixelFormat                 _format{ PixelFormat::Unknown };
+        Vec2i                       _size;
+        std::array<Plane, kMaxPlanes> _planes;
+        size_t                      _numPlanes{ 0 };
+        double                      _timestamp{ 0.0 };
+        uint64_t                    _sequence{ 0 };
+        std::shared_ptr<void>       _storage;
+
+        DerivedCache&               GetDerived ( ) const;
+        // Before the pixels are written over, so nothing derived from the old ones is served
+        void                        ResetDerived ( );
+        mutable std::shared_ptr<DerivedCache> _derived;   // Created on first use
+    };
+
+    // A minimal, thread safe stand in for ci::signals::Signal with the same connect / emit
+    // spelling, so code written against one compiles against the other. Slots are copied
+    // out before being called, so a slot can disconnect itself (or others) while emitting.
+    template <typename Signature>
+    class Signal;
+
+    template <typename... Args>
+    class Signal<void ( Args... )>
+    {
+    public:
+
+        using Slot = std::function<void ( Args... )>;
+
+        class Connection
+        {
+        public:
+
+            Connection ( ) { };
+            Connection ( const std::weak_ptr<Signal*>& owner, uint64_t id ) : _owner ( owner ), _id ( id ) { }
+
+            void disconnect ( )
+            {
+                if ( auto owner = _owner.lock ( ) ) ( *owner )->Disconnect ( _id );
+                _owner.reset ( );
+            }
+
+            bool isConnected ( ) const { return !_owner.expired ( ) && _id != 0; }
+
+        protected:
+
+            std::weak_ptr<Signal*>  _owner;
+            uint64_t                _id{ 0 };
+        };
+
+        Signal ( ) { };
+        Signal ( const Signal& ) = delete;
+        Signal& operator = ( const Signal& ) = delete;
+
+        Connection connect ( Slot slot )
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            auto slots = std::make_shared<SlotList> ( *_slots );
+            uint64_t id = _nextID++;
+            slots->emplace_back ( id, std::move ( slot ) );
+            _slots = slots;
+            return Connection ( _self, id );
+        }
+
+        void emit ( Args... args )
+        {
+            std::shared_ptr<const SlotList> slots;
+            {
+                std::lock_guard<std::mutex> lock ( _mutex );
+                slots = _slots;
+            }
+
+            for ( auto& [id, slot] : *slots ) slot ( args... );
+        }
+
+        size_t getNumSlots ( ) const
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            return _slots->size ( );
+        }
+
+    protected:
+
+        using SlotList = std::vector<std::pair<uint64_t, Slot>>;
+
+        void Disconnect ( uint64_t id )
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            auto slots = std::make_shared<SlotList> ( *_slots );
+            slots->erase ( std::remove_if ( slots->begin ( ), slots->end ( ), [=] ( const auto& s ) { return s.first == id; } ), slots->end ( ) );
+            _slots = slots;
+        }
+
+        mutable std::mutex                  _mutex;
+        std::shared_ptr<const SlotList>     _slots{ std::make_shared<SlotList> ( ) };
+        uint64_t                            _nextID{ 1 };
+        std::shared_ptr<Signal*>            _self{ std::make_shared<Signal*> ( this ) };
+    };
+}
+
+inline std::ostream& operator << ( std::ostream& stream, const AX::Video::DeviceDescriptor& descriptor )
+{
+    return stream << descriptor.Name << " (" << descriptor.ID << ")";
+}
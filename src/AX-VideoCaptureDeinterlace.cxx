@@ -0,0 +1,182 @@
+//
+//  AX-VideoCaptureDeinterlace.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureDeinterlace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        inline uint8_t Average ( uint8_t a, uint8_t b )
+        {
+            // Rounds up, same as _mm_avg_epu8
+            return (uint8_t)( ( a + b + 1 ) >> 1 );
+        }
+
+        void AverageRow ( uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes )
+        {
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                __m128i va = _mm_loadu_si128 ( (const __m128i*)( a + i ) );
+                __m128i vb = _mm_loadu_si128 ( (const __m128i*)( b + i ) );
+                _mm_storeu_si128 ( (__m128i*)( dst + i ), _mm_avg_epu8 ( va, vb ) );
+            }
+#endif
+            for ( ; i < bytes; i++ ) dst[i] = Average ( a[i], b[i] );
+        }
+
+        // ( above + 2 * row + below ) / 4, as two rounding averages
+        void BlendRow ( uint8_t* dst, const uint8_t* above, const uint8_t* row, const uint8_t* below, size_t bytes )
+        {
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                __m128i va = _mm_loadu_si128 ( (const __m128i*)( above + i ) );
+                __m128i vr = _mm_loadu_si128 ( (const __m128i*)( row + i ) );
+                __m128i vb = _mm_loadu_si128 ( (const __m128i*)( below + i ) );
+                _mm_storeu_si128 ( (__m128i*)( dst + i ), _mm_avg_epu8 ( _mm_avg_epu8 ( va, vb ), vr ) );
+            }
+#endif
+            for ( ; i < bytes; i++ ) dst[i] = Average ( Average ( above[i], below[i] ), row[i] );
+        }
+
+        // Per pixel: the woven line where no channel moved more than threshold since the last
+        // frame, otherwise the line interpolated from the field either side
+        void AdaptiveRow ( uint8_t* dst, const uint8_t* above, const uint8_t* below, const uint8_t* woven, const uint8_t* previous, size_t bytes, uint8_t threshold )
+        {
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            const __m128i vt = _mm_set1_epi8 ( (char)threshold );
+            const __m128i zero = _mm_setzero_si128 ( );
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                __m128i va = _mm_loadu_si128 ( (const __m128i*)( above + i ) );
+                __m128i vb = _mm_loadu_si128 ( (const __m128i*)( below + i ) );
+                __m128i vw = _mm_loadu_si128 ( (const __m128i*)( woven + i ) );
+                __m128i vp = _mm_loadu_si128 ( (const __m128i*)( previous + i ) );
+
+                __m128i difference = _mm_or_si128 ( _mm_subs_epu8 ( vw, vp ), _mm_subs_epu8 ( vp, vw ) );
+                __m128i still = _mm_cmpeq_epi8 ( _mm_subs_epu8 ( difference, vt ), zero );
+                // A pixel is still only if all four of its channels are
+                still = _mm_cmpeq_epi32 ( still, _mm_set1_epi32 ( -1 ) );
+
+                __m128i interpolated = _mm_avg_epu8 ( va, vb );
+                __m128i result = _mm_or_si128 ( _mm_and_si128 ( still, vw ), _mm_andnot_si128 ( still, interpolated ) );
+                _mm_storeu_si128 ( (__m128i*)( dst + i ), result );
+            }
+#endif
+            for ( ; i + 4 <= bytes; i += 4 )
+            {
+                bool still = true;
+                for ( size_t c = 0; c < 4; c++ )
+                {
+                    if ( std::abs ( (int)woven[i + c] - (int)previous[i + c] ) > threshold ) still = false;
+                }
+
+                for ( size_t c = 0; c < 4; c++ ) dst[i + c] = still ? woven[i + c] : Average ( above[i + c], below[i + c] );
+            }
+        }
+    }
+
+    const char * ToString ( DeinterlaceMode mode )
+    {
+        switch ( mode )
+        {
+            case DeinterlaceMode::Off:              return "Off";
+            case DeinterlaceMode::Weave:            return "Weave";
+            case DeinterlaceMode::Bob:              return "Bob";
+            case DeinterlaceMode::Blend:            return "Blend";
+            case DeinterlaceMode::MotionAdaptive:   return "MotionAdaptive";
+            default: return "Unknown";
+        }
+    }
+
+    int Deinterlacer::GetNumOutputs ( ) const
+    {
+        bool perField = _options.Mode ( ) == DeinterlaceMode::Bob || _options.Mode ( ) == DeinterlaceMode::MotionAdaptive;
+        return perField && _options.FieldRate ( ) ? 2 : 1;
+    }
+
+    void Deinterlacer::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, int output )
+    {
+        const int32_t height = dst.Size.y;
+        const size_t rowBytes = (size_t)dst.Size.x * 4;
+        if ( height <= 0 || rowBytes == 0 ) return;
+
+        auto SrcRow = [&] ( int32_t y ) { return src + srcRowBytes * (ptrdiff_t)std::clamp ( y, 0, height - 1 ); };
+        auto DstRow = [&] ( int32_t y ) { return dst.Data + dst.RowBytes * (ptrdiff_t)y; };
+
+        switch ( _options.Mode ( ) )
+        {
+            case DeinterlaceMode::Blend:
+            {
+                for ( int32_t y = 0; y < height; y++ ) BlendRow ( DstRow ( y ), SrcRow ( y - 1 ), SrcRow ( y ), SrcRow ( y + 1 ), rowBytes );
+                break;
+            }
+
+            case DeinterlaceMode::Bob:
+            case DeinterlaceMode::MotionAdaptive:
+            {
+                // The lines of the field being shown, 0 for the top (even) field
+                int32_t field = ( output & 1 ) ^ ( _options.Order ( ) == FieldOrder::BottomFirst ? 1 : 0 );
+                bool isAdaptive = _options.Mode ( ) == DeinterlaceMode::MotionAdaptive && _previousSize == dst.Size;
+                const ptrdiff_t previousRowBytes = (ptrdiff_t)rowBytes;
+
+                for ( int32_t y = 0; y < height; y++ )
+                {
+                    if ( ( y & 1 ) == field )
+                    {
+                        std::memcpy ( DstRow ( y ), SrcRow ( y ), rowBytes );
+                        continue;
+                    }
+
+                    // Nearest lines of the shown field, mirrored at the edges
+                    int32_t above = y - 1 >= 0 ? y - 1 : y + 1;
+                    int32_t below = y + 1 < height ? y + 1 : y - 1;
+
+                    if ( isAdaptive )
+                    {
+                        AdaptiveRow ( DstRow ( y ), SrcRow ( above ), SrcRow ( below ), SrcRow ( y ), _previous.data ( ) + previousRowBytes * y, rowBytes, _options.MotionThreshold ( ) );
+                    } else
+                    {
+                        AverageRow ( DstRow ( y ), SrcRow ( above ), SrcRow ( below ), rowBytes );
+                    }
+                }
+                break;
+            }
+
+            default:
+            {
+                for ( int32_t y = 0; y < height; y++ ) std::memcpy ( DstRow ( y ), SrcRow ( y ), rowBytes );
+                break;
+            }
+        }
+    }
+
+    void Deinterlacer::EndFrame ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size )
+    {
+        if ( _options.Mode ( ) != DeinterlaceMode::MotionAdaptive ) return;
+
+        const size_t rowBytes = (size_t)size.x * 4;
+        _previous.resize ( rowBytes * (size_t)std::max ( 0, size.y ) );
+        for ( int32_t y = 0; y < size.y; y++ ) std::memcpy ( _previous.data ( ) + rowBytes * y, src + srcRowBytes * y, rowBytes );
+        _previousSize = size;
+    }
+}
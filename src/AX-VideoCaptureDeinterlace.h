@@ -0,0 +1,83 @@
+//
+//  AX-VideoCaptureDeinterlace.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+
+namespace AX::Video
+{
+    enum class DeinterlaceMode
+    {
+        Off,
+        Weave,          // Fields left interleaved, a straight copy
+        Bob,            // One field, the other's lines interpolated from it
+        Blend,          // Vertical [1 2 1] filter over both fields, softer but never combs
+        MotionAdaptive  // Weave where the picture is still, bob where it's moving
+    };
+
+    enum class FieldOrder
+    {
+        TopFirst,
+        BottomFirst
+    };
+
+    const char * ToString ( DeinterlaceMode mode );
+
+    struct DeinterlaceOptions
+    {
+        DeinterlaceOptions ( ) { };
+        DeinterlaceOptions ( DeinterlaceMode mode ) : _mode ( mode ) { };
+
+        DeinterlaceOptions& Mode ( DeinterlaceMode mode ) { _mode = mode; return *this; }
+        DeinterlaceOptions& Order ( FieldOrder order ) { _order = order; return *this; }
+        // Bob and MotionAdaptive only. Each field becomes a frame of its own, doubling the rate.
+        DeinterlaceOptions& FieldRate ( bool fieldRate ) { _fieldRate = fieldRate; return *this; }
+        // MotionAdaptive only, the largest per channel change still treated as static
+        DeinterlaceOptions& MotionThreshold ( uint8_t threshold ) { _motionThreshold = threshold; return *this; }
+
+        DeinterlaceMode     Mode ( ) const { return _mode; }
+        FieldOrder          Order ( ) const { return _order; }
+        bool                FieldRate ( ) const { return _fieldRate; }
+        uint8_t             MotionThreshold ( ) const { return _motionThreshold; }
+        bool                IsEnabled ( ) const { return _mode != DeinterlaceMode::Off; }
+
+    protected:
+
+        DeinterlaceMode     _mode{ DeinterlaceMode::Off };
+        FieldOrder          _order{ FieldOrder::TopFirst };
+        bool                _fieldRate{ false };
+        uint8_t             _motionThreshold{ 12 };
+    };
+
+    // Deinterlaces 4 byte per pixel frames as they're copied out of the capture buffer, so it
+    // costs one pass rather than a copy and then a filter. SSE2 where available.
+    class Deinterlacer
+    {
+    public:
+
+        Deinterlacer                ( const DeinterlaceOptions& options = { } ) : _options ( options ) { }
+
+        const DeinterlaceOptions&   GetOptions ( ) const { return _options; }
+        // 2 at field rate, otherwise 1
+        int                         GetNumOutputs ( ) const;
+
+        // Writes output 0 .. GetNumOutputs ( ) - 1 of src into dst, in display order. src is
+        // dst.Size and 4 bytes per pixel. Call EndFrame ( ) once every output has been written.
+        void                        Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, int output );
+        // Keeps src as the reference MotionAdaptive compares the next frame against
+        void                        EndFrame ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size );
+
+    protected:
+
+        DeinterlaceOptions          _options;
+        std::vector<uint8_t>        _previous;
+        Vec2i                       _previousSize;
+    };
+}
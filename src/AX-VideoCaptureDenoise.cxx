@@ -0,0 +1,205 @@
+//
+//  AX-VideoCaptureDenoise.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureDenoise.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr int kFraction = 6;    // Accumulator bits below the pixel value
+        constexpr int kMaxGain = 32767; // 1.0 in Q15
+
+        // Keeps Stack's 16 bit sums from overflowing
+        constexpr int32_t kMaxStackFrames = 256;
+
+        // acc moves towards src by gain, which rises from minGain for an unchanged pixel to all
+        // the way once the change reaches threshold. gain = minGain + min ( |change|, threshold ) * slope.
+        void FilterRow ( uint8_t* dst, const uint8_t* src, uint16_t* acc, size_t bytes, int16_t minGain, int16_t slope, int16_t threshold )
+        {
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            const __m128i zero = _mm_setzero_si128 ( );
+            const __m128i vMin = _mm_set1_epi16 ( minGain );
+            const __m128i vSlope = _mm_set1_epi16 ( slope );
+            const __m128i vThreshold = _mm_set1_epi16 ( threshold );
+            const __m128i round = _mm_set1_epi16 ( 1 << ( kFraction - 1 ) );
+
+            auto Step = [&] ( __m128i pixels, __m128i accumulated )
+            {
+                __m128i target = _mm_slli_epi16 ( pixels, kFraction );
+                __m128i difference = _mm_sub_epi16 ( target, accumulated );
+
+                __m128i change = _mm_srai_epi16 ( difference, kFraction );
+                change = _mm_max_epi16 ( change, _mm_sub_epi16 ( zero, change ) );
+                __m128i gain = _mm_add_epi16 ( vMin, _mm_mullo_epi16 ( _mm_min_epi16 ( change, vThreshold ), vSlope ) );
+
+                // ( difference * gain ) >> 15, difference doubled first as mulhi shifts by 16
+                return _mm_add_epi16 ( accumulated, _mm_mulhi_epi16 ( _mm_slli_epi16 ( difference, 1 ), gain ) );
+            };
+
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                __m128i pixels = _mm_loadu_si128 ( (const __m128i*)( src + i ) );
+                __m128i lo = Step ( _mm_unpacklo_epi8 ( pixels, zero ), _mm_loadu_si128 ( (const __m128i*)( acc + i ) ) );
+                __m128i hi = Step ( _mm_unpackhi_epi8 ( pixels, zero ), _mm_loadu_si128 ( (const __m128i*)( acc + i + 8 ) ) );
+                _mm_storeu_si128 ( (__m128i*)( acc + i ), lo );
+                _mm_storeu_si128 ( (__m128i*)( acc + i + 8 ), hi );
+
+                __m128i out = _mm_packus_epi16 ( _mm_srli_epi16 ( _mm_add_epi16 ( lo, round ), kFraction ), _mm_srli_epi16 ( _mm_add_epi16 ( hi, round ), kFraction ) );
+                _mm_storeu_si128 ( (__m128i*)( dst + i ), out );
+            }
+#endif
+            for ( ; i < bytes; i++ )
+            {
+                int32_t accumulated = acc[i];
+                int32_t difference = ( (int32_t)src[i] << kFraction ) - accumulated;
+                int32_t change = std::min<int32_t> ( std::abs ( difference >> kFraction ), threshold );
+                int32_t gain = minGain + change * slope;
+
+                // Matches mulhi's rounding towards negative infinity
+                accumulated += ( difference * 2 * gain ) >> 16;
+                acc[i] = (uint16_t)accumulated;
+                dst[i] = (uint8_t)std::min ( 255, ( accumulated + ( 1 << ( kFraction - 1 ) ) ) >> kFraction );
+            }
+        }
+
+        // The sum moves on a frame, old (the one leaving the window, or null while it fills)
+        // out and src in, with src kept in history. The output is the mean of count frames,
+        // eased back towards src by the same motion gain as FilterRow.
+        void StackRow ( uint8_t* dst, const uint8_t* src, uint8_t* history, const uint8_t* old, uint16_t* sum, size_t bytes, int32_t count, int16_t slope, int16_t threshold )
+        {
+            // sum / count as ( sum + count / 2 ) * reciprocal >> 16, within 1 of the exact mean
+            const int32_t half = count / 2;
+            const int32_t reciprocal = count > 1 ? ( 65536 + count - 1 ) / count : 0;
+
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            const __m128i zero = _mm_setzero_si128 ( );
+            const __m128i vSlope = _mm_set1_epi16 ( slope );
+            const __m128i vThreshold = _mm_set1_epi16 ( threshold );
+            const __m128i vHalf = _mm_set1_epi16 ( (int16_t)half );
+            const __m128i vReciprocal = _mm_set1_epi16 ( (int16_t)reciprocal );
+
+            auto Step = [&] ( __m128i pixels, __m128i leaving, uint16_t* total )
+            {
+                __m128i s = _mm_sub_epi16 ( _mm_add_epi16 ( _mm_loadu_si128 ( (const __m128i*)total ), pixels ), leaving );
+                _mm_storeu_si128 ( (__m128i*)total, s );
+
+                __m128i mean = count > 1 ? _mm_mulhi_epu16 ( _mm_add_epi16 ( s, vHalf ), vReciprocal ) : s;
+                __m128i difference = _mm_sub_epi16 ( pixels, mean );
+                __m128i change = _mm_max_epi16 ( difference, _mm_sub_epi16 ( zero, difference ) );
+                __m128i gain = _mm_mullo_epi16 ( _mm_min_epi16 ( change, vThreshold ), vSlope );
+                return _mm_add_epi16 ( mean, _mm_mulhi_epi16 ( _mm_slli_epi16 ( difference, 1 ), gain ) );
+            };
+
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                __m128i pixels = _mm_loadu_si128 ( (const __m128i*)( src + i ) );
+                __m128i leaving = old ? _mm_loadu_si128 ( (const __m128i*)( old + i ) ) : zero;
+                _mm_storeu_si128 ( (__m128i*)( history + i ), pixels );
+
+                __m128i lo = Step ( _mm_unpacklo_epi8 ( pixels, zero ), _mm_unpacklo_epi8 ( leaving, zero ), sum + i );
+                __m128i hi = Step ( _mm_unpackhi_epi8 ( pixels, zero ), _mm_unpackhi_epi8 ( leaving, zero ), sum + i + 8 );
+                _mm_storeu_si128 ( (__m128i*)( dst + i ), _mm_packus_epi16 ( lo, hi ) );
+            }
+#endif
+            for ( ; i < bytes; i++ )
+            {
+                const int32_t pixel = src[i];
+                const int32_t total = sum[i] + pixel - ( old ? old[i] : 0 );
+                sum[i] = (uint16_t)total;
+                history[i] = (uint8_t)pixel;
+
+                const int32_t mean = count > 1 ? ( ( total + half ) * reciprocal ) >> 16 : total;
+                const int32_t difference = pixel - mean;
+                const int32_t gain = std::min<int32_t> ( std::abs ( difference ), threshold ) * slope;
+                dst[i] = (uint8_t)std::clamp ( mean + ( ( difference * 2 * gain ) >> 16 ), 0, 255 );
+            }
+        }
+    }
+
+    const char * ToString ( DenoiseMode mode )
+    {
+        switch ( mode )
+        {
+            case DenoiseMode::Off:          return "Off";
+            case DenoiseMode::Recursive:    return "Recursive";
+            case DenoiseMode::Stack:        return "Stack";
+            default: return "Unknown";
+        }
+    }
+
+    void Denoiser::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst )
+    {
+        if ( !dst.Data || dst.Size.x <= 0 || dst.Size.y <= 0 ) return;
+
+        const bool stack = _options.Mode ( ) == DenoiseMode::Stack;
+        const int32_t window = stack ? std::clamp ( _options.Frames ( ), 1, kMaxStackFrames ) : 2;
+        const size_t rowBytes = (size_t)dst.Size.x * 4;
+        const size_t frameBytes = rowBytes * (size_t)dst.Size.y;
+
+        if ( dst.Size != _size )
+        {
+            _size = dst.Size;
+            _accumulator.assign ( frameBytes, 0 );
+            if ( stack ) _history.assign ( frameBytes * (size_t)window, 0 );
+            _numFrames = 0;
+        }
+
+        const int16_t threshold = (int16_t)std::max<int> ( 1, _options.MotionThreshold ( ) );
+
+        if ( stack )
+        {
+            // A true sliding mean: each frame is added to the running sum as the one Frames ago
+            // is taken back out of it. Until the window fills it's the mean of what's been seen.
+            if ( _numFrames == 0 )
+            {
+                std::fill ( _accumulator.begin ( ), _accumulator.end ( ), (uint16_t)0 );
+                _head = 0;
+            }
+
+            const bool isFull = _numFrames == window;
+            _numFrames = std::min ( _numFrames + 1, window );
+
+            uint8_t* slot = _history.data ( ) + frameBytes * (size_t)_head;
+            const int16_t slope = (int16_t)( kMaxGain / threshold );
+
+            for ( int32_t y = 0; y < dst.Size.y; y++ )
+            {
+                uint8_t* history = slot + rowBytes * (size_t)y;
+                StackRow ( dst.Data + dst.RowBytes * (ptrdiff_t)y, src + srcRowBytes * (ptrdiff_t)y, history, isFull ? history : nullptr,
+                           _accumulator.data ( ) + rowBytes * (size_t)y, rowBytes, _numFrames, slope, threshold );
+            }
+
+            _head = ( _head + 1 ) % window;
+            return;
+        }
+
+        // The first frame seeds the accumulator, a gain of 1 takes the source as is
+        _numFrames = std::min ( _numFrames + 1, window );
+
+        int16_t minGain = kMaxGain;
+        if ( _numFrames > 1 ) minGain = (int16_t)std::clamp ( ( 1.0 - _options.Strength ( ) ) * kMaxGain, 0.0, (double)kMaxGain );
+
+        const int16_t slope = (int16_t)( ( kMaxGain - minGain ) / threshold );
+
+        for ( int32_t y = 0; y < dst.Size.y; y++ )
+        {
+            FilterRow ( dst.Data + dst.RowBytes * (ptrdiff_t)y, src + srcRowBytes * (ptrdiff_t)y, _accumulator.data ( ) + rowBytes * (size_t)y, rowBytes, minGain, slope, threshold );
+        }
+    }
+}
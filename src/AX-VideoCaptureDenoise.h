@@ -0,0 +1,79 @@
+//
+//  AX-VideoCaptureDenoise.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+
+namespace AX::Video
+{
+    enum class DenoiseMode
+    {
+        Off,
+        Recursive,  // Each frame blended into the last result, less so where things move
+        Stack       // The mean of the last Frames frames, for static scenes
+    };
+
+    const char * ToString ( DenoiseMode mode );
+
+    struct DenoiseOptions
+    {
+        DenoiseOptions ( ) { };
+        DenoiseOptions ( DenoiseMode mode ) : _mode ( mode ) { };
+
+        DenoiseOptions& Mode ( DenoiseMode mode ) { _mode = mode; return *this; }
+        // Recursive only, 0 .. 1. How much of the previous result a still pixel keeps.
+        DenoiseOptions& Strength ( double strength ) { _strength = strength; return *this; }
+        // Stack only, how many frames are averaged (at most 256). Every one of them is kept.
+        DenoiseOptions& Frames ( int32_t frames ) { _frames = frames; return *this; }
+        // Per channel change treated as motion rather than noise. Filtering eases off as a
+        // pixel's change approaches it and stops altogether past it, so movement doesn't smear.
+        DenoiseOptions& MotionThreshold ( uint8_t threshold ) { _motionThreshold = threshold; return *this; }
+
+        DenoiseMode         Mode ( ) const { return _mode; }
+        double              Strength ( ) const { return _strength; }
+        int32_t             Frames ( ) const { return _frames; }
+        uint8_t             MotionThreshold ( ) const { return _motionThreshold; }
+        bool                IsEnabled ( ) const { return _mode != DenoiseMode::Off; }
+
+    protected:
+
+        DenoiseMode         _mode{ DenoiseMode::Off };
+        double              _strength{ 0.75 };
+        int32_t             _frames{ 8 };
+        uint8_t             _motionThreshold{ 24 };
+    };
+
+    // Temporal noise reduction on 4 byte per pixel frames, in a single SSE2 pass per frame.
+    // Recursive filters against a 16 bit per channel accumulator (8.6 fixed point). Stack
+    // keeps the last Frames frames and a 16 bit per channel sum of them, so each frame also
+    // costs a read and write of the history on top of the accumulator.
+    class Denoiser
+    {
+    public:
+
+        Denoiser                    ( const DenoiseOptions& options = { } ) : _options ( options ) { }
+
+        const DenoiseOptions&       GetOptions ( ) const { return _options; }
+
+        // src is dst.Size, and can be dst.Data
+        void                        Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst );
+        // Starts again from the next frame, e.g. after a scene change
+        void                        Reset ( ) { _numFrames = 0; }
+
+    protected:
+
+        DenoiseOptions              _options;
+        std::vector<uint16_t>       _accumulator;   // Recursive's filtered frame, or Stack's sums
+        std::vector<uint8_t>        _history;       // Stack's window, a ring of whole frames
+        Vec2i                       _size;
+        int32_t                     _numFrames{ 0 };
+        int32_t                     _head{ 0 };     // Slot the next frame goes in
+    };
+}
@@ -0,0 +1,341 @@
+//
+//  AX-VideoCaptureDerived.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureDerived.h"
+#include <chrono>
+#include <cstring>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        struct Counters
+        {
+            std::atomic<uint64_t>   Hits{ 0 };
+            std::atomic<uint64_t>   Waits{ 0 };
+            std::atomic<uint64_t>   Computed{ 0 };
+            std::atomic<uint64_t>   ComputeMicros{ 0 };
+        };
+
+        Counters& GetCounters ( )
+        {
+            static Counters kCounters;
+            return kCounters;
+        }
+
+        // BT.601 luma in 8 bit fixed point, the weights sum to 256
+        constexpr int32_t kWeightB = 29;
+        constexpr int32_t kWeightG = 150;
+        constexpr int32_t kWeightR = 77;
+
+        void GrayRow ( const uint8_t* src, uint8_t* dst, int32_t width )
+        {
+            int32_t x = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            // 16 pixels at a time: widen to 16 bits, multiply-add (B, G) and (R, A) pairs, then add the pairs
+            const __m128i zero = _mm_setzero_si128 ( );
+            const __m128i weights = _mm_setr_epi16 ( kWeightB, kWeightG, kWeightR, 0, kWeightB, kWeightG, kWeightR, 0 );
+            const __m128i half = _mm_set1_epi32 ( 128 );
+            auto Four = [&] ( const uint8_t* p )
+            {
+                __m128i v = _mm_loadu_si128 ( (const __m128i*)p );
+                __m128 lo = _mm_castsi128_ps ( _mm_madd_epi16 ( _mm_unpacklo_epi8 ( v, zero ), weights ) );
+                __m128 hi = _mm_castsi128_ps ( _mm_madd_epi16 ( _mm_unpackhi_epi8 ( v, zero ), weights ) );
+                __m128i even = _mm_castps_si128 ( _mm_shuffle_ps ( lo, hi, _MM_SHUFFLE ( 2, 0, 2, 0 ) ) );
+                __m128i odd = _mm_castps_si128 ( _mm_shuffle_ps ( lo, hi, _MM_SHUFFLE ( 3, 1, 3, 1 ) ) );
+                return _mm_srli_epi32 ( _mm_add_epi32 ( _mm_add_epi32 ( even, odd ), half ), 8 );
+            };
+
+            for ( ; x + 16 <= width; x += 16 )
+            {
+                const uint8_t* p = src + (size_t)x * 4;
+                __m128i a = _mm_packs_epi32 ( Four ( p ), Four ( p + 16 ) );
+                __m128i b = _mm_packs_epi32 ( Four ( p + 32 ), Four ( p + 48 ) );
+                _mm_storeu_si128 ( (__m128i*)( dst + x ), _mm_packus_epi16 ( a, b ) );
+            }
+#endif
+            for ( ; x < width; x++ )
+            {
+                const uint8_t* p = src + (size_t)x * 4;
+                dst[x] = (uint8_t)( ( p[0] * kWeightB + p[1] * kWeightG + p[2] * kWeightR + 128 ) >> 8 );
+            }
+        }
+
+        // 2x2 box filter, dst is half of src (rounded down)
+        void DownsampleRow ( const uint8_t* upper, const uint8_t* lower, uint8_t* dst, int32_t width )
+        {
+            int32_t x = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            // Averages vertically then horizontally, which can round up by one more than the scalar path
+            const __m128i mask = _mm_set1_epi16 ( 0x00FF );
+            for ( ; x + 8 <= width; x += 8 )
+            {
+                __m128i v = _mm_avg_epu8 ( _mm_loadu_si128 ( (const __m128i*)( upper + x * 2 ) ), _mm_loadu_si128 ( (const __m128i*)( lower + x * 2 ) ) );
+                __m128i h = _mm_avg_epu16 ( _mm_and_si128 ( v, mask ), _mm_srli_epi16 ( v, 8 ) );
+                _mm_storel_epi64 ( (__m128i*)( dst + x ), _mm_packus_epi16 ( h, h ) );
+            }
+#endif
+            for ( ; x < width; x++ )
+            {
+                dst[x] = (uint8_t)( ( upper[x * 2] + upper[x * 2 + 1] + lower[x * 2] + lower[x * 2 + 1] + 2 ) / 4 );
+            }
+        }
+
+        void BuildGray ( const Frame& frame, GrayPlane& gray )
+        {
+            if ( frame.GetNumPlanes ( ) == 0 ) return;
+
+            auto& plane = frame.GetPlane ( 0 );
+            if ( !plane.Data || plane.Size.x <= 0 || plane.Size.y <= 0 ) return;
+
+            gray.Size = plane.Size;
+            gray.Pixels.resize ( (size_t)plane.Size.x * (size_t)plane.Size.y );
+
+            switch ( frame.GetFormat ( ) )
+            {
+                case PixelFormat::RGB32:
+                {
+                    for ( int32_t y = 0; y < plane.Size.y; y++ )
+                    {
+                        GrayRow ( plane.Data + plane.RowBytes * (ptrdiff_t)y, &gray.Pixels[(size_t)y * plane.Size.x], plane.Size.x );
+                    }
+                    break;
+                }
+
+                // The first plane's already luma
+                case PixelFormat::NV12:
+                case PixelFormat::I420:
+                {
+                    for ( int32_t y = 0; y < plane.Size.y; y++ )
+                    {
+                        std::memcpy ( &gray.Pixels[(size_t)y * plane.Size.x], plane.Data + plane.RowBytes * (ptrdiff_t)y, (size_t)plane.Size.x );
+                    }
+                    break;
+                }
+
+                default:
+                {
+                    gray = { };
+                    break;
+                }
+            }
+        }
+
+        void BuildLevel ( const GrayPlane& src, GrayPlane& dst )
+        {
+            if ( src.Size.x < 2 || src.Size.y < 2 )
+            {
+                dst = src;
+                return;
+            }
+
+            dst.Size = { src.Size.x / 2, src.Size.y / 2 };
+            dst.Pixels.resize ( (size_t)dst.Size.x * (size_t)dst.Size.y );
+            for ( int32_t y = 0; y < dst.Size.y; y++ )
+            {
+                DownsampleRow ( src.GetRow ( y * 2 ), src.GetRow ( y * 2 + 1 ), &dst.Pixels[(size_t)y * dst.Size.x], dst.Size.x );
+            }
+        }
+
+        void BuildIntegral ( const GrayPlane& gray, IntegralImage& integral )
+        {
+            integral.Size = gray.Size;
+            const size_t stride = (size_t)gray.Size.x + 1;
+            integral.Sums.assign ( stride * ( (size_t)gray.Size.y + 1 ), 0 );
+
+            for ( int32_t y = 0; y < gray.Size.y; y++ )
+            {
+                const uint8_t* row = gray.GetRow ( y );
+                const uint32_t* above = &integral.Sums[(size_t)y * stride];
+                uint32_t* out = &integral.Sums[( (size_t)y + 1 ) * stride];
+                uint32_t sum = 0;
+                for ( int32_t x = 0; x < gray.Size.x; x++ )
+                {
+                    sum += row[x];
+                    out[x + 1] = above[x + 1] + sum;
+                }
+            }
+        }
+
+        void BuildHistogram ( const GrayPlane& gray, LumaHistogram& histogram )
+        {
+            // Four sets of bins so runs of the same level don't serialise on one counter
+            std::array<std::array<uint32_t, 256>, 4> bins{ };
+            const size_t count = gray.Pixels.size ( );
+            const uint8_t* p = gray.Pixels.data ( );
+            size_t i = 0;
+            for ( ; i + 4 <= count; i += 4 )
+            {
+                bins[0][p[i]]++;
+                bins[1][p[i + 1]]++;
+                bins[2][p[i + 2]]++;
+                bins[3][p[i + 3]]++;
+            }
+            for ( ; i < count; i++ ) bins[0][p[i]]++;
+
+            uint64_t total = 0;
+            for ( size_t level = 0; level < 256; level++ )
+            {
+                histogram.Bins[level] = bins[0][level] + bins[1][level] + bins[2][level] + bins[3][level];
+                total += (uint64_t)histogram.Bins[level] * level;
+            }
+
+            histogram.Count = (uint32_t)count;
+            histogram.Mean = count > 0 ? (double)total / (double)count : 0.0;
+        }
+    }
+
+    uint8_t LumaHistogram::Percentile ( double fraction ) const
+    {
+        const double target = std::clamp ( fraction, 0.0, 1.0 ) * Count;
+        uint64_t sum = 0;
+        for ( size_t level = 0; level < 256; level++ )
+        {
+            sum += Bins[level];
+            if ( sum > 0 && (double)sum >= target ) return (uint8_t)level;
+        }
+
+        return 255;
+    }
+
+    DerivedStats GetDerivedStats ( )
+    {
+        auto& counters = GetCounters ( );
+        DerivedStats stats;
+        stats.Hits = counters.Hits.load ( std::memory_order_relaxed );
+        stats.Waits = counters.Waits.load ( std::memory_order_relaxed );
+        stats.Computed = counters.Computed.load ( std::memory_order_relaxed );
+        stats.ComputeMs = counters.ComputeMicros.load ( std::memory_order_relaxed ) * 1.0e-3;
+        return stats;
+    }
+
+    void ResetDerivedStats ( )
+    {
+        auto& counters = GetCounters ( );
+        counters.Hits.store ( 0 );
+        counters.Waits.store ( 0 );
+        counters.Computed.store ( 0 );
+        counters.ComputeMicros.store ( 0 );
+    }
+
+    template <typename Fn>
+    void DerivedCache::Ensure ( size_t product, Fn&& compute )
+    {
+        auto& counters = GetCounters ( );
+        if ( _states[product].load ( std::memory_order_acquire ) == kReady )
+        {
+            counters.Hits.fetch_add ( 1, std::memory_order_relaxed );
+            return;
+        }
+
+        {
+            // Waits out whoever's computing it. If they failed it's back to empty and this
+            // thread has a go instead.
+            std::unique_lock<std::mutex> lock ( _mutex );
+            const bool isWaiting = _states[product].load ( std::memory_order_relaxed ) == kComputing;
+            if ( isWaiting ) _ready.wait ( lock, [&] { return _states[product].load ( std::memory_order_relaxed ) != kComputing; } );
+
+            if ( _states[product].load ( std::memory_order_relaxed ) == kReady )
+            {
+                ( isWaiting ? counters.Waits : counters.Hits ).fetch_add ( 1, std::memory_order_relaxed );
+                return;
+            }
+
+            _states[product].store ( kComputing, std::memory_order_relaxed );
+        }
+
+        auto start = std::chrono::steady_clock::now ( );
+        try
+        {
+            compute ( );
+        } catch ( ... )
+        {
+            {
+                std::lock_guard<std::mutex> lock ( _mutex );
+                _states[product].store ( kEmpty, std::memory_order_relaxed );
+            }
+            _ready.notify_all ( );
+            throw;
+        }
+
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+        counters.Computed.fetch_add ( 1, std::memory_order_relaxed );
+        counters.ComputeMicros.fetch_add ( (uint64_t)micros, std::memory_order_relaxed );
+
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            _states[product].store ( kReady, std::memory_order_release );
+        }
+        _ready.notify_all ( );
+    }
+
+    const GrayPlane& DerivedCache::GetGray ( const Frame& frame )
+    {
+        return GetPyramidLevel ( frame, 0 );
+    }
+
+    const GrayPlane& DerivedCache::GetPyramidLevel ( const Frame& frame, size_t level )
+    {
+        level = std::min ( level, kMaxPyramidLevels - 1 );
+        if ( level == 0 )
+        {
+            Ensure ( kPyramid, [&] { BuildGray ( frame, _pyramid[0] ); } );
+        } else
+        {
+            // The level above is made ready first rather than from inside this one's computation,
+            // so a thread is never holding one product while it waits on another
+            if ( !IsReady ( kPyramid + level ) ) GetPyramidLevel ( frame, level - 1 );
+            Ensure ( kPyramid + level, [&] { BuildLevel ( _pyramid[level - 1], _pyramid[level] ); } );
+        }
+
+        return _pyramid[level];
+    }
+
+    const IntegralImage& DerivedCache::GetIntegral ( const Frame& frame )
+    {
+        if ( !IsReady ( kIntegral ) ) GetGray ( frame );
+        Ensure ( kIntegral, [&] { BuildIntegral ( _pyramid[0], _integral ); } );
+        return _integral;
+    }
+
+    const LumaHistogram& DerivedCache::GetHistogram ( const Frame& frame )
+    {
+        if ( !IsReady ( kHistogram ) ) GetGray ( frame );
+        Ensure ( kHistogram, [&] { BuildHistogram ( _pyramid[0], _histogram ); } );
+        return _histogram;
+    }
+
+    DerivedCache& Frame::GetDerived ( ) const
+    {
+        auto cache = std::atomic_load ( &_derived );
+        if ( !cache )
+        {
+            auto created = std::make_shared<DerivedCache> ( );
+            if ( std::atomic_compare_exchange_strong ( &_derived, &cache, created ) ) cache = created;
+        }
+
+        // The frame holds a reference, so this outlives the caller's use of it
+        return *cache;
+    }
+
+    void Frame::ResetDerived ( )
+    {
+        std::atomic_store ( &_derived, std::shared_ptr<DerivedCache> ( ) );
+    }
+
+    const GrayPlane& Frame::GetGray ( ) const { return GetDerived ( ).GetGray ( *this ); }
+    const GrayPlane& Frame::GetPyramidLevel ( size_t level ) const { return GetDerived ( ).GetPyramidLevel ( *this, level ); }
+    const IntegralImage& Frame::GetIntegral ( ) const { return GetDerived ( ).GetIntegral ( *this ); }
+    const LumaHistogram& Frame::GetHistogram ( ) const { return GetDerived ( ).GetHistogram ( *this ); }
+}
@@ -0,0 +1,116 @@
+//
+//  AX-VideoCaptureDerived.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+#include <condition_variable>
+
+namespace AX::Video
+{
+    // Products the Frame::GetGray, GetPyramidLevel, GetIntegral and GetHistogram accessors
+    // compute on first request. Each is empty (zero size) for frames it can't be derived from.
+
+    // 8 bit luma, tightly packed
+    struct GrayPlane
+    {
+        std::vector<uint8_t>    Pixels;
+        Vec2i                   Size;
+
+        const uint8_t*          GetRow ( int32_t y ) const { return Pixels.data ( ) + (size_t)y * (size_t)Size.x; }
+    };
+
+    // Summed area table of the gray plane, (Size.x + 1) x (Size.y + 1) with a zero first row and
+    // column. The sums wrap on very large frames, but Sum stays exact for any rectangle of up
+    // to 16M pixels.
+    struct IntegralImage
+    {
+        std::vector<uint32_t>   Sums;
+        Vec2i                   Size;           // Of the plane it sums
+
+        // Of the pixels in [x0, x1) x [y0, y1)
+        uint32_t                Sum ( int32_t x0, int32_t y0, int32_t x1, int32_t y1 ) const
+        {
+            const size_t stride = (size_t)Size.x + 1;
+            return Sums[y1 * stride + x1] - Sums[y0 * stride + x1] - Sums[y1 * stride + x0] + Sums[y0 * stride + x0];
+        }
+    };
+
+    // Of the gray plane
+    struct LumaHistogram
+    {
+        std::array<uint32_t, 256> Bins{ };
+        uint32_t                Count{ 0 };
+        double                  Mean{ 0.0 };
+
+        // The level below which fraction (0 .. 1) of the pixels fall
+        uint8_t                 Percentile ( double fraction ) const;
+    };
+
+    // Across every frame, since the last ResetDerivedStats
+    struct DerivedStats
+    {
+        uint64_t                Hits{ 0 };      // Served from the cache
+        uint64_t                Waits{ 0 };     // Served from the cache after waiting for another thread to compute it
+        uint64_t                Computed{ 0 };
+        double                  ComputeMs{ 0.0 };
+    };
+
+    DerivedStats GetDerivedStats ( );
+    void ResetDerivedStats ( );
+
+    // A frame's derived products. The first thread to ask for one computes it outside the lock,
+    // anyone asking meanwhile waits for that rather than repeating the work, and from then on
+    // it's a single atomic load. Pyramid levels are built from the one above, so asking for
+    // level 3 computes (and caches) 1 and 2 along the way.
+    class DerivedCache
+    {
+    public:
+
+        static constexpr size_t kMaxPyramidLevels = 8;
+
+        DerivedCache                ( ) { };
+
+        // frame is the one that owns the cache
+        const GrayPlane&            GetGray ( const Frame& frame );
+        const GrayPlane&            GetPyramidLevel ( const Frame& frame, size_t level );
+        const IntegralImage&        GetIntegral ( const Frame& frame );
+        const LumaHistogram&        GetHistogram ( const Frame& frame );
+
+    protected:
+
+        enum Product : size_t
+        {
+            kPyramid,                                   // kMaxPyramidLevels of them, 0 being gray
+            kIntegral = kPyramid + kMaxPyramidLevels,
+            kHistogram,
+            kNumProducts
+        };
+
+        enum State : uint8_t
+        {
+            kEmpty,
+            kComputing,
+            kReady
+        };
+
+        bool                        IsReady ( size_t product ) const { return _states[product].load ( std::memory_order_acquire ) == kReady; }
+        template <typename Fn>
+        void                        Ensure ( size_t product, Fn&& compute );
+
+        std::array<std::atomic<uint8_t>, kNumProducts> _states{ };
+        std::mutex                  _mutex;
+        std::condition_variable     _ready;
+
+        std::array<GrayPlane, kMaxPyramidLevels> _pyramid;
+        IntegralImage               _integral;
+        LumaHistogram               _histogram;
+    };
+}
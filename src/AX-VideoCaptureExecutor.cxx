@@ -0,0 +1,289 @@
+//
+//  AX-VideoCaptureExecutor.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::mutex  kExecutorMutex;
+        ExecutorRef kExecutor;
+
+        // Which worker (of which pool) the current thread is, so Submit from inside a task
+        // lands on the submitting worker's own deque
+        thread_local const void *   kCurrentPool{ nullptr };
+        thread_local size_t         kCurrentWorker{ 0 };
+
+        void AddAtomic ( std::atomic<double>& target, double value )
+        {
+            double expected = target.load ( std::memory_order_relaxed );
+            while ( !target.compare_exchange_weak ( expected, expected + value, std::memory_order_relaxed ) ) { }
+        }
+
+        void PinCurrentThread ( size_t core )
+        {
+#ifdef WIN32
+            SetThreadAffinityMask ( GetCurrentThread ( ), DWORD_PTR ( 1 ) << ( core % ( sizeof ( DWORD_PTR ) * 8 ) ) );
+#elif defined( __linux__ )
+            cpu_set_t set;
+            CPU_ZERO ( &set );
+            CPU_SET ( core % CPU_SETSIZE, &set );
+            pthread_setaffinity_np ( pthread_self ( ), sizeof ( set ), &set );
+#else
+            (void)core;
+#endif
+        }
+    }
+
+    ExecutorRef Executor::Get ( )
+    {
+        std::lock_guard<std::mutex> lock ( kExecutorMutex );
+        if ( !kExecutor ) kExecutor = std::make_shared<ThreadPoolExecutor> ( );
+        return kExecutor;
+    }
+
+    void Executor::Set ( const ExecutorRef& executor )
+    {
+        std::lock_guard<std::mutex> lock ( kExecutorMutex );
+        kExecutor = executor;
+    }
+
+    void Executor::ParallelFor ( size_t count, const std::function<void ( size_t index )>& fn, Priority priority )
+    {
+        const size_t numHelpers = std::min ( Concurrency ( ), count ) - ( count > 0 ? 1 : 0 );
+        if ( numHelpers == 0 )
+        {
+            for ( size_t i = 0; i < count; i++ ) fn ( i );
+            return;
+        }
+
+        struct Shared
+        {
+            std::atomic<size_t>         Next{ 0 };
+            size_t                      Count{ 0 };
+            size_t                      NumDone{ 0 };
+            std::mutex                  Mutex;
+            std::condition_variable     Done;
+            const std::function<void ( size_t )>* Fn{ nullptr };
+
+            void Drain ( )
+            {
+                size_t numDone = 0;
+                for ( size_t i = Next++; i < Count; i = Next++ )
+                {
+                    ( *Fn ) ( i );
+                    numDone++;
+                }
+
+                if ( numDone == 0 ) return;
+
+                std::lock_guard<std::mutex> lock ( Mutex );
+                NumDone += numDone;
+                if ( NumDone == Count ) Done.notify_all ( );
+            }
+        };
+
+        // Helpers that only get to run after everything's done (and this has returned) find
+        // nothing left to claim, so never touch fn
+        auto shared = std::make_shared<Shared> ( );
+        shared->Count = count;
+        shared->Fn = &fn;
+
+        for ( size_t i = 0; i < numHelpers; i++ ) Submit ( [shared] { shared->Drain ( ); }, priority );
+        shared->Drain ( );
+
+        std::unique_lock<std::mutex> lock ( shared->Mutex );
+        shared->Done.wait ( lock, [&] { return shared->NumDone == shared->Count; } );
+    }
+
+    FunctionExecutor::FunctionExecutor ( const SubmitFn& submit, size_t concurrency )
+        : _submit ( submit )
+        , _concurrency ( std::max<size_t> ( 1, concurrency ) )
+    {
+    }
+
+    void FunctionExecutor::Submit ( Task task, Priority priority )
+    {
+        _submit ( std::move ( task ), priority );
+    }
+
+    struct ThreadPoolExecutor::Entry
+    {
+        Task                Fn;
+        Priority            Level{ Priority::Normal };
+        Clock::time_point   Submitted;
+    };
+
+    struct ThreadPoolExecutor::Worker
+    {
+        std::mutex          Mutex;
+        std::deque<Entry>   Queues[(size_t)Priority::Count];
+    };
+
+    size_t ThreadPoolExecutor::Options::Threads ( ) const
+    {
+        if ( _threads > 0 ) return _threads;
+
+        // Leave room for the app's own render and capture threads
+        size_t hardware = std::thread::hardware_concurrency ( );
+        return std::clamp<size_t> ( hardware / 2, 2, 8 );
+    }
+
+    ThreadPoolExecutor::ThreadPoolExecutor ( const Options& options )
+        : _options ( options )
+    {
+        size_t count = _options.Threads ( );
+        for ( size_t i = 0; i < count; i++ ) _workers.push_back ( std::make_unique<Worker> ( ) );
+        for ( size_t i = 0; i < count; i++ ) _threads.emplace_back ( &ThreadPoolExecutor::Run, this, i );
+    }
+
+    ThreadPoolExecutor::~ThreadPoolExecutor ( )
+    {
+        {
+            std::lock_guard<std::mutex> lock ( _sleepMutex );
+            _running = false;
+        }
+
+        _wake.notify_all ( );
+        for ( auto& t : _threads ) t.join ( );
+    }
+
+    void ThreadPoolExecutor::Submit ( Task task, Priority priority )
+    {
+        size_t index = kCurrentPool == this ? kCurrentWorker : _nextWorker.fetch_add ( 1, std::memory_order_relaxed ) % _workers.size ( );
+        auto& worker = *_workers[index];
+
+        {
+            std::lock_guard<std::mutex> lock ( worker.Mutex );
+            worker.Queues[(size_t)priority].push_back ( { std::move ( task ), priority, Clock::now ( ) } );
+        }
+
+        _counters[(size_t)priority].Submitted.fetch_add ( 1, std::memory_order_relaxed );
+        _pending.fetch_add ( 1, std::memory_order_release );
+
+        {
+            // Taking the lock closes the gap between a worker seeing nothing pending and going to sleep
+            std::lock_guard<std::mutex> lock ( _sleepMutex );
+        }
+        _wake.notify_one ( );
+    }
+
+    bool ThreadPoolExecutor::TryPop ( size_t index, Entry& entry )
+    {
+        for ( size_t p = 0; p < (size_t)Priority::Count; p++ )
+        {
+            {
+                auto& own = *_workers[index];
+                std::unique_lock<std::mutex> lock ( own.Mutex );
+                auto& queue = own.Queues[p];
+                if ( !queue.empty ( ) )
+                {
+                    entry = std::move ( queue.back ( ) );
+                    queue.pop_back ( );
+                    lock.unlock ( );
+                    Execute ( entry, false );
+                    return true;
+                }
+            }
+
+            for ( size_t i = 1; i < _workers.size ( ); i++ )
+            {
+                auto& victim = *_workers[( index + i ) % _workers.size ( )];
+                std::unique_lock<std::mutex> lock ( victim.Mutex, std::try_to_lock );
+                if ( !lock.owns_lock ( ) ) continue;
+
+                auto& queue = victim.Queues[p];
+                if ( !queue.empty ( ) )
+                {
+                    entry = std::move ( queue.front ( ) );
+                    queue.pop_front ( );
+                    lock.unlock ( );
+                    Execute ( entry, true );
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPoolExecutor::Execute ( Entry& entry, bool stolen )
+    {
+        _pending.fetch_sub ( 1, std::memory_order_acq_rel );
+
+        auto& counters = _counters[(size_t)entry.Level];
+        double wait = std::chrono::duration<double> ( Clock::now ( ) - entry.Submitted ).count ( );
+        counters.Wait.Record ( wait );
+        AddAtomic ( counters.WaitSum, wait );
+        if ( stolen ) counters.Stolen.fetch_add ( 1, std::memory_order_relaxed );
+
+        entry.Fn ( );
+
+        counters.Executed.fetch_add ( 1, std::memory_order_relaxed );
+    }
+
+    void ThreadPoolExecutor::Run ( size_t index )
+    {
+        kCurrentPool = this;
+        kCurrentWorker = index;
+
+        if ( _options.PinToCores ( ) ) PinCurrentThread ( _options.FirstCore ( ) + index );
+
+        Entry entry;
+        while ( true )
+        {
+            if ( TryPop ( index, entry ) )
+            {
+                entry.Fn = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock ( _sleepMutex );
+            if ( !_running && _pending.load ( std::memory_order_acquire ) == 0 ) break;
+
+            // A task may be sitting in a deque we failed to try_lock, so never sleep for long
+            // on a non-zero pending count
+            _wake.wait_for ( lock, std::chrono::milliseconds ( 2 ), [&] { return !_running || _pending.load ( std::memory_order_acquire ) > 0; } );
+        }
+
+        kCurrentPool = nullptr;
+    }
+
+    Executor::QueueStats ThreadPoolExecutor::GetStats ( Priority priority ) const
+    {
+        auto& counters = _counters[(size_t)priority];
+
+        QueueStats stats;
+        stats.Submitted = counters.Submitted.load ( std::memory_order_relaxed );
+        stats.Executed = counters.Executed.load ( std::memory_order_relaxed );
+        stats.Stolen = counters.Stolen.load ( std::memory_order_relaxed );
+
+        uint64_t samples = counters.Wait.Count ( );
+        if ( samples > 0 )
+        {
+            stats.MeanWaitMs = counters.WaitSum.load ( std::memory_order_relaxed ) / (double)samples * 1000.0;
+            stats.P95WaitMs = counters.Wait.Percentile ( 0.95 ) * 1000.0;
+            stats.P99WaitMs = counters.Wait.Percentile ( 0.99 ) * 1000.0;
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,145 @@
+//
+//  AX-VideoCaptureExecutor.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureStats.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace AX::Video
+{
+    using ExecutorRef = std::shared_ptr<class Executor>;
+
+    // The one place all of the library's background work runs, shared by every Capture so
+    // thread counts don't grow with the number of cameras. Hosts with their own pool can
+    // install it with Executor::Set() before creating any captures.
+    class Executor
+    {
+    public:
+
+        using Task = std::function<void ( )>;
+
+        // Lower runs first. Frame work is latency critical, Background is I/O that can wait.
+        enum class Priority
+        {
+            Frame,
+            Normal,
+            Background,
+            Count
+        };
+
+        struct QueueStats
+        {
+            uint64_t    Submitted{ 0 };
+            uint64_t    Executed{ 0 };
+            uint64_t    Stolen{ 0 };
+            double      MeanWaitMs{ 0.0 };  // Time from Submit to starting to run
+            double      P95WaitMs{ 0.0 };
+            double      P99WaitMs{ 0.0 };
+        };
+
+        static ExecutorRef      Get ( );
+        static void             Set ( const ExecutorRef& executor );
+
+        virtual                 ~Executor ( ) { };
+
+        virtual void            Submit ( Task task, Priority priority = Priority::Normal ) = 0;
+        virtual size_t          Concurrency ( ) const = 0;
+        virtual QueueStats      GetStats ( Priority ) const { return { }; }  // Executors that don't track their queues report nothing
+
+        // Calls fn ( 0 ) .. fn ( count - 1 ) across the pool and returns once they've all run.
+        // The calling thread takes indices too, so a busy pool slows this down rather than
+        // stalling it, and it's safe to call from inside a task.
+        void                    ParallelFor ( size_t count, const std::function<void ( size_t index )>& fn, Priority priority = Priority::Frame );
+    };
+
+    // Adapts a host supplied pool (or anything else that can run a function) to an Executor
+    class FunctionExecutor : public Executor
+    {
+    public:
+
+        using SubmitFn = std::function<void ( Task task, Priority priority )>;
+
+        FunctionExecutor        ( const SubmitFn& submit, size_t concurrency );
+
+        void                    Submit ( Task task, Priority priority = Priority::Normal ) override;
+        size_t                  Concurrency ( ) const override { return _concurrency; }
+
+    protected:
+
+        SubmitFn                _submit;
+        size_t                  _concurrency{ 1 };
+    };
+
+    // Work stealing pool, one set of priority deques per worker. Workers pop their own
+    // newest work first and steal the oldest work from others, always draining the highest
+    // priority class available anywhere before looking at the next one.
+    class ThreadPoolExecutor : public Executor
+    {
+    public:
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& Threads ( size_t count ) { _threads = count; return *this; }
+            Options& PinToCores ( bool pin, size_t firstCore = 0 ) { _pinToCores = pin; _firstCore = firstCore; return *this; }
+
+            size_t  Threads ( ) const;
+            bool    PinToCores ( ) const { return _pinToCores; }
+            size_t  FirstCore ( ) const { return _firstCore; }
+
+        protected:
+
+            size_t  _threads{ 0 };  // 0 picks from the hardware
+            bool    _pinToCores{ false };
+            size_t  _firstCore{ 0 };
+        };
+
+        ThreadPoolExecutor      ( const Options& options = Options ( ) );
+        ~ThreadPoolExecutor     ( );
+
+        void                    Submit ( Task task, Priority priority = Priority::Normal ) override;
+        size_t                  Concurrency ( ) const override { return _workers.size ( ); }
+        QueueStats              GetStats ( Priority priority ) const override;
+
+    protected:
+
+        struct Worker;
+        struct Entry;
+
+        void                    Run ( size_t index );
+        bool                    TryPop ( size_t index, Entry& entry );
+        void                    Execute ( Entry& entry, bool stolen );
+
+        struct Counters
+        {
+            std::atomic<uint64_t>   Submitted{ 0 };
+            std::atomic<uint64_t>   Executed{ 0 };
+            std::atomic<uint64_t>   Stolen{ 0 };
+            std::atomic<double>     WaitSum{ 0.0 };
+            DurationHistogram       Wait;
+        };
+
+        Options                                 _options;
+        std::vector<std::unique_ptr<Worker>>    _workers;
+        std::vector<std::thread>                _threads;
+        Counters                                _counters[(size_t)Priority::Count];
+
+        std::atomic<size_t>                     _pending{ 0 };
+        std::atomic<size_t>                     _nextWorker{ 0 };
+        std::atomic_bool                        _running{ true };
+        std::mutex                              _sleepMutex;
+        std::condition_variable                 _wake;
+    };
+}
@@ -0,0 +1,429 @@
+//
+//  AX-VideoCaptureFlicker.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureFlicker.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kLightHz[] = { 100.0, 120.0 };
+        constexpr double kMinReadout = 0.5;         // Of the frame interval, sensors rarely read out faster
+        constexpr double kReadoutStep = 0.05;
+        constexpr double kMinBrightness = 8.0;      // Too dark to see bands in below this
+        constexpr double kStationary = 0.05;        // Cycles of phase step per frame treated as standing still
+        constexpr size_t kMotionRows = 16;          // Block height noise is averaged down over when looking for scene motion
+
+        // Sums B + G + R of the first 4 pixels of every 64 bytes, so reads one cache line in four
+        constexpr size_t kChunkBytes = 64;
+        constexpr size_t kSampleBytes = 16;
+
+        // X ( omega ) = sum x[n] e^-i omega n, one Goertzel pass
+        std::complex<double> Dft ( const std::vector<double>& x, double omega )
+        {
+            const double c = 2.0 * std::cos ( omega );
+            double s1 = 0.0, s2 = 0.0;
+            for ( double v : x )
+            {
+                double s0 = v + c * s1 - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+
+            std::complex<double> y ( s1 - s2 * std::cos ( omega ), s2 * std::sin ( omega ) );
+            return y * std::polar ( 1.0, -omega * (double)( x.size ( ) - 1 ) );
+        }
+
+        // Takes out the mean and slope, so gradients across the picture don't leak into the bands
+        double Detrend ( std::vector<double>& x )
+        {
+            const double n = (double)x.size ( );
+            const double middle = ( n - 1.0 ) * 0.5;
+            double sum = 0.0, moment = 0.0, spread = 0.0;
+            for ( size_t i = 0; i < x.size ( ); i++ )
+            {
+                double d = (double)i - middle;
+                sum += x[i];
+                moment += d * x[i];
+                spread += d * d;
+            }
+
+            const double mean = sum / n;
+            const double slope = spread > 0.0 ? moment / spread : 0.0;
+            double energy = 0.0;
+            for ( size_t i = 0; i < x.size ( ); i++ )
+            {
+                x[i] -= mean + slope * ( (double)i - middle );
+                energy += x[i] * x[i];
+            }
+
+            return energy;
+        }
+
+        // Energy per row of whatever in x spans several rows, with the row to row noise taken
+        // out: block means keep all of the former but only 1 / kMotionRows of the latter
+        double StructuredEnergy ( const std::vector<double>& x )
+        {
+            const size_t blocks = x.size ( ) / kMotionRows;
+            if ( blocks == 0 ) return 0.0;
+
+            double energy = 0.0, blockEnergy = 0.0;
+            for ( size_t b = 0; b < blocks; b++ )
+            {
+                double sum = 0.0;
+                for ( size_t i = b * kMotionRows; i < ( b + 1 ) * kMotionRows; i++ )
+                {
+                    sum += x[i];
+                    energy += x[i] * x[i];
+                }
+
+                const double mean = sum / (double)kMotionRows;
+                blockEnergy += mean * mean;
+            }
+
+            const double rows = (double)( blocks * kMotionRows );
+            const double k = (double)kMotionRows;
+            return std::max ( 0.0, ( k * blockEnergy / (double)blocks - energy / rows ) / ( k - 1.0 ) );
+        }
+
+        // Distance of the phase step from a whole number of cycles
+        double Drift ( double cycles )
+        {
+            return std::abs ( cycles - std::round ( cycles ) );
+        }
+    }
+
+    const char * ToString ( PowerLineFrequency frequency )
+    {
+        switch ( frequency )
+        {
+            case PowerLineFrequency::Unknown:   return "Unknown";
+            case PowerLineFrequency::Hz50:      return "50Hz";
+            case PowerLineFrequency::Hz60:      return "60Hz";
+            default: return "Unknown";
+        }
+    }
+
+    int32_t ToControlValue ( PowerLineFrequency frequency )
+    {
+        // KSPROPERTY_VIDEOPROCAMP_POWERLINE_FREQUENCY: 0 disabled, 1 50Hz, 2 60Hz
+        switch ( frequency )
+        {
+            case PowerLineFrequency::Hz50:      return 1;
+            case PowerLineFrequency::Hz60:      return 2;
+            default: return 0;
+        }
+    }
+
+    int32_t FlickerFreeExposure ( PowerLineFrequency frequency, int32_t current, int32_t min, int32_t max, double frameInterval )
+    {
+        if ( frequency == PowerLineFrequency::Unknown ) return current;
+
+        const double halfCycle = frequency == PowerLineFrequency::Hz50 ? 1.0 / 100.0 : 1.0 / 120.0;
+        int32_t best = current;
+        int32_t bestDistance = std::numeric_limits<int32_t>::max ( );
+
+        for ( int32_t value = std::max ( min, -16 ); value <= std::min ( max, 8 ); value++ )
+        {
+            const double seconds = std::ldexp ( 1.0, value );
+            if ( frameInterval > 0.0 && seconds > frameInterval ) continue;
+
+            // Whatever's left over past whole half cycles still bands, relative to the total
+            const double cycles = seconds / halfCycle;
+            if ( cycles < 1.0 || Drift ( cycles ) / cycles > 0.05 ) continue;
+
+            int32_t distance = std::abs ( value - current );
+            if ( distance < bestDistance )
+            {
+                best = value;
+                bestDistance = distance;
+            }
+        }
+
+        return best;
+    }
+
+    void FlickerDetector::RowMeans ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size )
+    {
+        const size_t chunks = (size_t)size.x * 4 / kChunkBytes;
+        const double scale = 1.0 / ( (double)chunks * ( kSampleBytes / 4 ) * 3.0 );
+
+        for ( int32_t y = 0; y < size.y; y++ )
+        {
+            const uint8_t* row = src + srcRowBytes * (ptrdiff_t)y;
+            uint64_t sum = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            const __m128i colour = _mm_set1_epi32 ( 0x00FFFFFF );
+            const __m128i zero = _mm_setzero_si128 ( );
+            __m128i total = zero;
+            for ( size_t c = 0; c < chunks; c++ )
+            {
+                __m128i pixels = _mm_and_si128 ( _mm_loadu_si128 ( (const __m128i*)( row + c * kChunkBytes ) ), colour );
+                total = _mm_add_epi64 ( total, _mm_sad_epu8 ( pixels, zero ) );
+            }
+
+            alignas ( 16 ) uint64_t halves[2];
+            _mm_store_si128 ( (__m128i*)halves, total );
+            sum = halves[0] + halves[1];
+#else
+            for ( size_t c = 0; c < chunks; c++ )
+            {
+                const uint8_t* p = row + c * kChunkBytes;
+                for ( size_t i = 0; i < kSampleBytes; i += 4 ) sum += p[i] + p[i + 1] + p[i + 2];
+            }
+#endif
+            _rows[y] = (double)sum * scale;
+        }
+    }
+
+    void FlickerDetector::Accumulate ( Evidence& evidence, const std::vector<double>& signal, double omega, double phase, double energy, double decay, bool isPair )
+    {
+        Complex x = Dft ( signal, omega );
+
+        if ( isPair && std::abs ( evidence.Last ) > 0.0 )
+        {
+            // Bands' phase moves by the light's cycles between the two frames, so the expected
+            // step comes out and real bands add up while everything else averages away
+            Complex pair = x * std::conj ( evidence.Last );
+            Complex step = std::polar ( 1.0, -phase );
+            const double n = (double)signal.size ( );
+            const double amplitude = 2.0 * std::abs ( x ) / n;
+
+            evidence.Coherent = evidence.Coherent * decay + std::real ( pair * step );
+            evidence.Reversed = evidence.Reversed * decay + std::real ( pair * std::conj ( step ) );
+            evidence.Magnitude = evidence.Magnitude * decay + std::abs ( x ) * std::abs ( evidence.Last );
+            evidence.Power = evidence.Power * decay + ( energy > 0.0 ? std::min ( 1.0, amplitude * amplitude * n * 0.5 / energy ) : 0.0 );
+            evidence.Amplitude = evidence.Amplitude * decay + amplitude * amplitude;
+            evidence.Weight = evidence.Weight * decay + 1.0;
+        }
+
+        evidence.Last = x;
+    }
+
+    bool FlickerDetector::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size, double timestamp )
+    {
+        if ( !src || !_options.IsEnabled ( ) || size.x < 16 || size.y < 16 ) return false;
+
+        if ( size != _size || _hypotheses.empty ( ) )
+        {
+            // A new size changes every spatial frequency, but the frequency found still holds
+            auto result = _result;
+            Reset ( );
+            _result.Frequency = result.Frequency;
+
+            _size = size;
+            _rows.resize ( (size_t)size.y );
+            _profile.resize ( (size_t)size.y );
+            _change.resize ( (size_t)size.y );
+            _still.resize ( (size_t)size.y );
+
+            for ( double hz : kLightHz )
+            {
+                for ( double readout = kMinReadout; readout <= 1.0 + 1e-9; readout += kReadoutStep )
+                {
+                    Hypothesis h;
+                    h.Hz = hz;
+                    h.Readout = readout;
+                    _hypotheses.push_back ( h );
+                }
+            }
+        }
+
+        RowMeans ( src, srcRowBytes, size );
+
+        double mean = 0.0;
+        for ( double r : _rows ) mean += r;
+        mean /= (double)_rows.size ( );
+
+        if ( mean < kMinBrightness )
+        {
+            _background.clear ( );
+            _lastTimestamp = -1.0;
+            return false;
+        }
+
+        // A step much longer than usual (a stall, the stream restarting) can't be trusted to
+        // carry the bands' phase across, so only starts a new pair
+        double step = _lastTimestamp >= 0.0 ? timestamp - _lastTimestamp : 0.0;
+        bool isPair = step > 0.0 && ( _interval <= 0.0 || step < _interval * 4.0 );
+        if ( isPair )
+        {
+            if ( _interval <= 0.0 || step < _interval * 0.75 ) _interval = step;
+            else if ( step < _interval * 1.5 ) _interval += ( step - _interval ) * 0.1;
+        }
+        _lastTimestamp = timestamp;
+
+        // Sensors expose on a steady clock, it's the timestamps that jitter (by a millisecond or
+        // so off USB, a tenth of a 100Hz cycle), so steps are taken as whole frame intervals
+        if ( isPair ) step = std::max ( 1.0, std::round ( step / _interval ) ) * _interval;
+
+        for ( size_t y = 0; y < _rows.size ( ); y++ ) _profile[y] = _rows[y] / mean - 1.0;
+        const double profileEnergy = Detrend ( _profile );
+
+        // Dividing by a running average of past frames cancels whatever in the scene stayed
+        // put, and moving bands average out of it. Against the previous frame alone, noise
+        // would come out of the difference correlated from one pair to the next.
+        const double decay = 1.0 - 1.0 / (double)std::max ( 2, _options.Frames ( ) );
+        const bool hasChange = _background.size ( ) == _rows.size ( );
+        double changeEnergy = 0.0;
+        if ( hasChange )
+        {
+            for ( size_t y = 0; y < _rows.size ( ); y++ ) _change[y] = _background[y] > 1.0 ? _rows[y] / _background[y] - 1.0 : 0.0;
+            changeEnergy = Detrend ( _change );
+            for ( size_t y = 0; y < _rows.size ( ); y++ ) _background[y] += ( _rows[y] - _background[y] ) * ( 1.0 - decay );
+
+            _motion = _motion * decay + StructuredEnergy ( _change );
+            _motionWeight = _motionWeight * decay + 1.0;
+        } else
+        {
+            _background = _rows;
+        }
+
+        // The background's own profile. Bands standing still stay in it while a moving scene
+        // blurs out of it.
+        double backgroundMean = 0.0;
+        for ( double r : _background ) backgroundMean += r;
+        backgroundMean /= (double)_background.size ( );
+        for ( size_t y = 0; y < _background.size ( ); y++ ) _still[y] = _background[y] / backgroundMean - 1.0;
+        const double stillEnergy = Detrend ( _still );
+
+        if ( _interval > 0.0 )
+        {
+            for ( auto& h : _hypotheses )
+            {
+                // Cycles per row: the light's frequency times the time between rows
+                const double omega = 2.0 * kPi * h.Hz * h.Readout * _interval / (double)size.y;
+                const double phase = 2.0 * kPi * h.Hz * step;
+                Accumulate ( h.Profile, _profile, omega, phase, profileEnergy, decay, isPair );
+                if ( hasChange ) Accumulate ( h.Change, _change, omega, phase, changeEnergy, decay, isPair );
+                Accumulate ( h.Still, _still, omega, phase, stillEnergy, decay, isPair );
+            }
+        }
+
+        if ( isPair ) _numPairs++;
+
+        auto previous = _result.Frequency;
+        Decide ( );
+        return _result.Frequency != previous;
+    }
+
+    void FlickerDetector::Decide ( )
+    {
+        _result.IsBanding = false;
+        if ( _numPairs < std::max ( 2, _options.Frames ( ) / 2 ) ) return;
+
+        const double minModulation = _options.MinModulation ( );
+
+        struct Best
+        {
+            double      Score{ -1.0 };
+            double      Modulation{ 0.0 };
+            double      Readout{ 0.0 };
+        };
+
+        // Bands that move between frames, from the change, which a static scene can't fake
+        Best moving[2];
+        bool isStationary[2];
+        for ( int i = 0; i < 2; i++ )
+        {
+            const double drift = Drift ( kLightHz[i] * _interval );
+            isStationary[i] = drift < kStationary;
+
+            for ( auto& h : _hypotheses )
+            {
+                const auto& e = h.Change;
+                if ( h.Hz != kLightHz[i] || e.Weight <= 0.0 || e.Magnitude <= 0.0 ) continue;
+
+                // Sensors reading out bottom up see the bands move the other way, slightly less likely
+                double coherence = std::max ( e.Coherent, e.Reversed * 0.9 ) / e.Magnitude;
+                double modulation = std::sqrt ( e.Amplitude / e.Weight );
+                if ( modulation >= minModulation && coherence > moving[i].Score )
+                {
+                    moving[i] = { coherence, modulation, h.Readout };
+                }
+            }
+        }
+
+        PowerLineFrequency found = PowerLineFrequency::Unknown;
+        Best winner;
+
+        for ( int i = 0; i < 2; i++ )
+        {
+            if ( isStationary[i] ) continue;
+            if ( moving[i].Score >= 0.6 && moving[i].Score - moving[1 - i].Score >= 0.3 )
+            {
+                found = i == 0 ? PowerLineFrequency::Hz50 : PowerLineFrequency::Hz60;
+                winner = moving[i];
+            }
+        }
+
+        // Otherwise bands standing still, for the one frequency that can. Those look just like
+        // stripes in a static scene, so it takes the scene moving (the change carrying structure
+        // beyond noise) while a clean sinusoid stays put in the background and in every frame,
+        // with the other frequency's moving bands too weak to call.
+        const double motion = _motionWeight > 0.0 ? std::sqrt ( _motion / _motionWeight ) : 0.0;
+        if ( found == PowerLineFrequency::Unknown && motion >= minModulation )
+        {
+            for ( int i = 0; i < 2; i++ )
+            {
+                if ( !isStationary[i] || isStationary[1 - i] || moving[1 - i].Score >= 0.5 ) continue;
+
+                for ( auto& h : _hypotheses )
+                {
+                    const auto& e = h.Profile;
+                    const auto& still = h.Still;
+                    if ( h.Hz != kLightHz[i] || h.Readout < 0.7 || e.Weight <= 0.0 || e.Magnitude <= 0.0 || still.Weight <= 0.0 ) continue;
+
+                    double coherence = std::max ( e.Coherent, e.Reversed ) / e.Magnitude;
+                    double modulation = std::sqrt ( still.Amplitude / still.Weight );
+                    double fit = still.Power / still.Weight;
+                    double score = coherence * fit;
+                    if ( coherence >= 0.7 && fit >= 0.5 && modulation >= minModulation && score > winner.Score )
+                    {
+                        found = i == 0 ? PowerLineFrequency::Hz50 : PowerLineFrequency::Hz60;
+                        winner = { score, modulation, h.Readout };
+                    }
+                }
+            }
+        }
+
+        if ( found == PowerLineFrequency::Unknown )
+        {
+            _result.Modulation = 0.0;
+            return;
+        }
+
+        _result.Frequency = found;
+        _result.IsBanding = true;
+        _result.Modulation = winner.Modulation;
+        _result.Confidence = std::clamp ( winner.Score, 0.0, 1.0 );
+        _result.Readout = winner.Readout;
+    }
+
+    void FlickerDetector::Reset ( )
+    {
+        _result = { };
+        _size = { };
+        _hypotheses.clear ( );
+        _background.clear ( );
+        _motion = _motionWeight = 0.0;
+        _interval = 0.0;
+        _lastTimestamp = -1.0;
+        _numPairs = 0;
+    }
+}
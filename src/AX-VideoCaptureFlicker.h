@@ -0,0 +1,143 @@
+//
+//  AX-VideoCaptureFlicker.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <complex>
+
+namespace AX::Video
+{
+    enum class PowerLineFrequency
+    {
+        Unknown,
+        Hz50,
+        Hz60
+    };
+
+    const char * ToString ( PowerLineFrequency frequency );
+
+    // The camera's power line frequency (anti-flicker) control value for frequency
+    int32_t ToControlValue ( PowerLineFrequency frequency );
+
+    // The exposure control value (log2 seconds) nearest current whose exposure covers a whole
+    // number of the light's half cycles, so every row sees the same amount of it. Longer than
+    // frameInterval is ruled out, and current comes back as is if nothing in min .. max fits.
+    int32_t FlickerFreeExposure ( PowerLineFrequency frequency, int32_t current, int32_t min, int32_t max, double frameInterval );
+
+    struct FlickerOptions
+    {
+        FlickerOptions ( ) { };
+        FlickerOptions ( bool enabled ) : _enabled ( enabled ) { };
+
+        FlickerOptions& Enabled ( bool enabled ) { _enabled = enabled; return *this; }
+        // Sets the camera's power line frequency control once flicker is found
+        FlickerOptions& AutoApply ( bool apply ) { _autoApply = apply; return *this; }
+        // Also moves the exposure control to a flicker free value. Takes exposure off auto on
+        // most cameras, so only for hosts that already drive exposure themselves.
+        FlickerOptions& AdjustExposure ( bool adjust ) { _adjustExposure = adjust; return *this; }
+        // Frames the evidence is averaged over, and the least seen before deciding
+        FlickerOptions& Frames ( int32_t frames ) { _frames = frames; return *this; }
+        // Faintest banding reported, as a fraction of the picture's brightness
+        FlickerOptions& MinModulation ( double modulation ) { _minModulation = modulation; return *this; }
+
+        bool                IsEnabled ( ) const { return _enabled; }
+        bool                AutoApply ( ) const { return _autoApply; }
+        bool                AdjustExposure ( ) const { return _adjustExposure; }
+        int32_t             Frames ( ) const { return _frames; }
+        double              MinModulation ( ) const { return _minModulation; }
+
+    protected:
+
+        bool                _enabled{ false };
+        bool                _autoApply{ true };
+        bool                _adjustExposure{ false };
+        int32_t             _frames{ 30 };
+        double              _minModulation{ 0.01 };
+    };
+
+    // Finds the banding a rolling shutter picks up under mains lighting, which flickers at
+    // twice the line frequency. Each frame is reduced to its per row brightness, once as is and
+    // once divided by a running average of past frames (which cancels a static scene), and
+    // single bin DFTs pick out the bands' spatial frequency for 100 and 120Hz across a range of
+    // sensor readout times. The light's frequency then shows in how far the bands' phase moves
+    // between frames, which doesn't depend on the readout. At frame rates where one frequency's
+    // bands stand still (30fps under 60Hz, 25fps under 50Hz) it's found from a sinusoid that
+    // stays put in the background while the scene moves. A static scene can't tell those bands
+    // from stripes, so there it reports nothing. Needs no device, so synthetic frames can be
+    // fed straight in.
+    class FlickerDetector
+    {
+    public:
+
+        struct Result
+        {
+            PowerLineFrequency  Frequency{ PowerLineFrequency::Unknown }; // Kept once found, the bands go once it's applied
+            bool                IsBanding{ false };     // Bands in the latest frames
+            double              Modulation{ 0.0 };      // Bands' amplitude, a fraction of brightness
+            double              Confidence{ 0.0 };      // 0 .. 1, phase coherence of the winning frequency
+            double              Readout{ 0.0 };         // Estimated sensor readout, a fraction of the frame interval
+        };
+
+        FlickerDetector             ( const FlickerOptions& options = { } ) : _options ( options ) { }
+
+        const FlickerOptions&       GetOptions ( ) const { return _options; }
+        const Result&               GetResult ( ) const { return _result; }
+
+        // src is size, 4 bytes per pixel, taken at timestamp (seconds). Returns true when the
+        // detected frequency changes.
+        bool                        Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size, double timestamp );
+        // Forgets everything, including the frequency found
+        void                        Reset ( );
+
+    protected:
+
+        using Complex = std::complex<double>;
+
+        // Running sums for one light frequency and readout time, decayed over Frames
+        struct Evidence
+        {
+            double                  Coherent{ 0.0 };    // Re ( X conj ( previous X ) ) after taking out the expected phase step
+            double                  Reversed{ 0.0 };    // The same for a sensor read out bottom up
+            double                  Magnitude{ 0.0 };   // |X| |previous X|
+            double                  Power{ 0.0 };       // Sinusoid's share of the signal's energy
+            double                  Amplitude{ 0.0 };   // Squared
+            double                  Weight{ 0.0 };      // Decayed count of frame pairs
+            Complex                 Last;
+        };
+
+        struct Hypothesis
+        {
+            double                  Hz{ 0.0 };          // The light's, twice the line frequency
+            double                  Readout{ 0.0 };
+            Evidence                Profile;            // Per row brightness
+            Evidence                Change;             // Per row ratio to the background
+            Evidence                Still;              // The background's per row brightness
+        };
+
+        void                        RowMeans ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size );
+        void                        Accumulate ( Evidence& evidence, const std::vector<double>& signal, double omega, double phase, double energy, double decay, bool isPair );
+        void                        Decide ( );
+
+        FlickerOptions              _options;
+        Result                      _result;
+        Vec2i                       _size;
+        std::vector<Hypothesis>     _hypotheses;
+        std::vector<double>         _rows;
+        std::vector<double>         _background;        // Running average of past frames' rows
+        std::vector<double>         _profile;
+        std::vector<double>         _change;
+        std::vector<double>         _still;
+        double                      _motion{ 0.0 };     // Decayed sum of the change's structured energy
+        double                      _motionWeight{ 0.0 };
+        double                      _interval{ 0.0 };   // Smoothed frame interval
+        double                      _lastTimestamp{ -1.0 };
+        int32_t                     _numPairs{ 0 };
+    };
+}
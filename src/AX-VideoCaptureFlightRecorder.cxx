@@ -0,0 +1,285 @@
+//
+//  AX-VideoCaptureFlightRecorder.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureFlightRecorder.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace AX::Video
+{
+    namespace
+    {
+        int64_t Now ( )
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::steady_clock::now ( ).time_since_epoch ( ) ).count ( );
+        }
+
+        uint32_t CurrentThreadID ( )
+        {
+            thread_local uint32_t kID = (uint32_t)std::hash<std::thread::id> ( ) ( std::this_thread::get_id ( ) );
+            return kID;
+        }
+
+        std::string EscapeJSON ( const std::string& value )
+        {
+            std::string result;
+            for ( char c : value )
+            {
+                switch ( c )
+                {
+                    case '\\':  result += "\\\\"; break;
+                    case '"':   result += "\\\""; break;
+                    case '\n':  result += "\\n"; break;
+                    default:
+                        if ( (unsigned char)c < 0x20 )
+                        {
+                            char escaped[8] = {};
+                            std::snprintf ( escaped, sizeof ( escaped ), "\\u%04x", (unsigned)c );
+                            result += escaped;
+                            break;
+                        }
+                        result += c;
+                }
+            }
+            return result;
+        }
+
+        template <typename T>
+        void WritePOD ( std::ostream& stream, const T& value )
+        {
+            stream.write ( (const char*)&value, sizeof ( T ) );
+        }
+    }
+
+    const char * ToString ( FlightEvent event )
+    {
+        switch ( event )
+        {
+            case FlightEvent::SampleArrived:    return "SampleArrived";
+            case FlightEvent::EngineEvent:      return "EngineEvent";
+            case FlightEvent::Error:            return "Error";
+            case FlightEvent::ControlWrite:     return "ControlWrite";
+            case FlightEvent::LeaseAcquired:    return "LeaseAcquired";
+            case FlightEvent::LeaseReleased:    return "LeaseReleased";
+            case FlightEvent::Started:          return "Started";
+            case FlightEvent::Stopped:          return "Stopped";
+            case FlightEvent::DeviceLost:       return "DeviceLost";
+            case FlightEvent::Marker:           return "Marker";
+            case FlightEvent::FormatChanged:    return "FormatChanged";
+            case FlightEvent::Throttled:        return "Throttled";
+            default: return "Unknown";
+        }
+    }
+
+    FlightRecorderRef FlightRecorder::Create ( size_t capacity )
+    {
+        return FlightRecorderRef ( new FlightRecorder ( capacity ) );
+    }
+
+    FlightRecorder::FlightRecorder ( size_t capacity )
+    {
+        size_t size = 64;
+        while ( size < capacity ) size <<= 1;
+
+        _slots = std::vector<Slot> ( size );
+        _mask = size - 1;
+    }
+
+    void FlightRecorder::Record ( FlightEvent type, int64_t a, int64_t b )
+    {
+        uint64_t index = _head.fetch_add ( 1, std::memory_order_relaxed );
+        auto& slot = _slots[index & _mask];
+
+        slot.Sequence.store ( index * 2 + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence ( std::memory_order_release );
+
+        slot.Time.store ( Now ( ), std::memory_order_relaxed );
+        slot.TypeAndThread.store ( ( (uint64_t)CurrentThreadID ( ) << 8 ) | (uint64_t)type, std::memory_order_relaxed );
+        slot.A.store ( a, std::memory_order_relaxed );
+        slot.B.store ( b, std::memory_order_relaxed );
+
+        slot.Sequence.store ( index * 2 + 2, std::memory_order_release );
+    }
+
+    void FlightRecorder::SetThumbnails ( size_t count, double interval, int32_t maxWidth )
+    {
+        std::lock_guard<std::mutex> lock ( _thumbnailMutex );
+        _thumbnails.clear ( );
+        _nextThumbnail = 0;
+        _thumbnailMaxWidth = std::max ( 1, maxWidth );
+        _thumbnailInterval.store ( (int64_t)( std::max ( 0.0, interval ) * 1.0e9 ) );
+        _nextThumbnailTime.store ( 0 );
+        _thumbnailCount.store ( count );
+    }
+
+    void FlightRecorder::OfferFrame ( const FrameRef& frame )
+    {
+        size_t count = _thumbnailCount.load ( std::memory_order_relaxed );
+        if ( count == 0 || !frame || frame->GetFormat ( ) != PixelFormat::RGB32 ) return;
+
+        int64_t now = Now ( );
+        int64_t due = _nextThumbnailTime.load ( std::memory_order_relaxed );
+        if ( now < due || !_nextThumbnailTime.compare_exchange_strong ( due, now + _thumbnailInterval.load ( std::memory_order_relaxed ) ) ) return;
+
+        // Never make the capture thread wait on a snapshot in progress, skip this one instead
+        std::unique_lock<std::mutex> lock ( _thumbnailMutex, std::try_to_lock );
+        if ( !lock.owns_lock ( ) ) return;
+
+        auto& plane = frame->GetPlane ( );
+        if ( !plane.Data || plane.Size.x <= 0 || plane.Size.y <= 0 ) return;
+
+        // Point sampled, it only needs to be recognisable
+        int32_t step = std::max ( 1, ( plane.Size.x + _thumbnailMaxWidth - 1 ) / _thumbnailMaxWidth );
+        Vec2i size { plane.Size.x / step, plane.Size.y / step };
+        if ( size.x <= 0 || size.y <= 0 ) return;
+
+        if ( _thumbnails.size ( ) < count ) _thumbnails.resize ( count );
+        auto& thumbnail = _thumbnails[_nextThumbnail % count];
+        _nextThumbnail++;
+
+        thumbnail.Time = frame->GetTimestamp ( );
+        thumbnail.Size = size;
+        thumbnail.Pixels.resize ( (size_t)size.x * (size_t)size.y * 4 );
+
+        uint32_t* dst = (uint32_t*)thumbnail.Pixels.data ( );
+        for ( int32_t y = 0; y < size.y; y++ )
+        {
+            auto src = (const uint32_t*)( plane.Data + plane.RowBytes * (ptrdiff_t)( y * step ) );
+            for ( int32_t x = 0; x < size.x; x++ ) *dst++ = src[x * step];
+        }
+    }
+
+    FlightRecorder::Snapshot FlightRecorder::TakeSnapshot ( const std::string& reason ) const
+    {
+        Snapshot snapshot;
+        snapshot.Reason = reason;
+        snapshot.Time = Now ( ) * 1.0e-9;
+
+        uint64_t head = _head.load ( std::memory_order_acquire );
+        uint64_t first = head > _slots.size ( ) ? head - _slots.size ( ) : 0;
+        snapshot.Records.reserve ( (size_t)( head - first ) );
+
+        for ( uint64_t index = first; index < head; index++ )
+        {
+            auto& slot = _slots[index & _mask];
+
+            // Skip anything still being written or already lapped by a newer event
+            uint64_t sequence = slot.Sequence.load ( std::memory_order_acquire );
+            if ( sequence != index * 2 + 2 ) continue;
+
+            FlightRecord record;
+            int64_t time = slot.Time.load ( std::memory_order_relaxed );
+            uint64_t typeAndThread = slot.TypeAndThread.load ( std::memory_order_relaxed );
+            record.A = slot.A.load ( std::memory_order_relaxed );
+            record.B = slot.B.load ( std::memory_order_relaxed );
+
+            std::atomic_thread_fence ( std::memory_order_acquire );
+            if ( slot.Sequence.load ( std::memory_order_relaxed ) != sequence ) continue;
+
+            record.Time = time * 1.0e-9;
+            record.Type = (FlightEvent)( typeAndThread & 0xFF );
+            record.ThreadID = (uint32_t)( typeAndThread >> 8 );
+            snapshot.Records.push_back ( record );
+        }
+
+        std::lock_guard<std::mutex> lock ( _thumbnailMutex );
+        size_t count = _thumbnails.size ( );
+        for ( size_t i = 0; i < count; i++ )
+        {
+            // _nextThumbnail is the oldest once the ring has filled
+            auto& thumbnail = _thumbnails[( _nextThumbnail + i ) % count];
+            if ( !thumbnail.Pixels.empty ( ) ) snapshot.Thumbnails.push_back ( thumbnail );
+        }
+
+        return snapshot;
+    }
+
+    bool FlightRecorder::WriteJSON ( const Snapshot& snapshot, const std::string& path )
+    {
+        std::vector<std::string> thumbnailPaths;
+        for ( size_t i = 0; i < snapshot.Thumbnails.size ( ); i++ )
+        {
+            auto& thumbnail = snapshot.Thumbnails[i];
+            std::string thumbnailPath = path + "." + std::to_string ( i ) + ".ppm";
+
+            std::ofstream stream ( thumbnailPath, std::ios::binary | std::ios::trunc );
+            if ( !stream ) continue;
+
+            stream << "P6\n" << thumbnail.Size.x << " " << thumbnail.Size.y << "\n255\n";
+            for ( size_t p = 0; p + 3 < thumbnail.Pixels.size ( ); p += 4 )
+            {
+                const char rgb[3] = { (char)thumbnail.Pixels[p + 2], (char)thumbnail.Pixels[p + 1], (char)thumbnail.Pixels[p + 0] };
+                stream.write ( rgb, 3 );
+            }
+
+            if ( stream ) thumbnailPaths.push_back ( thumbnailPath );
+        }
+
+        std::ofstream stream ( path, std::ios::trunc );
+        if ( !stream ) return false;
+
+        // The reason comes from the host, so it's streamed rather than put through a fixed buffer
+        char buffer[160] = {};
+        std::snprintf ( buffer, sizeof ( buffer ), "%.9f", snapshot.Time );
+        stream << "{\n  \"reason\": \"" << EscapeJSON ( snapshot.Reason ) << "\",\n  \"time\": " << buffer << ",\n  \"events\": [\n";
+
+        for ( size_t i = 0; i < snapshot.Records.size ( ); i++ )
+        {
+            auto& r = snapshot.Records[i];
+            std::snprintf ( buffer, sizeof ( buffer ), "    { \"t\": %.9f, \"type\": \"%s\", \"thread\": %u, \"a\": %lld, \"b\": %lld }%s\n",
+                            r.Time, ToString ( r.Type ), r.ThreadID, (long long)r.A, (long long)r.B, i + 1 < snapshot.Records.size ( ) ? "," : "" );
+            stream << buffer;
+        }
+
+        stream << "  ],\n  \"thumbnails\": [";
+        for ( size_t i = 0; i < thumbnailPaths.size ( ); i++ )
+        {
+            stream << ( i > 0 ? ", " : " " ) << "\"" << EscapeJSON ( thumbnailPaths[i] ) << "\"";
+        }
+        stream << " ]\n}\n";
+
+        return (bool)stream;
+    }
+
+    bool FlightRecorder::WriteBinary ( const Snapshot& snapshot, const std::string& path )
+    {
+        std::ofstream stream ( path, std::ios::binary | std::ios::trunc );
+        if ( !stream ) return false;
+
+        // "AXFR", version, then length prefixed sections. Little endian, as written.
+        stream.write ( "AXFR", 4 );
+        WritePOD ( stream, (uint32_t)1 );
+        WritePOD ( stream, snapshot.Time );
+        WritePOD ( stream, (uint32_t)snapshot.Reason.size ( ) );
+        stream.write ( snapshot.Reason.data ( ), (std::streamsize)snapshot.Reason.size ( ) );
+
+        WritePOD ( stream, (uint32_t)snapshot.Records.size ( ) );
+        for ( auto& r : snapshot.Records )
+        {
+            WritePOD ( stream, r.Time );
+            WritePOD ( stream, (uint32_t)r.Type );
+            WritePOD ( stream, r.ThreadID );
+            WritePOD ( stream, r.A );
+            WritePOD ( stream, r.B );
+        }
+
+        WritePOD ( stream, (uint32_t)snapshot.Thumbnails.size ( ) );
+        for ( auto& t : snapshot.Thumbnails )
+        {
+            WritePOD ( stream, t.Time );
+            WritePOD ( stream, t.Size.x );
+            WritePOD ( stream, t.Size.y );
+            stream.write ( (const char*)t.Pixels.data ( ), (std::streamsize)t.Pixels.size ( ) );
+        }
+
+        return (bool)stream;
+    }
+}
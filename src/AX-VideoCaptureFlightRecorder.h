@@ -0,0 +1,117 @@
+//
+//  AX-VideoCaptureFlightRecorder.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+#include <mutex>
+
+namespace AX::Video
+{
+    enum class FlightEvent : uint8_t
+    {
+        SampleArrived,  // A: frame sequence, B: bytes
+        EngineEvent,    // A: event GUID's Data1, B: status
+        Error,          // A: HRESULT / errno
+        ControlWrite,   // A: control key, B: value
+        LeaseAcquired,  // A: buffer index
+        LeaseReleased,  // A: buffer index
+        Started,
+        Stopped,
+        DeviceLost,
+        Marker,         // Whatever the host wants to see in the timeline
+        FormatChanged,  // A: width, B: height
+        Throttled       // A: 1 on occlusion, 0 on resuming
+    };
+
+    const char * ToString ( FlightEvent event );
+
+    struct FlightRecord
+    {
+        double          Time{ 0.0 };    // Seconds, steady clock
+        FlightEvent     Type{ FlightEvent::Marker };
+        uint32_t        ThreadID{ 0 };
+        int64_t         A{ 0 };
+        int64_t         B{ 0 };
+    };
+
+    // A downscaled copy of a recent frame, BGRA
+    struct FlightThumbnail
+    {
+        double                  Time{ 0.0 };
+        Vec2i                   Size;
+        std::vector<uint8_t>    Pixels;
+    };
+
+    using FlightRecorderRef = std::shared_ptr<class FlightRecorder>;
+
+    // Always-on ring of the last few thousand pipeline events, for working out what led up
+    // to a device loss or stall in the field. Record() is a fetch_add and a handful of
+    // relaxed stores, so it can sit on the frame path. Old events are overwritten, never
+    // waited on. Snapshots are taken on failure and written out on the side.
+    class FlightRecorder
+    {
+    public:
+
+        static constexpr size_t kDefaultCapacity = 4096;
+
+        struct Snapshot
+        {
+            std::string                     Reason;
+            double                          Time{ 0.0 };
+            std::vector<FlightRecord>       Records;    // Oldest first
+            std::vector<FlightThumbnail>    Thumbnails; // Oldest first
+        };
+
+        // Capacity is rounded up to a power of two
+        static FlightRecorderRef    Create ( size_t capacity = kDefaultCapacity );
+
+        void                        Record ( FlightEvent type, int64_t a = 0, int64_t b = 0 );
+
+        // Keep a thumbnail of at most one frame every interval, the last count of them.
+        // A count of 0 (the default) turns thumbnails off.
+        void                        SetThumbnails ( size_t count, double interval = 1.0, int32_t maxWidth = 160 );
+        // Capture thread. Only does work when a thumbnail is due.
+        void                        OfferFrame ( const FrameRef& frame );
+
+        Snapshot                    TakeSnapshot ( const std::string& reason ) const;
+        size_t                      GetCapacity ( ) const { return _slots.size ( ); }
+
+        // Thumbnails go alongside as <path>.<n>.ppm, and are listed in the JSON
+        static bool                 WriteJSON ( const Snapshot& snapshot, const std::string& path );
+        static bool                 WriteBinary ( const Snapshot& snapshot, const std::string& path );
+
+    protected:
+
+        FlightRecorder              ( size_t capacity );
+
+        // Per-slot seqlock, Sequence is odd while the slot is being written
+        struct Slot
+        {
+            std::atomic<uint64_t>   Sequence{ 0 };
+            std::atomic<int64_t>    Time{ 0 };
+            std::atomic<uint64_t>   TypeAndThread{ 0 };
+            std::atomic<int64_t>    A{ 0 };
+            std::atomic<int64_t>    B{ 0 };
+        };
+
+        std::vector<Slot>           _slots;
+        size_t                      _mask{ 0 };
+        std::atomic<uint64_t>       _head{ 0 };
+
+        mutable std::mutex          _thumbnailMutex;
+        std::vector<FlightThumbnail> _thumbnails;
+        size_t                      _nextThumbnail{ 0 };
+        std::atomic<size_t>         _thumbnailCount{ 0 };
+        std::atomic<int64_t>        _thumbnailInterval{ 0 };
+        std::atomic<int64_t>        _nextThumbnailTime{ 0 };
+        int32_t                     _thumbnailMaxWidth{ 160 };
+    };
+}
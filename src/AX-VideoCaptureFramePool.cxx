@@ -0,0 +1,131 @@
+//
+//  AX-VideoCaptureFramePool.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureFramePool.h"
+
+namespace AX::Video
+{
+    FramePoolRef FramePool::Create ( size_t maxFree )
+    {
+        return FramePoolRef ( new FramePool ( maxFree ) );
+    }
+
+    FramePool::FramePool ( size_t maxFree )
+        : _maxFree ( maxFree )
+    {
+    }
+
+    void FramePool::SetProvider ( const BufferProvider& provider )
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        _provider = provider ? std::make_shared<const BufferProvider> ( provider ) : nullptr;
+        _generation++;
+    }
+
+    FrameRef FramePool::AcquireFromProvider ( const Vec2i& size, PixelFormat format )
+    {
+        std::shared_ptr<const BufferProvider> provider;
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            provider = _provider;
+        }
+
+        if ( !provider ) return nullptr;
+
+        auto buffer = provider->Acquire ( size );
+        if ( !buffer.Data ) return nullptr;
+
+        if ( buffer.RowBytes < (ptrdiff_t)size.x * 4 )
+        {
+            // Too narrow to write into, hand it straight back
+            provider->Release ( buffer );
+            return nullptr;
+        }
+
+        // The storage keeps the provider alive, so Release can still be reached after the
+        // capture (and this pool) are gone
+        std::shared_ptr<void> storage ( buffer.Data, [provider, buffer] ( void* )
+        {
+            provider->Release ( buffer );
+        } );
+
+        auto frame = std::make_shared<Frame> ( format, size, std::move ( storage ) );
+        frame->AddPlane ( { buffer.Data, buffer.RowBytes, size } );
+        return frame;
+    }
+
+    FrameRef FramePool::Acquire ( const Vec2i& size, PixelFormat format )
+    {
+        if ( auto frame = AcquireFromProvider ( size, format ) ) return frame;
+
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            if ( _provider ) _fallbacks++;
+        }
+
+        const ptrdiff_t rowBytes = (ptrdiff_t)size.x * 4;
+        const size_t bytes = (size_t)rowBytes * (size_t)size.y;
+
+        Block block;
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            for ( auto it = _free.begin ( ); it != _free.end ( ); ++it )
+            {
+                if ( it->Size == bytes )
+                {
+                    block = std::move ( *it );
+                    _free.erase ( it );
+                    break;
+                }
+            }
+        }
+
+        if ( !block.Data )
+        {
+            block.Data.reset ( new uint8_t[bytes] );
+            block.Size = bytes;
+            _allocations++;
+            _bytes += bytes;
+        }
+
+        uint8_t* data = block.Data.get ( );
+        std::weak_ptr<FramePool> weak = shared_from_this ( );
+
+        // The frame doesn't own its pixels, the storage's deleter hands them back (or frees
+        // them if the pool has already gone away)
+        auto holder = std::make_shared<Block> ( std::move ( block ) );
+        std::shared_ptr<void> storage ( data, [weak, holder] ( void* )
+        {
+            if ( auto pool = weak.lock ( ) ) pool->Recycle ( std::move ( *holder ) );
+        } );
+
+        auto frame = std::make_shared<Frame> ( format, size, std::move ( storage ) );
+        frame->AddPlane ( { data, rowBytes, size } );
+        return frame;
+    }
+
+    void FramePool::Trim ( )
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        for ( auto& block : _free ) _bytes -= block.Size;
+        _free.clear ( );
+    }
+
+    void FramePool::Recycle ( Block block )
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        if ( _free.size ( ) < _maxFree )
+        {
+            _free.push_back ( std::move ( block ) );
+        } else
+        {
+            _bytes -= block.Size;
+        }
+    }
+}
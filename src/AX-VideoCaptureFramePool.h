@@ -0,0 +1,68 @@
+//
+//  AX-VideoCaptureFramePool.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+#include <mutex>
+
+namespace AX::Video
+{
+    using FramePoolRef = std::shared_ptr<class FramePool>;
+
+    // Recycles frame storage. A frame handed out by Acquire() returns its pixels to the
+    // pool when the last reference to it goes away, on whatever thread that happens, so
+    // consumers can hold on to frames without the capture thread reallocating every frame.
+    // With a BufferProvider set, storage comes from the host first and the pool's own blocks
+    // only cover the frames the provider can't.
+    class FramePool : public std::enable_shared_from_this<FramePool>
+    {
+    public:
+
+        static FramePoolRef     Create ( size_t maxFree = 4 );
+
+        // A single plane, 4 bytes per pixel frame
+        FrameRef                Acquire ( const Vec2i& size, PixelFormat format = PixelFormat::RGB32 );
+        size_t                  GetNumAllocations ( ) const { return _allocations.load ( ); }
+        // Pool owned storage currently allocated, in use or free. Provider buffers aren't counted.
+        size_t                  GetNumBytes ( ) const { return _bytes.load ( ); }
+
+        // Frees the idle blocks, e.g. once the stream has changed size and they'll never match again
+        void                    Trim ( );
+
+        void                    SetProvider ( const BufferProvider& provider );
+        // Bumped by every SetProvider, so holders of pooled frames can tell theirs are stale
+        uint32_t                GetGeneration ( ) const { return _generation.load ( ); }
+        size_t                  GetNumFallbacks ( ) const { return _fallbacks.load ( ); }
+
+    protected:
+
+        FramePool               ( size_t maxFree );
+
+        struct Block
+        {
+            std::unique_ptr<uint8_t[]>  Data;
+            size_t                      Size{ 0 };
+        };
+
+        void                    Recycle ( Block block );
+        FrameRef                AcquireFromProvider ( const Vec2i& size, PixelFormat format );
+
+        size_t                  _maxFree{ 4 };
+        std::mutex              _mutex;
+        std::vector<Block>      _free;
+        std::atomic<size_t>     _allocations{ 0 };
+        std::atomic<size_t>     _bytes{ 0 };
+
+        std::shared_ptr<const BufferProvider> _provider;
+        std::atomic<uint32_t>   _generation{ 0 };
+        std::atomic<size_t>     _fallbacks{ 0 };
+    };
+}
@@ -0,0 +1,359 @@
+//
+//  AX-VideoCaptureLog.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureLog.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstring>
+#include <map>
+#include <thread>
+
+namespace AX::Video
+{
+    std::atomic_int Log::kLevel{ (int)LogLevel::Info };
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        int64_t Now ( )
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds> ( Clock::now ( ).time_since_epoch ( ) ).count ( );
+        }
+
+        struct Entry
+        {
+            LogLevel        Level{ LogLevel::Info };
+            int64_t         Time{ 0 };
+            const char *    File{ nullptr };
+            int             Line{ 0 };
+            bool            HasCode{ false };
+            int64_t         Code{ 0 };
+            ErrorDescriber  Describer{ nullptr };
+            uint64_t        Suppressed{ 0 };
+            char            Text[Log::kMaxMessage];
+        };
+
+        // Single producer (the owning thread), single consumer (the drain thread)
+        struct Ring
+        {
+            std::array<Entry, Log::kRingSize>   Entries;
+            std::atomic<size_t>                 Head{ 0 };
+            std::atomic<size_t>                 Tail{ 0 };
+            uint64_t                            ThreadID{ 0 };
+            std::atomic_bool                    IsOrphaned{ false };
+
+            Entry* Reserve ( )
+            {
+                size_t head = Head.load ( std::memory_order_relaxed );
+                if ( head - Tail.load ( std::memory_order_acquire ) >= Log::kRingSize ) return nullptr;
+                return &Entries[head % Log::kRingSize];
+            }
+
+            void Publish ( )
+            {
+                Head.store ( Head.load ( std::memory_order_relaxed ) + 1, std::memory_order_release );
+            }
+
+            bool Pop ( Entry& entry )
+            {
+                size_t tail = Tail.load ( std::memory_order_relaxed );
+                if ( tail == Head.load ( std::memory_order_acquire ) ) return false;
+                entry = Entries[tail % Log::kRingSize];
+                Tail.store ( tail + 1, std::memory_order_release );
+                return true;
+            }
+        };
+
+        void WriteToStderr ( const LogRecord& record )
+        {
+            std::fprintf ( stderr, "[AX-VideoCapture] %s: %s", ToString ( record.Level ), record.Message.c_str ( ) );
+            if ( record.HasCode ) std::fprintf ( stderr, " => %s", record.CodeText.c_str ( ) );
+            if ( record.Suppressed > 0 ) std::fprintf ( stderr, " (%llu similar suppressed)", (unsigned long long)record.Suppressed );
+            std::fprintf ( stderr, "\n" );
+        }
+
+        struct Logger
+        {
+            std::mutex                          RingsMutex;
+            std::vector<std::shared_ptr<Ring>>  Rings;
+
+            std::mutex                          SinkMutex;
+            Log::Sink                           Output{ WriteToStderr };
+
+            std::atomic<int64_t>                SiteInterval{ 1000000000 };
+            std::atomic<uint64_t>               Dropped{ 0 };
+            std::atomic<uint64_t>               Written{ 0 };
+            std::atomic<uint64_t>               Delivered{ 0 };
+
+            std::mutex                          WakeMutex;
+            std::condition_variable             Wake;
+            std::condition_variable             Drained;
+            bool                                IsRunning{ true };
+            std::thread                         Thread;
+
+            // Drain thread only
+            std::map<std::pair<ErrorDescriber, int64_t>, std::string> CodeCache;
+
+            Logger ( )
+            {
+                Thread = std::thread ( [=] { Run ( ); } );
+            }
+
+            ~Logger ( )
+            {
+                {
+                    std::lock_guard<std::mutex> lock ( WakeMutex );
+                    IsRunning = false;
+                }
+
+                Wake.notify_all ( );
+                if ( Thread.joinable ( ) ) Thread.join ( );
+            }
+
+            std::shared_ptr<Ring> CreateRing ( )
+            {
+                auto ring = std::make_shared<Ring> ( );
+                ring->ThreadID = std::hash<std::thread::id> ( ) ( std::this_thread::get_id ( ) );
+
+                std::lock_guard<std::mutex> lock ( RingsMutex );
+                Rings.push_back ( ring );
+                return ring;
+            }
+
+            const std::string& Describe ( ErrorDescriber describer, int64_t code )
+            {
+                auto key = std::make_pair ( describer, code );
+                auto it = CodeCache.find ( key );
+                if ( it == CodeCache.end ( ) )
+                {
+                    it = CodeCache.emplace ( key, describer ? describer ( code ) : std::to_string ( code ) ).first;
+                }
+
+                return it->second;
+            }
+
+            void Deliver ( const Ring& ring, const Entry& entry )
+            {
+                LogRecord record;
+                record.Level = entry.Level;
+                record.Time = entry.Time * 1.0e-9;
+                record.ThreadID = ring.ThreadID;
+                record.File = entry.File;
+                record.Line = entry.Line;
+                record.Message = entry.Text;
+                record.HasCode = entry.HasCode;
+                record.Code = entry.Code;
+                record.Suppressed = entry.Suppressed;
+                if ( entry.HasCode ) record.CodeText = Describe ( entry.Describer, entry.Code );
+
+                std::lock_guard<std::mutex> lock ( SinkMutex );
+                if ( Output ) Output ( record );
+            }
+
+            void DrainOnce ( )
+            {
+                std::vector<std::shared_ptr<Ring>> rings;
+                {
+                    std::lock_guard<std::mutex> lock ( RingsMutex );
+                    rings = Rings;
+                }
+
+                Entry entry;
+                for ( auto& ring : rings )
+                {
+                    while ( ring->Pop ( entry ) )
+                    {
+                        Deliver ( *ring, entry );
+                        Delivered.fetch_add ( 1, std::memory_order_release );
+                    }
+                }
+
+                // Rings whose thread has exited, and that have nothing left to say
+                std::lock_guard<std::mutex> lock ( RingsMutex );
+                Rings.erase ( std::remove_if ( Rings.begin ( ), Rings.end ( ), [] ( const auto& r )
+                {
+                    return r->IsOrphaned.load ( ) && r->Head.load ( ) == r->Tail.load ( );
+                } ), Rings.end ( ) );
+            }
+
+            void Run ( )
+            {
+                std::unique_lock<std::mutex> lock ( WakeMutex );
+                while ( true )
+                {
+                    // Writers never signal (that could block them), so poll
+                    Wake.wait_for ( lock, std::chrono::milliseconds ( 20 ) );
+                    bool running = IsRunning;
+
+                    lock.unlock ( );
+                    DrainOnce ( );
+                    lock.lock ( );
+
+                    Drained.notify_all ( );
+                    if ( !running ) break;
+                }
+            }
+        };
+
+        std::atomic_bool kIsShutDown{ false };
+
+        Logger& GetLogger ( )
+        {
+            static struct Holder
+            {
+                Logger Instance;
+                ~Holder ( ) { kIsShutDown = true; }
+            } kHolder;
+
+            return kHolder.Instance;
+        }
+
+        struct ThreadRing
+        {
+            std::shared_ptr<Ring> Instance;
+            ~ThreadRing ( ) { if ( Instance ) Instance->IsOrphaned = true; }
+        };
+
+        thread_local ThreadRing kThreadRing;
+
+        Ring& GetThreadRing ( )
+        {
+            if ( !kThreadRing.Instance ) kThreadRing.Instance = GetLogger ( ).CreateRing ( );
+            return *kThreadRing.Instance;
+        }
+
+        Entry* Begin ( LogSite& site, LogLevel level, uint64_t& suppressed )
+        {
+            if ( kIsShutDown ) return nullptr;
+            if ( !site.Allow ( suppressed ) ) return nullptr;
+
+            auto entry = GetThreadRing ( ).Reserve ( );
+            if ( !entry )
+            {
+                // Full ring, hand the count back to the site so the next line reports it
+                GetLogger ( ).Dropped.fetch_add ( 1, std::memory_order_relaxed );
+                site.Suppressed.fetch_add ( suppressed + 1, std::memory_order_relaxed );
+                return nullptr;
+            }
+
+            entry->Level = level;
+            entry->Time = Now ( );
+            entry->File = site.File;
+            entry->Line = site.Line;
+            entry->Suppressed = suppressed;
+            entry->HasCode = false;
+            return entry;
+        }
+
+        void End ( )
+        {
+            GetThreadRing ( ).Publish ( );
+            GetLogger ( ).Written.fetch_add ( 1, std::memory_order_release );
+        }
+    }
+
+    const char * ToString ( LogLevel level )
+    {
+        switch ( level )
+        {
+            case LogLevel::Verbose: return "Verbose";
+            case LogLevel::Info:    return "Info";
+            case LogLevel::Warning: return "Warning";
+            case LogLevel::Error:   return "Error";
+            default: return "Unknown";
+        }
+    }
+
+    bool LogSite::Allow ( uint64_t& suppressed )
+    {
+        int64_t interval = GetLogger ( ).SiteInterval.load ( std::memory_order_relaxed );
+        int64_t now = Now ( );
+        int64_t next = NextAllowed.load ( std::memory_order_relaxed );
+
+        if ( now < next || !NextAllowed.compare_exchange_strong ( next, now + interval, std::memory_order_relaxed ) )
+        {
+            Suppressed.fetch_add ( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        suppressed = Suppressed.exchange ( 0, std::memory_order_relaxed );
+        return true;
+    }
+
+    void Log::SetSink ( Sink sink )
+    {
+        auto& logger = GetLogger ( );
+        std::lock_guard<std::mutex> lock ( logger.SinkMutex );
+        logger.Output = std::move ( sink );
+    }
+
+    void Log::SetLevel ( LogLevel level )
+    {
+        kLevel.store ( (int)level );
+    }
+
+    LogLevel Log::GetLevel ( )
+    {
+        return (LogLevel)kLevel.load ( );
+    }
+
+    void Log::SetSiteInterval ( double seconds )
+    {
+        GetLogger ( ).SiteInterval.store ( (int64_t)( std::max ( 0.0, seconds ) * 1.0e9 ) );
+    }
+
+    void Log::Flush ( )
+    {
+        auto& logger = GetLogger ( );
+        uint64_t target = logger.Written.load ( std::memory_order_acquire );
+
+        std::unique_lock<std::mutex> lock ( logger.WakeMutex );
+        while ( logger.IsRunning && logger.Delivered.load ( std::memory_order_acquire ) < target )
+        {
+            logger.Wake.notify_all ( );
+            logger.Drained.wait_for ( lock, std::chrono::milliseconds ( 5 ) );
+        }
+    }
+
+    uint64_t Log::GetNumDropped ( )
+    {
+        return GetLogger ( ).Dropped.load ( );
+    }
+
+    void Log::Write ( LogSite& site, LogLevel level, const char* format, ... )
+    {
+        uint64_t suppressed = 0;
+        auto entry = Begin ( site, level, suppressed );
+        if ( !entry ) return;
+
+        va_list args;
+        va_start ( args, format );
+        std::vsnprintf ( entry->Text, sizeof ( entry->Text ), format, args );
+        va_end ( args );
+
+        End ( );
+    }
+
+    void Log::WriteCode ( LogSite& site, LogLevel level, const char* expression, int64_t code, ErrorDescriber describer )
+    {
+        uint64_t suppressed = 0;
+        auto entry = Begin ( site, level, suppressed );
+        if ( !entry ) return;
+
+        // The code's text is looked up (and cached) on the drain thread, not here
+        std::snprintf ( entry->Text, sizeof ( entry->Text ), "%s returned (0x%08llx)", expression, (unsigned long long)( code & 0xFFFFFFFFll ) );
+        entry->HasCode = true;
+        entry->Code = code;
+        entry->Describer = describer;
+
+        End ( );
+    }
+}
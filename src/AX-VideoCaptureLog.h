@@ -0,0 +1,93 @@
+//
+//  AX-VideoCaptureLog.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+
+namespace AX::Video
+{
+    enum class LogLevel
+    {
+        Verbose,
+        Info,
+        Warning,
+        Error
+    };
+
+    const char * ToString ( LogLevel level );
+
+    // Turns an error code (HRESULT, errno...) into text. Only ever called on the drain
+    // thread, and its results are cached per code.
+    using ErrorDescriber = std::string ( * ) ( int64_t code );
+
+    // One per logging call site (the AX_LOG macros make them), so a site that fires every
+    // frame gets collapsed into one line per interval with a count of what was dropped.
+    struct LogSite
+    {
+        LogSite ( const char* file, int line ) : File ( file ), Line ( line ) { }
+
+        // Call site thread. False means suppress, and counts it.
+        bool                    Allow ( uint64_t& suppressed );
+
+        const char *            File;
+        int                     Line;
+        std::atomic<int64_t>    NextAllowed{ 0 };
+        std::atomic<uint64_t>   Suppressed{ 0 };
+    };
+
+    struct LogRecord
+    {
+        LogLevel                Level{ LogLevel::Info };
+        double                  Time{ 0.0 };        // Seconds, steady clock
+        uint64_t                ThreadID{ 0 };
+        const char *            File{ nullptr };
+        int                     Line{ 0 };
+        std::string             Message;
+        bool                    HasCode{ false };
+        int64_t                 Code{ 0 };
+        std::string             CodeText;           // From the site's ErrorDescriber
+        uint64_t                Suppressed{ 0 };    // Records from this site dropped since the last one
+    };
+
+    // Callers write into a ring owned by their thread and never block, allocate (after the
+    // first record on a thread) or touch the console. A background thread drains the rings,
+    // resolves error text and hands records to the sink, which defaults to stderr.
+    class Log
+    {
+    public:
+
+        using Sink = std::function<void ( const LogRecord& record )>;
+
+        static constexpr size_t kRingSize       = 256;
+        static constexpr size_t kMaxMessage     = 200;
+
+        static void             SetSink ( Sink sink );
+        static void             SetLevel ( LogLevel level );
+        static LogLevel         GetLevel ( );
+        static void             SetSiteInterval ( double seconds );
+        static bool             IsEnabled ( LogLevel level ) { return (int)level >= kLevel.load ( std::memory_order_relaxed ); }
+
+        // Block until everything logged so far has reached the sink
+        static void             Flush ( );
+        // Records lost because a thread's ring was full
+        static uint64_t         GetNumDropped ( );
+
+        static void             Write ( LogSite& site, LogLevel level, const char* format, ... );
+        static void             WriteCode ( LogSite& site, LogLevel level, const char* expression, int64_t code, ErrorDescriber describer );
+
+    protected:
+
+        static std::atomic_int  kLevel;
+    };
+}
+
+#define AX_LOG(level, ...) do { if ( AX::Video::Log::IsEnabled ( level ) ) { static AX::Video::LogSite kAXLogSite{ __FILE__, __LINE__ }; AX::Video::Log::Write ( kAXLogSite, level, __VA_ARGS__ ); } } while ( 0 )
+#define AX_LOG_CODE(level, expression, code, describer) do { if ( AX::Video::Log::IsEnabled ( level ) ) { static AX::Video::LogSite kAXLogSite{ __FILE__, __LINE__ }; AX::Video::Log::WriteCode ( kAXLogSite, level, expression, (int64_t)( code ), describer ); } } while ( 0 )
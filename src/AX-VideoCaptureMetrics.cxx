@@ -0,0 +1,314 @@
+//
+//  AX-VideoCaptureMetrics.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+// winsock2 has to come before anything that pulls in windows.h
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <afunix.h>
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+#include "AX-VideoCaptureMetrics.h"
+#include "AX-VideoCaptureLog.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace AX::Video
+{
+    namespace
+    {
+        std::string EscapeLabel ( const std::string& value )
+        {
+            std::string result;
+            result.reserve ( value.size ( ) );
+            for ( char c : value )
+            {
+                switch ( c )
+                {
+                    case '\\':  result += "\\\\"; break;
+                    case '"':   result += "\\\""; break;
+                    case '\n':  result += "\\n"; break;
+                    default:    result += c; break;
+                }
+            }
+            return result;
+        }
+
+        std::string FormatCode ( int64_t code )
+        {
+            // HRESULTs read best in hex, errno values in decimal
+            char buffer[24] = {};
+            if ( code < 0 || code > 0xFFFF )
+            {
+                std::snprintf ( buffer, sizeof ( buffer ), "0x%08llX", (unsigned long long)( code & 0xFFFFFFFFll ) );
+            } else
+            {
+                std::snprintf ( buffer, sizeof ( buffer ), "%lld", (long long)code );
+            }
+            return buffer;
+        }
+
+        class TextWriter
+        {
+        public:
+
+            TextWriter ( MetricsExporter::Encoding encoding, const std::string& prefix )
+                : _encoding ( encoding ), _prefix ( prefix ) { }
+
+            // Counters' samples always end in _total, OpenMetrics leaves it off the family name
+            void Family ( const char * name, bool isCounter, const char * help )
+            {
+                _family = _prefix + "_" + name;
+                _sampleName = isCounter ? _family + "_total" : _family;
+
+                const auto& meta = isCounter && _encoding == MetricsExporter::Encoding::Prometheus ? _sampleName : _family;
+                _text += "# HELP " + meta + " " + help + "\n";
+                _text += "# TYPE " + meta + ( isCounter ? " counter\n" : " gauge\n" );
+            }
+
+            // Quantile samples go under the family name, then each capture's Suffix ( "_sum" ) and
+            // ( "_count" ) before the next capture's quantiles
+            void Summary ( const char * name, const char * help )
+            {
+                _family = _prefix + "_" + name;
+                _sampleName = _family;
+                _text += "# HELP " + _family + " " + help + "\n";
+                _text += "# TYPE " + _family + " summary\n";
+            }
+
+            void Suffix ( const char * suffix ) { _sampleName = _family + suffix; }
+
+            void Value ( const DeviceDescriptor* device, double value, const char * extraName = nullptr, const std::string& extraValue = { } )
+            {
+                _text += _sampleName;
+
+                if ( device || extraName )
+                {
+                    _text += "{";
+                    if ( device ) _text += "device=\"" + EscapeLabel ( device->Name ) + "\",id=\"" + EscapeLabel ( device->ID ) + "\"";
+                    if ( extraName ) _text += std::string ( device ? "," : "" ) + extraName + "=\"" + EscapeLabel ( extraValue ) + "\"";
+                    _text += "}";
+                }
+
+                char buffer[32] = {};
+                std::snprintf ( buffer, sizeof ( buffer ), " %.17g\n", value );
+                _text += buffer;
+            }
+
+            std::string Finish ( )
+            {
+                if ( _encoding == MetricsExporter::Encoding::OpenMetrics ) _text += "# EOF\n";
+                return std::move ( _text );
+            }
+
+        protected:
+
+            MetricsExporter::Encoding   _encoding;
+            std::string                 _prefix;
+            std::string                 _family;
+            std::string                 _sampleName;
+            std::string                 _text;
+        };
+    }
+
+    MetricsExporterRef MetricsExporter::Create ( const Options& options )
+    {
+        return MetricsExporterRef ( new MetricsExporter ( options ) );
+    }
+
+    MetricsExporter::MetricsExporter ( const Options& options )
+        : _options ( options )
+    {
+        if ( _options.Interval ( ) > 0.0 )
+        {
+            _thread = std::thread ( [=] { Run ( ); } );
+        }
+    }
+
+    MetricsExporter::~MetricsExporter ( )
+    {
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            _isRunning = false;
+        }
+
+        _wake.notify_all ( );
+        if ( _thread.joinable ( ) ) _thread.join ( );
+    }
+
+    void MetricsExporter::Run ( )
+    {
+        auto interval = std::chrono::duration<double> ( _options.Interval ( ) );
+
+        std::unique_lock<std::mutex> lock ( _mutex );
+        while ( !_wake.wait_for ( lock, interval, [=] { return !_isRunning; } ) )
+        {
+            lock.unlock ( );
+            ExportNow ( );
+            lock.lock ( );
+        }
+    }
+
+    std::vector<MetricsExporter::Sample> MetricsExporter::Collect ( )
+    {
+        std::vector<Sample> samples;
+        Capture::ForEachCapture ( [&] ( const Capture& capture )
+        {
+            samples.push_back ( { capture.GetDevice ( ), capture.GetStats ( ) } );
+        } );
+
+        return samples;
+    }
+
+    std::string MetricsExporter::Render ( const std::vector<Sample>& samples, Encoding encoding, const std::string& prefix )
+    {
+        TextWriter writer ( encoding, prefix );
+
+        writer.Family ( "captures", false, "Live captures" );
+        writer.Value ( nullptr, (double)samples.size ( ) );
+
+        auto each = [&] ( const char * name, bool isCounter, const char * help, auto value )
+        {
+            writer.Family ( name, isCounter, help );
+            for ( auto& sample : samples ) writer.Value ( &sample.Device, (double)value ( sample.Stats ) );
+        };
+
+        each ( "frames_delivered", true, "Frames delivered", [] ( const CaptureStats& s ) { return s.FramesDelivered; } );
+        each ( "frames_dropped", true, "Frames the device skipped or the capture lost", [] ( const CaptureStats& s ) { return s.FramesDropped; } );
+        each ( "bytes_delivered", true, "Bytes of frame data delivered", [] ( const CaptureStats& s ) { return s.BytesDelivered; } );
+        each ( "fps", false, "Measured frames per second", [] ( const CaptureStats& s ) { return s.FPS; } );
+        each ( "jitter_seconds", false, "Standard deviation of the frame interval", [] ( const CaptureStats& s ) { return s.JitterMs * 1.0e-3; } );
+        each ( "latency_mean_seconds", false, "Mean device to delivery latency", [] ( const CaptureStats& s ) { return s.LatencyMs * 1.0e-3; } );
+
+        writer.Summary ( "latency_seconds", "Device to delivery latency" );
+        for ( auto& sample : samples )
+        {
+            writer.Suffix ( "" );
+            writer.Value ( &sample.Device, sample.Stats.LatencyP50Ms * 1.0e-3, "quantile", "0.5" );
+            writer.Value ( &sample.Device, sample.Stats.LatencyP95Ms * 1.0e-3, "quantile", "0.95" );
+            writer.Value ( &sample.Device, sample.Stats.LatencyP99Ms * 1.0e-3, "quantile", "0.99" );
+            writer.Suffix ( "_sum" );
+            writer.Value ( &sample.Device, sample.Stats.LatencyMs * 1.0e-3 * (double)sample.Stats.LatencySamples );
+            writer.Suffix ( "_count" );
+            writer.Value ( &sample.Device, (double)sample.Stats.LatencySamples );
+        }
+
+        writer.Family ( "stage_latency_mean_seconds", false, "Mean latency added by each stage: device to arrival, arrival to publish, publish to pickup" );
+        for ( auto& sample : samples )
+        {
+            writer.Value ( &sample.Device, sample.Stats.LatencyMs * 1.0e-3, "stage", "device" );
+            writer.Value ( &sample.Device, sample.Stats.DeliveryMs * 1.0e-3, "stage", "delivery" );
+            writer.Value ( &sample.Device, sample.Stats.PickupMs * 1.0e-3, "stage", "pickup" );
+        }
+
+        each ( "errors", true, "Errors reported by the capture backend", [] ( const CaptureStats& s ) { return s.Errors; } );
+
+        writer.Family ( "errors_by_code", true, "Errors reported by the capture backend, by HRESULT or errno" );
+        for ( auto& sample : samples )
+        {
+            for ( auto& [code, count] : sample.Stats.ErrorCodes ) writer.Value ( &sample.Device, (double)count, "code", FormatCode ( code ) );
+        }
+
+        each ( "restarts", true, "Times the capture was started again after its first start", [] ( const CaptureStats& s ) { return s.Restarts; } );
+        each ( "memory_bytes", false, "Frame storage owned by the capture", [] ( const CaptureStats& s ) { return s.MemoryBytes; } );
+        each ( "streaming_seconds", false, "Time since the first frame of the current run", [] ( const CaptureStats& s ) { return s.ElapsedSeconds; } );
+
+        return writer.Finish ( );
+    }
+
+    bool MetricsExporter::ExportNow ( )
+    {
+        std::lock_guard<std::mutex> lock ( _exportMutex );
+
+        auto text = Render ( Collect ( ), _options.Format ( ), _options.Prefix ( ) );
+
+        bool ok = true;
+        if ( !_options.Path ( ).empty ( ) ) ok &= WriteFile ( text );
+        if ( !_options.Socket ( ).empty ( ) ) ok &= WriteSocket ( text );
+
+        if ( ok ) _exports++; else _failures++;
+        return ok;
+    }
+
+    bool MetricsExporter::WriteFile ( const std::string& text )
+    {
+        // Scrapers must never see a half written file
+        std::string temporary = _options.Path ( ) + ".tmp";
+        {
+            std::ofstream stream ( temporary, std::ios::binary | std::ios::trunc );
+            if ( !stream.write ( text.data ( ), (std::streamsize)text.size ( ) ) )
+            {
+                AX_LOG ( LogLevel::Warning, "Unable to write metrics to %s", temporary.c_str ( ) );
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename ( temporary, _options.Path ( ), error );
+        if ( error )
+        {
+            AX_LOG ( LogLevel::Warning, "Unable to replace %s: %s", _options.Path ( ).c_str ( ), error.message ( ).c_str ( ) );
+            return false;
+        }
+
+        return true;
+    }
+
+    bool MetricsExporter::WriteSocket ( const std::string& text )
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if ( _options.Socket ( ).size ( ) >= sizeof ( address.sun_path ) )
+        {
+            AX_LOG ( LogLevel::Warning, "Metrics socket path is too long: %s", _options.Socket ( ).c_str ( ) );
+            return false;
+        }
+
+        std::memcpy ( address.sun_path, _options.Socket ( ).c_str ( ), _options.Socket ( ).size ( ) );
+
+#ifdef _WIN32
+        static bool kIsWinsockReady = [] { WSADATA data; return WSAStartup ( MAKEWORD ( 2, 2 ), &data ) == 0; } ( );
+        if ( !kIsWinsockReady ) return false;
+
+        SOCKET handle = socket ( AF_UNIX, SOCK_STREAM, 0 );
+        if ( handle == INVALID_SOCKET ) return false;
+        auto Send = [&] ( const char* data, size_t size ) { return (long long)send ( handle, data, (int)size, 0 ); };
+        auto Close = [&] { closesocket ( handle ); };
+#else
+        int handle = socket ( AF_UNIX, SOCK_STREAM, 0 );
+        if ( handle < 0 ) return false;
+        auto Send = [&] ( const char* data, size_t size ) { return (long long)send ( handle, data, size, MSG_NOSIGNAL ); };
+        auto Close = [&] { close ( handle ); };
+#endif
+
+        if ( connect ( handle, (const sockaddr*)&address, sizeof ( address ) ) != 0 )
+        {
+            AX_LOG ( LogLevel::Warning, "Unable to connect to metrics socket %s", _options.Socket ( ).c_str ( ) );
+            Close ( );
+            return false;
+        }
+
+        size_t written = 0;
+        while ( written < text.size ( ) )
+        {
+            auto sent = Send ( text.data ( ) + written, text.size ( ) - written );
+            if ( sent <= 0 ) break;
+            written += (size_t)sent;
+        }
+
+        Close ( );
+        return written == text.size ( );
+    }
+}
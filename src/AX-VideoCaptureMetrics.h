@@ -0,0 +1,97 @@
+//
+//  AX-VideoCaptureMetrics.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCapture.h"
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+namespace AX::Video
+{
+    using MetricsExporterRef = std::shared_ptr<class MetricsExporter>;
+
+    // Periodically snapshots every live Capture's stats and publishes them in Prometheus
+    // text (or OpenMetrics) format, for a node_exporter textfile collector or a local agent
+    // to pick up. Snapshots only read the stats' atomics, the frame path never waits on it.
+    class MetricsExporter
+    {
+    public:
+
+        enum class Encoding
+        {
+            Prometheus,
+            OpenMetrics
+        };
+
+        struct Options
+        {
+            Options ( ) { };
+
+            // Replaced atomically (written alongside, then renamed over) on every export
+            Options& Path ( const std::string& path ) { _path = path; return *this; }
+            // A Unix domain stream socket, connected to once per export
+            Options& Socket ( const std::string& path ) { _socket = path; return *this; }
+            Options& Interval ( double seconds ) { _interval = seconds; return *this; }
+            Options& Format ( Encoding encoding ) { _encoding = encoding; return *this; }
+            Options& Prefix ( const std::string& prefix ) { _prefix = prefix; return *this; }
+
+            const std::string&  Path ( ) const { return _path; }
+            const std::string&  Socket ( ) const { return _socket; }
+            double              Interval ( ) const { return _interval; }
+            Encoding            Format ( ) const { return _encoding; }
+            const std::string&  Prefix ( ) const { return _prefix; }
+
+        protected:
+
+            std::string         _path;
+            std::string         _socket;
+            double              _interval{ 15.0 };
+            Encoding            _encoding{ Encoding::Prometheus };
+            std::string         _prefix{ "axvideo" };
+        };
+
+        struct Sample
+        {
+            DeviceDescriptor    Device;
+            CaptureStats        Stats;
+        };
+
+        static MetricsExporterRef   Create ( const Options& options );
+        static std::vector<Sample>  Collect ( );
+        static std::string          Render ( const std::vector<Sample>& samples, Encoding encoding, const std::string& prefix = "axvideo" );
+
+        // Collects and publishes on the calling thread, outside the regular interval
+        bool                        ExportNow ( );
+
+        uint64_t                    GetNumExports ( ) const { return _exports.load ( ); }
+        uint64_t                    GetNumFailures ( ) const { return _failures.load ( ); }
+
+        ~MetricsExporter ( );
+
+    protected:
+
+        MetricsExporter             ( const Options& options );
+
+        void                        Run ( );
+        bool                        WriteFile ( const std::string& text );
+        bool                        WriteSocket ( const std::string& text );
+
+        Options                     _options;
+        std::atomic<uint64_t>       _exports{ 0 };
+        std::atomic<uint64_t>       _failures{ 0 };
+
+        std::mutex                  _mutex;
+        std::mutex                  _exportMutex;
+        std::condition_variable     _wake;
+        bool                        _isRunning{ true };
+        std::thread                 _thread;
+    };
+}
@@ -0,0 +1,66 @@
+//
+//  AX-VideoCaptureOcclusion.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureOcclusion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr int32_t kGridX = 32;
+        constexpr int32_t kGridY = 18;
+    }
+
+    bool CoveredLensDetector::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size )
+    {
+        if ( !src || size.x <= 0 || size.y <= 0 ) return _isCovered;
+
+        const int32_t columns = std::min ( kGridX, size.x );
+        const int32_t rows = std::min ( kGridY, size.y );
+        double sum = 0.0, squares = 0.0;
+
+        // Cell centres, so the frame's edges (often vignetted dark) count no more than the rest
+        for ( int32_t j = 0; j < rows; j++ )
+        {
+            const uint8_t* row = src + srcRowBytes * (ptrdiff_t)( ( 2 * j + 1 ) * size.y / ( 2 * rows ) );
+            for ( int32_t i = 0; i < columns; i++ )
+            {
+                const uint8_t* p = row + (size_t)( ( 2 * i + 1 ) * size.x / ( 2 * columns ) ) * 4;
+                double luma = ( p[0] + 2.0 * p[1] + p[2] ) * 0.25;
+                sum += luma;
+                squares += luma * luma;
+            }
+        }
+
+        const double count = (double)columns * rows;
+        _mean = sum / count;
+        _deviation = std::sqrt ( std::max ( 0.0, squares / count - _mean * _mean ) );
+
+        if ( _mean <= _options.DarkLevel ( ) && _deviation <= _options.Flatness ( ) )
+        {
+            if ( ++_numCovered >= std::max ( 1, _options.Frames ( ) ) ) _isCovered = true;
+        } else
+        {
+            _numCovered = 0;
+            _isCovered = false;
+        }
+
+        return _isCovered;
+    }
+
+    void CoveredLensDetector::Reset ( )
+    {
+        _isCovered = false;
+        _numCovered = 0;
+        _mean = 0.0;
+        _deviation = 0.0;
+    }
+}
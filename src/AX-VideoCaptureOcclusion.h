@@ -0,0 +1,84 @@
+//
+//  AX-VideoCaptureOcclusion.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+
+namespace AX::Video
+{
+    struct OcclusionOptions
+    {
+        OcclusionOptions ( ) { };
+        OcclusionOptions ( bool enabled ) : _enabled ( enabled ) { };
+
+        OcclusionOptions& Enabled ( bool enabled ) { _enabled = enabled; return *this; }
+        // Frames still delivered per second while occluded, so consumers can tell the capture is
+        // alive. 0 for none.
+        OcclusionOptions& IdleFPS ( double fps ) { _idleFPS = fps; return *this; }
+        // Also switches the device to its slowest rate at the same size and subtype, which is
+        // what saves USB bandwidth. Cameras with a single rate keep delivering, and the frames
+        // are dropped as they arrive.
+        OcclusionOptions& LowerDeviceRate ( bool lower ) { _lowerDeviceRate = lower; return *this; }
+        // For cameras that don't report occlusion, treats a dark, flat picture as a covered lens.
+        // Software frames only.
+        OcclusionOptions& LuminanceFallback ( bool fallback ) { _luminanceFallback = fallback; return *this; }
+        // Brightest mean (0 .. 255) still counted as covered
+        OcclusionOptions& DarkLevel ( uint8_t level ) { _darkLevel = level; return *this; }
+        // Largest brightness standard deviation still counted as covered. A dark room with
+        // the lens open still has some detail, or at least noise.
+        OcclusionOptions& Flatness ( double deviation ) { _flatness = deviation; return *this; }
+        // Covered frames in a row before the fallback calls it, one open frame ends it
+        OcclusionOptions& Frames ( int32_t frames ) { _frames = frames; return *this; }
+
+        bool                IsEnabled ( ) const { return _enabled; }
+        double              IdleFPS ( ) const { return _idleFPS; }
+        bool                LowerDeviceRate ( ) const { return _lowerDeviceRate; }
+        bool                LuminanceFallback ( ) const { return _luminanceFallback; }
+        uint8_t             DarkLevel ( ) const { return _darkLevel; }
+        double              Flatness ( ) const { return _flatness; }
+        int32_t             Frames ( ) const { return _frames; }
+
+    protected:
+
+        bool                _enabled{ false };
+        double              _idleFPS{ 1.0 };
+        bool                _lowerDeviceRate{ true };
+        bool                _luminanceFallback{ true };
+        uint8_t             _darkLevel{ 16 };
+        double              _flatness{ 4.0 };
+        int32_t             _frames{ 15 };
+    };
+
+    // The luminance fallback. Reads a sparse grid of pixels rather than the frame, so it's
+    // cheap enough to keep running on frames that are otherwise dropped.
+    class CoveredLensDetector
+    {
+    public:
+
+        CoveredLensDetector         ( const OcclusionOptions& options = { } ) : _options ( options ) { }
+
+        const OcclusionOptions&     GetOptions ( ) const { return _options; }
+        bool                        IsCovered ( ) const { return _isCovered; }
+        double                      GetMean ( ) const { return _mean; }
+        double                      GetDeviation ( ) const { return _deviation; }
+
+        // src is size, 4 bytes per pixel. Returns whether the lens is covered as of this frame.
+        bool                        Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size );
+        void                        Reset ( );
+
+    protected:
+
+        OcclusionOptions            _options;
+        bool                        _isCovered{ false };
+        int32_t                     _numCovered{ 0 };
+        double                      _mean{ 0.0 };
+        double                      _deviation{ 0.0 };
+    };
+}
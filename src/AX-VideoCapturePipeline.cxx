@@ -0,0 +1,73 @@
+//
+//  AX-VideoCapturePipeline.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCapturePipeline.h"
+
+namespace AX::Video
+{
+    Pipeline::~Pipeline ( )
+    {
+        Stop ( );
+    }
+
+    void Pipeline::AddStage ( const std::shared_ptr<StageBase>& stage )
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        _stages.push_back ( stage );
+    }
+
+    void Pipeline::Attach ( const CaptureRef& capture, const Capture::FrameCallback& callback )
+    {
+        const uint64_t id = capture->AddFrameCallback ( callback );
+        std::lock_guard<std::mutex> lock ( _mutex );
+        _attachments.emplace_back ( capture, id );
+    }
+
+    std::shared_ptr<StageBase> Pipeline::GetStage ( const std::string& name ) const
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        for ( auto& stage : _stages )
+        {
+            if ( stage->GetName ( ) == name ) return stage;
+        }
+
+        return nullptr;
+    }
+
+    std::vector<StageStats> Pipeline::GetStats ( ) const
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        std::vector<StageStats> stats;
+        stats.reserve ( _stages.size ( ) );
+        for ( auto& stage : _stages ) stats.push_back ( stage->GetStats ( ) );
+        return stats;
+    }
+
+    void Pipeline::ResetStats ( )
+    {
+        std::lock_guard<std::mutex> lock ( _mutex );
+        for ( auto& stage : _stages ) stage->ResetStats ( );
+    }
+
+    void Pipeline::Stop ( )
+    {
+        std::vector<std::pair<std::weak_ptr<Capture>, uint64_t>> attachments;
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            attachments.swap ( _attachments );
+        }
+
+        for ( auto& [weak, id] : attachments )
+        {
+            if ( auto capture = weak.lock ( ) ) capture->RemoveFrameCallback ( id );
+        }
+
+        _state->Stop ( );
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  AX-VideoCapturePipeline.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCapture.h"
+#include "AX-VideoCaptureStage.h"
+#include <variant>
+
+namespace AX::Video
+{
+    using PipelineRef = std::shared_ptr<class Pipeline>;
+
+    // A small dataflow graph over frames: typed stages connected by bounded queues, each run on
+    // the shared executor with its own parallelism, drop policy and stats, so a chain like
+    // convert -> undistort -> detect -> record is built and tuned in one place rather than
+    // with threads and queues of its own. Stages are created by the pipeline and connected
+    // with Stage::Connect, frames come in through Attach (or a stage's Push).
+    //
+    //  auto pipeline = Pipeline::Create ( );
+    //  auto gray = pipeline->AddStage<FrameRef, FrameRef> ( "gray", [] ( FrameRef& f, auto& ) { f->GetGray ( ); return f; } );
+    //  auto detect = pipeline->AddSink<FrameRef> ( "detect", Detect, StageOptions ( ).Drop ( DropPolicy::LatestWins ) );
+    //  gray->Connect ( detect );
+    //  pipeline->Attach ( capture, gray );
+    class Pipeline
+    {
+    public:
+
+        static PipelineRef          Create ( ) { return PipelineRef ( new Pipeline ( ) ); }
+
+        // Stops first, see Stop
+        ~Pipeline                   ( );
+
+        template <typename In, typename Out>
+        std::shared_ptr<Stage<In, Out>> AddStage ( const std::string& name, const typename Stage<In, Out>::Fn& fn, const StageOptions& options = StageOptions ( ) )
+        {
+            auto stage = std::make_shared<Stage<In, Out>> ( _state, name, options, fn );
+            AddStage ( stage );
+            return stage;
+        }
+
+        // A stage with no output, at the end of a chain
+        template <typename In>
+        std::shared_ptr<Stage<In, std::monostate>> AddSink ( const std::string& name, const std::function<void ( In& input, const StageContext& context )>& fn, const StageOptions& options = StageOptions ( ) )
+        {
+            return AddStage<In, std::monostate> ( name, [fn] ( In& input, const StageContext& context ) -> std::optional<std::monostate>
+            {
+                if ( fn ) fn ( input, context );
+                return std::nullopt;
+            }, options );
+        }
+
+        // Pushes every CPU frame the capture delivers into first, so the capture needs to be in
+        // software mode. Runs on the capture thread, which never waits on the pipeline.
+        template <typename Out>
+        void                        Attach ( const CaptureRef& capture, const std::shared_ptr<Stage<FrameRef, Out>>& first )
+        {
+            if ( capture && first ) Attach ( capture, [first] ( const FrameRef& frame ) { first->Push ( frame ); } );
+        }
+
+        // By name, for tuning from one place. Null if there isn't one.
+        std::shared_ptr<StageBase>  GetStage ( const std::string& name ) const;
+        // In the order the stages were added
+        std::vector<StageStats>     GetStats ( ) const;
+        void                        ResetStats ( );
+
+        // Detaches from the captures, stops running new items and waits for the ones running to
+        // finish. Which means it mustn't be called from inside a stage.
+        void                        Stop ( );
+
+        Pipeline ( const Pipeline& ) = delete;
+        Pipeline& operator = ( const Pipeline& ) = delete;
+
+    protected:
+
+        Pipeline                    ( ) { };
+
+        void                        AddStage ( const std::shared_ptr<StageBase>& stage );
+        void                        Attach ( const CaptureRef& capture, const Capture::FrameCallback& callback );
+
+        std::shared_ptr<PipelineState> _state{ std::make_shared<PipelineState> ( Capture::GetTime ) };
+        mutable std::mutex          _mutex;
+        std::vector<std::shared_ptr<StageBase>> _stages;
+        std::vector<std::pair<std::weak_ptr<Capture>, uint64_t>> _attachments;
+    };
+}
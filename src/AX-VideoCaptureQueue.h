@@ -0,0 +1,117 @@
+//
+//  AX-VideoCaptureQueue.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace AX::Video
+{
+    // Bounded multi producer, multi consumer queue without locks (Vyukov's). Capacity is
+    // rounded up to a power of two. Popped slots are moved out of, so a queue of FrameRefs
+    // doesn't keep frames alive once they've been taken.
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+
+        explicit BoundedQueue       ( size_t capacity )
+        {
+            size_t size = 2;
+            while ( size < capacity ) size <<= 1;
+            _mask = size - 1;
+            _cells.reset ( new Cell[size] );
+            for ( size_t i = 0; i < size; i++ ) _cells[i].Sequence.store ( i, std::memory_order_relaxed );
+        }
+
+        BoundedQueue ( const BoundedQueue& ) = delete;
+        BoundedQueue& operator = ( const BoundedQueue& ) = delete;
+
+        // value is only moved from if there was room
+        bool                        TryPush ( T& value )
+        {
+            size_t position = _enqueue.load ( std::memory_order_relaxed );
+            for ( ;; )
+            {
+                Cell& cell = _cells[position & _mask];
+                const size_t sequence = cell.Sequence.load ( std::memory_order_acquire );
+                const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+                if ( difference == 0 )
+                {
+                    if ( _enqueue.compare_exchange_weak ( position, position + 1, std::memory_order_relaxed ) )
+                    {
+                        cell.Value = std::move ( value );
+                        cell.Sequence.store ( position + 1, std::memory_order_release );
+                        return true;
+                    }
+                } else if ( difference < 0 )
+                {
+                    return false;
+                } else
+                {
+                    position = _enqueue.load ( std::memory_order_relaxed );
+                }
+            }
+        }
+
+        bool                        TryPop ( T& value )
+        {
+            size_t position = _dequeue.load ( std::memory_order_relaxed );
+            for ( ;; )
+            {
+                Cell& cell = _cells[position & _mask];
+                const size_t sequence = cell.Sequence.load ( std::memory_order_acquire );
+                const intptr_t difference = (intptr_t)sequence - (intptr_t)( position + 1 );
+                if ( difference == 0 )
+                {
+                    if ( _dequeue.compare_exchange_weak ( position, position + 1, std::memory_order_relaxed ) )
+                    {
+                        value = std::move ( cell.Value );
+                        cell.Value = T ( );
+                        cell.Sequence.store ( position + _mask + 1, std::memory_order_release );
+                        return true;
+                    }
+                } else if ( difference < 0 )
+                {
+                    return false;
+                } else
+                {
+                    position = _dequeue.load ( std::memory_order_relaxed );
+                }
+            }
+        }
+
+        // Approximate while other threads are pushing or popping
+        size_t                      Size ( ) const
+        {
+            const size_t enqueue = _enqueue.load ( std::memory_order_relaxed );
+            const size_t dequeue = _dequeue.load ( std::memory_order_relaxed );
+            return enqueue > dequeue ? std::min ( enqueue - dequeue, _mask + 1 ) : 0;
+        }
+
+        size_t                      Capacity ( ) const { return _mask + 1; }
+
+    protected:
+
+        struct Cell
+        {
+            std::atomic<size_t>     Sequence{ 0 };
+            T                       Value{ };
+        };
+
+        std::unique_ptr<Cell[]>     _cells;
+        size_t                      _mask{ 0 };
+        alignas ( 64 ) std::atomic<size_t> _enqueue{ 0 };
+        alignas ( 64 ) std::atomic<size_t> _dequeue{ 0 };
+    };
+}
@@ -0,0 +1,321 @@
+//
+//  AX-VideoCaptureRemap.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureRemap.h"
+#include "AX-VideoCaptureExecutor.h"
+#include <cmath>
+#include <cstring>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr int32_t kOne = 1 << 16;
+
+        // Source position of an output pixel, in source pixels
+        void MapPixel ( const RemapOptions& options, double u, double v, double& x, double& y )
+        {
+            auto& lens = options.Lens ( );
+            switch ( options.Model ( ) )
+            {
+                case RemapModel::BrownConrady:
+                case RemapModel::Fisheye:
+                {
+                    const double zoom = options.Zoom ( ) > 0.0 ? options.Zoom ( ) : 1.0;
+                    double nx = ( u - lens.Cx ) / ( lens.Fx * zoom );
+                    double ny = ( v - lens.Cy ) / ( lens.Fy * zoom );
+
+                    if ( options.Model ( ) == RemapModel::BrownConrady )
+                    {
+                        double r2 = nx * nx + ny * ny;
+                        double radial = 1.0 + r2 * ( lens.K1 + r2 * ( lens.K2 + r2 * lens.K3 ) );
+                        double dx = nx * radial + 2.0 * lens.P1 * nx * ny + lens.P2 * ( r2 + 2.0 * nx * nx );
+                        double dy = ny * radial + lens.P1 * ( r2 + 2.0 * ny * ny ) + 2.0 * lens.P2 * nx * ny;
+                        nx = dx;
+                        ny = dy;
+                    } else
+                    {
+                        double r = std::sqrt ( nx * nx + ny * ny );
+                        if ( r > 1.0e-9 )
+                        {
+                            double theta = std::atan ( r );
+                            double t2 = theta * theta;
+                            double distorted = theta * ( 1.0 + t2 * ( lens.K1 + t2 * ( lens.K2 + t2 * ( lens.K3 + t2 * lens.K4 ) ) ) );
+                            nx *= distorted / r;
+                            ny *= distorted / r;
+                        }
+                    }
+
+                    x = nx * lens.Fx + lens.Cx;
+                    y = ny * lens.Fy + lens.Cy;
+                    break;
+                }
+
+                case RemapModel::Homography:
+                {
+                    auto& h = options.Homography ( );
+                    double w = h[6] * u + h[7] * v + h[8];
+                    if ( std::abs ( w ) < 1.0e-12 ) w = 1.0e-12;
+                    x = ( h[0] * u + h[1] * v + h[2] ) / w;
+                    y = ( h[3] * u + h[4] * v + h[5] ) / w;
+                    break;
+                }
+
+                default:
+                {
+                    x = u;
+                    y = v;
+                    break;
+                }
+            }
+        }
+
+        int32_t ToFixed ( double value )
+        {
+            // Well outside any source, but far enough from overflowing that interpolation can't wrap
+            return (int32_t)std::clamp ( value * kOne, -1.0e9, 1.0e9 );
+        }
+    }
+
+    void SampleBilinear ( uint8_t* dst, const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& srcSize, int32_t x, int32_t y )
+    {
+        int32_t x0 = x >> 16;
+        int32_t y0 = y >> 16;
+        uint32_t fx = ( (uint32_t)x >> 8 ) & 0xFF;
+        uint32_t fy = ( (uint32_t)y >> 8 ) & 0xFF;
+
+        // The last column / row samples its neighbour with a weight of 0
+        if ( x0 >= srcSize.x - 1 ) { x0 = srcSize.x - 2; fx = 256; }
+        if ( y0 >= srcSize.y - 1 ) { y0 = srcSize.y - 2; fy = 256; }
+
+        const uint8_t* p = src + srcRowBytes * (ptrdiff_t)y0 + (ptrdiff_t)x0 * 4;
+
+#ifdef AX_VIDEOCAPTURE_SSE2
+        const __m128i zero = _mm_setzero_si128 ( );
+        const __m128i round = _mm_set1_epi16 ( 128 );
+        __m128i top = _mm_unpacklo_epi8 ( _mm_loadl_epi64 ( (const __m128i*)p ), zero );
+        __m128i bottom = _mm_unpacklo_epi8 ( _mm_loadl_epi64 ( (const __m128i*)( p + srcRowBytes ) ), zero );
+
+        __m128i column = _mm_add_epi16 ( _mm_mullo_epi16 ( top, _mm_set1_epi16 ( (short)( 256 - fy ) ) ), _mm_mullo_epi16 ( bottom, _mm_set1_epi16 ( (short)fy ) ) );
+        column = _mm_srli_epi16 ( _mm_add_epi16 ( column, round ), 8 );
+
+        // Left pixel in the low four lanes, right pixel in the high four
+        const short left = (short)( 256 - fx ), right = (short)fx;
+        __m128i weighted = _mm_mullo_epi16 ( column, _mm_set_epi16 ( right, right, right, right, left, left, left, left ) );
+        __m128i result = _mm_srli_epi16 ( _mm_add_epi16 ( _mm_add_epi16 ( weighted, _mm_srli_si128 ( weighted, 8 ) ), round ), 8 );
+
+        int32_t pixel = _mm_cvtsi128_si32 ( _mm_packus_epi16 ( result, result ) );
+        std::memcpy ( dst, &pixel, 4 );
+#else
+        for ( int c = 0; c < 4; c++ )
+        {
+            uint32_t left = ( p[c] * ( 256 - fy ) + p[srcRowBytes + c] * fy + 128 ) >> 8;
+            uint32_t right = ( p[4 + c] * ( 256 - fy ) + p[srcRowBytes + 4 + c] * fy + 128 ) >> 8;
+            dst[c] = (uint8_t)( ( left * ( 256 - fx ) + right * fx + 128 ) >> 8 );
+        }
+#endif
+    }
+
+    const char * ToString ( RemapModel model )
+    {
+        switch ( model )
+        {
+            case RemapModel::Off:           return "Off";
+            case RemapModel::BrownConrady:  return "BrownConrady";
+            case RemapModel::Fisheye:       return "Fisheye";
+            case RemapModel::Homography:    return "Homography";
+            default: return "Unknown";
+        }
+    }
+
+    void Remapper::SetView ( const std::array<double, 9>& view )
+    {
+        if ( view == _view ) return;
+        _view = view;
+        _map.clear ( );
+    }
+
+    void Remapper::BuildModel ( const Vec2i& srcSize, const Vec2i& dstSize )
+    {
+        _srcSize = srcSize;
+        _dstSize = dstSize;
+        _step = std::max ( 1, _options.GridStep ( ) );
+
+        // One point past the last pixel so every cell has a right and bottom edge
+        _mapSize = { ( dstSize.x + _step - 1 ) / _step + 1, ( dstSize.y + _step - 1 ) / _step + 1 };
+        _model.resize ( (size_t)_mapSize.x * (size_t)_mapSize.y );
+
+        for ( int32_t gy = 0; gy < _mapSize.y; gy++ )
+        {
+            for ( int32_t gx = 0; gx < _mapSize.x; gx++ )
+            {
+                double x = 0.0, y = 0.0;
+                MapPixel ( _options, (double)( gx * _step ), (double)( gy * _step ), x, y );
+                _model[(size_t)gy * _mapSize.x + gx] = { ToFixed ( x ), ToFixed ( y ) };
+            }
+        }
+
+        const int32_t tileSize = std::max ( _step, _options.TileSize ( ) );
+        _numTiles = { ( dstSize.x + tileSize - 1 ) / tileSize, ( dstSize.y + tileSize - 1 ) / tileSize };
+        _map.clear ( );
+    }
+
+    void Remapper::BuildMap ( )
+    {
+        static const std::array<double, 9> kIdentity{ 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+        if ( _view == kIdentity )
+        {
+            _map = _model;
+            return;
+        }
+
+        // Where the view lands on the model's grid. The cell's clamped to the grid but the
+        // fraction isn't, so a view reaching past the frame extrapolates from the edge cell
+        auto Locate = [] ( double m, int32_t points, int32_t& cell, double& fraction )
+        {
+            cell = m > 0.0 ? std::min ( (int32_t)std::min ( m, 1.0e9 ), points - 2 ) : 0;
+            fraction = m - cell;
+        };
+
+        auto Blend = [&] ( int32_t cx, int32_t cy, double fx, double fy )
+        {
+            const MapPoint* upper = &_model[(size_t)cy * _mapSize.x + cx];
+            const MapPoint* lower = upper + _mapSize.x;
+            auto Mix = [&] ( int32_t a, int32_t b, int32_t c, int32_t d )
+            {
+                const double top = a + ( (double)b - a ) * fx;
+                const double bottom = c + ( (double)d - c ) * fx;
+                return (int32_t)std::clamp ( top + ( bottom - top ) * fy, -1.0e9, 1.0e9 );
+            };
+
+            return MapPoint{ Mix ( upper[0].X, upper[1].X, lower[0].X, lower[1].X ), Mix ( upper[0].Y, upper[1].Y, lower[0].Y, lower[1].Y ) };
+        };
+
+        _map.resize ( _model.size ( ) );
+        const double scale = 1.0 / _step;
+
+        // A crop or pan (all the viewport makes) moves columns and rows independently, so each
+        // is located once and the grid's left with just the blend
+        if ( _view[1] == 0.0 && _view[3] == 0.0 && _view[6] == 0.0 && _view[7] == 0.0 && _view[8] == 1.0 )
+        {
+            _columns.resize ( _mapSize.x );
+            _rows.resize ( _mapSize.y );
+            for ( int32_t gx = 0; gx < _mapSize.x; gx++ ) Locate ( ( _view[0] * gx * _step + _view[2] ) * scale, _mapSize.x, _columns[gx].Cell, _columns[gx].Fraction );
+            for ( int32_t gy = 0; gy < _mapSize.y; gy++ ) Locate ( ( _view[4] * gy * _step + _view[5] ) * scale, _mapSize.y, _rows[gy].Cell, _rows[gy].Fraction );
+
+            for ( int32_t gy = 0; gy < _mapSize.y; gy++ )
+            {
+                MapPoint* out = &_map[(size_t)gy * _mapSize.x];
+                for ( int32_t gx = 0; gx < _mapSize.x; gx++ ) out[gx] = Blend ( _columns[gx].Cell, _rows[gy].Cell, _columns[gx].Fraction, _rows[gy].Fraction );
+            }
+
+            return;
+        }
+
+        for ( int32_t gy = 0; gy < _mapSize.y; gy++ )
+        {
+            for ( int32_t gx = 0; gx < _mapSize.x; gx++ )
+            {
+                const double u = (double)( gx * _step ), v = (double)( gy * _step );
+                double w = _view[6] * u + _view[7] * v + _view[8];
+                if ( std::abs ( w ) < 1.0e-12 ) w = 1.0e-12;
+                w = scale / w;
+
+                int32_t cx = 0, cy = 0;
+                double fx = 0.0, fy = 0.0;
+                Locate ( ( _view[0] * u + _view[1] * v + _view[2] ) * w, _mapSize.x, cx, fx );
+                Locate ( ( _view[3] * u + _view[4] * v + _view[5] ) * w, _mapSize.y, cy, fy );
+                _map[(size_t)gy * _mapSize.x + gx] = Blend ( cx, cy, fx, fy );
+            }
+        }
+    }
+
+    void Remapper::ProcessTile ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, int32_t tile ) const
+    {
+        const int32_t tileSize = std::max ( _step, _options.TileSize ( ) );
+        const int32_t left = ( tile % _numTiles.x ) * tileSize;
+        const int32_t top = ( tile / _numTiles.x ) * tileSize;
+        const int32_t right = std::min ( left + tileSize, dst.Size.x );
+        const int32_t bottom = std::min ( top + tileSize, dst.Size.y );
+
+        const int32_t maxX = ( _srcSize.x - 1 ) * kOne;
+        const int32_t maxY = ( _srcSize.y - 1 ) * kOne;
+        const uint32_t fill = _options.FillColor ( );
+
+        for ( int32_t v = top; v < bottom; v++ )
+        {
+            const int32_t gy = v / _step;
+            const int64_t ty = v - gy * _step;
+            const MapPoint* upper = &_map[(size_t)gy * _mapSize.x];
+            const MapPoint* lower = upper + _mapSize.x;
+            uint8_t* row = dst.Data + dst.RowBytes * (ptrdiff_t)v;
+
+            for ( int32_t u = left; u < right; )
+            {
+                // Walk one map cell at a time, stepping linearly between its left and right edges
+                const int32_t gx = u / _step;
+                const int32_t cellEnd = std::min ( ( gx + 1 ) * _step, right );
+
+                auto Lerp = [&] ( int32_t a, int32_t b ) { return (int64_t)a + ( ( (int64_t)b - a ) * ty ) / _step; };
+                int64_t x0 = Lerp ( upper[gx].X, lower[gx].X );
+                int64_t y0 = Lerp ( upper[gx].Y, lower[gx].Y );
+                int64_t x1 = Lerp ( upper[gx + 1].X, lower[gx + 1].X );
+                int64_t y1 = Lerp ( upper[gx + 1].Y, lower[gx + 1].Y );
+
+                const int64_t dx = ( x1 - x0 ) / _step;
+                const int64_t dy = ( y1 - y0 ) / _step;
+                int64_t x = x0 + dx * ( u - gx * _step );
+                int64_t y = y0 + dy * ( u - gx * _step );
+
+                for ( ; u < cellEnd; u++, x += dx, y += dy )
+                {
+                    uint8_t* out = row + (ptrdiff_t)u * 4;
+                    if ( x < 0 || y < 0 || x > maxX || y > maxY )
+                    {
+                        std::memcpy ( out, &fill, 4 );
+                        continue;
+                    }
+
+                    SampleBilinear ( out, src, srcRowBytes, _srcSize, (int32_t)x, (int32_t)y );
+                }
+            }
+        }
+    }
+
+    void Remapper::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& srcSize, const Plane& dst )
+    {
+        if ( !dst.Data || dst.Size.x <= 0 || dst.Size.y <= 0 ) return;
+
+        // Too small to interpolate, or nothing to do
+        if ( !_options.IsEnabled ( ) || srcSize.x < 2 || srcSize.y < 2 )
+        {
+            const size_t rowBytes = (size_t)std::min ( srcSize.x, dst.Size.x ) * 4;
+            for ( int32_t y = 0; y < std::min ( srcSize.y, dst.Size.y ); y++ ) std::memcpy ( dst.Data + dst.RowBytes * y, src + srcRowBytes * y, rowBytes );
+            return;
+        }
+
+        if ( _model.empty ( ) || srcSize != _srcSize || dst.Size != _dstSize ) BuildModel ( srcSize, dst.Size );
+        if ( _map.empty ( ) ) BuildMap ( );
+
+        const size_t numTiles = (size_t)_numTiles.x * (size_t)_numTiles.y;
+        auto fn = [&] ( size_t tile ) { ProcessTile ( src, srcRowBytes, dst, (int32_t)tile ); };
+        if ( _options.Parallel ( ) )
+        {
+            Executor::Get ( )->ParallelFor ( numTiles, fn );
+        } else
+        {
+            for ( size_t tile = 0; tile < numTiles; tile++ ) fn ( tile );
+        }
+    }
+}
@@ -0,0 +1,68 @@
+//
+//  AX-VideoCaptureRuntime.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace AX::Video
+{
+    using CaptureRuntimeRef = std::shared_ptr<class CaptureRuntime>;
+
+    // The process wide state every capture shares: Media Foundation itself and, for hardware
+    // accelerated captures, the D3D11 device and its GL interop handle. Each Capture holds a
+    // reference. When the last one goes the runtime lingers for a while before shutting down,
+    // so destroying and recreating captures doesn't pay for the bring-up every time.
+    //
+    // Holding a reference from app start (Prewarm) moves that cost out of the first Create
+    // and keeps the runtime up for as long as it's held.
+    class CaptureRuntime
+    {
+    public:
+
+        struct Timings
+        {
+            uint32_t    NumStartups{ 0 };           // Media Foundation bring-ups
+            double      StartupMs{ 0.0 };           // The most recent one
+            double      TotalStartupMs{ 0.0 };
+            uint32_t    NumDeviceStartups{ 0 };     // D3D11 device + GL interop bring-ups
+            double      DeviceStartupMs{ 0.0 };
+            double      TotalDeviceStartupMs{ 0.0 };
+            uint32_t    NumReuses{ 0 };             // Acquires that found the runtime already up
+            uint32_t    NumShutdowns{ 0 };
+        };
+
+        // Hardware brings up the D3D11 device and GL interop as well, and has to be called
+        // on the GL thread with its context current
+        static CaptureRuntimeRef    Acquire ( bool hardwareAccelerated = false );
+        // Acquire, for calling from setup ( ). Hold on to the result to keep the runtime up.
+        static CaptureRuntimeRef    Prewarm ( bool hardwareAccelerated = true ) { return Acquire ( hardwareAccelerated ); }
+
+        // How long the runtime stays up once nothing holds it. 0 shuts it down straight away.
+        static void                 SetLinger ( double seconds );
+        static double               GetLinger ( );
+
+        // Shuts the runtime down now, if nothing holds it. GL thread.
+        static void                 Shutdown ( );
+
+        static bool                 IsRunning ( );
+        static Timings              GetTimings ( );
+
+        bool                        IsHardwareAccelerated ( ) const { return _isHardwareAccelerated; }
+
+        ~CaptureRuntime ( );
+
+    protected:
+
+        CaptureRuntime              ( bool hardwareAccelerated ) : _isHardwareAccelerated ( hardwareAccelerated ) { }
+
+        bool                        _isHardwareAccelerated{ false };
+    };
+}
@@ -0,0 +1,325 @@
+//
+//  AX-VideoCaptureStabilize.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureStabilize.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define AX_VIDEOCAPTURE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace AX::Video
+{
+    namespace
+    {
+        // Source pixels per level 0 pyramid pixel
+        constexpr int32_t kBlock = 8;
+
+        uint32_t SAD ( const uint8_t* a, const uint8_t* b, size_t bytes )
+        {
+            uint32_t sum = 0;
+            size_t i = 0;
+#ifdef AX_VIDEOCAPTURE_SSE2
+            __m128i total = _mm_setzero_si128 ( );
+            for ( ; i + 16 <= bytes; i += 16 )
+            {
+                total = _mm_add_epi64 ( total, _mm_sad_epu8 ( _mm_loadu_si128 ( (const __m128i*)( a + i ) ), _mm_loadu_si128 ( (const __m128i*)( b + i ) ) ) );
+            }
+            sum = (uint32_t)( _mm_cvtsi128_si32 ( total ) + _mm_cvtsi128_si32 ( _mm_srli_si128 ( total, 8 ) ) );
+#endif
+            for ( ; i < bytes; i++ ) sum += (uint32_t)std::abs ( (int)a[i] - (int)b[i] );
+            return sum;
+        }
+
+        // Sum of the 32 bytes (8 BGRA pixels) at p
+        inline uint32_t SumBlock ( const uint8_t* p )
+        {
+#ifdef AX_VIDEOCAPTURE_SSE2
+            const __m128i zero = _mm_setzero_si128 ( );
+            __m128i sum = _mm_add_epi64 ( _mm_sad_epu8 ( _mm_loadu_si128 ( (const __m128i*)p ), zero ), _mm_sad_epu8 ( _mm_loadu_si128 ( (const __m128i*)( p + 16 ) ), zero ) );
+            return (uint32_t)( _mm_cvtsi128_si32 ( sum ) + _mm_cvtsi128_si32 ( _mm_srli_si128 ( sum, 8 ) ) );
+#else
+            uint32_t sum = 0;
+            for ( int i = 0; i < 32; i++ ) sum += p[i];
+            return sum;
+#endif
+        }
+
+        // Mean absolute difference of cur against prev shifted by (dx, dy), over the part of
+        // the level at least margin in from every edge
+        uint32_t MatchCost ( const uint8_t* cur, const uint8_t* prev, const Vec2i& size, int32_t margin, int32_t dx, int32_t dy )
+        {
+            const int32_t width = size.x - margin * 2;
+            uint32_t sum = 0;
+            for ( int32_t y = margin; y < size.y - margin; y++ )
+            {
+                sum += SAD ( cur + (ptrdiff_t)y * size.x + margin, prev + (ptrdiff_t)( y - dy ) * size.x + margin - dx, (size_t)width );
+            }
+            return sum;
+        }
+
+        // Offset of the minimum of the parabola through three costs, -0.5 .. 0.5
+        double Subpixel ( double left, double centre, double right )
+        {
+            double denominator = left - 2.0 * centre + right;
+            if ( denominator <= 0.0 ) return 0.0;
+            return std::clamp ( 0.5 * ( left - right ) / denominator, -0.5, 0.5 );
+        }
+    }
+
+    Stabilizer::Stats Stabilizer::GetStats ( ) const
+    {
+        Stats stats;
+        stats.Frames = _frames.load ( std::memory_order_acquire );
+        stats.EstimateMs = stats.Frames > 0 ? _estimateSumMs.load ( std::memory_order_relaxed ) / (double)stats.Frames : 0.0;
+        stats.LastEstimateMs = _lastEstimateMs.load ( std::memory_order_relaxed );
+        stats.MotionX = _motionX.load ( std::memory_order_relaxed );
+        stats.MotionY = _motionY.load ( std::memory_order_relaxed );
+        stats.CorrectionX = _correctionX.load ( std::memory_order_relaxed );
+        stats.CorrectionY = _correctionY.load ( std::memory_order_relaxed );
+        return stats;
+    }
+
+    void Stabilizer::Reset ( )
+    {
+        _hasPrevious = false;
+        _path.clear ( );
+        while ( !_pending.empty ( ) )
+        {
+            _spare.push_back ( std::move ( _pending.front ( ) ) );
+            _pending.pop_front ( );
+        }
+        _smoothX = _smoothY = 0.0;
+    }
+
+    void Stabilizer::BuildPyramid ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size, Level* levels ) const
+    {
+        // Level 0 averages the middle two rows of each 8x8 block, so only a quarter of the
+        // frame is ever read. Alpha's in there too, it's constant so doesn't affect matching.
+        auto& level0 = levels[0];
+        level0.Size = { size.x / kBlock, size.y / kBlock };
+        level0.Pixels.resize ( (size_t)level0.Size.x * (size_t)level0.Size.y );
+
+        for ( int32_t y = 0; y < level0.Size.y; y++ )
+        {
+            const uint8_t* upper = src + srcRowBytes * (ptrdiff_t)( y * kBlock + kBlock / 2 - 1 );
+            const uint8_t* lower = upper + srcRowBytes;
+            uint8_t* out = &level0.Pixels[(size_t)y * level0.Size.x];
+            for ( int32_t x = 0; x < level0.Size.x; x++ )
+            {
+                const ptrdiff_t offset = (ptrdiff_t)x * kBlock * 4;
+                out[x] = (uint8_t)( ( SumBlock ( upper + offset ) + SumBlock ( lower + offset ) ) / 64 );
+            }
+        }
+
+        auto& level1 = levels[1];
+        level1.Size = { level0.Size.x / 2, level0.Size.y / 2 };
+        level1.Pixels.resize ( (size_t)level1.Size.x * (size_t)level1.Size.y );
+
+        for ( int32_t y = 0; y < level1.Size.y; y++ )
+        {
+            const uint8_t* upper = &level0.Pixels[(size_t)y * 2 * level0.Size.x];
+            const uint8_t* lower = upper + level0.Size.x;
+            uint8_t* out = &level1.Pixels[(size_t)y * level1.Size.x];
+            for ( int32_t x = 0; x < level1.Size.x; x++ )
+            {
+                out[x] = (uint8_t)( ( upper[x * 2] + upper[x * 2 + 1] + lower[x * 2] + lower[x * 2 + 1] + 2 ) / 4 );
+            }
+        }
+    }
+
+    bool Stabilizer::EstimateMotion ( double& motionX, double& motionY ) const
+    {
+        // Coarse: every shift within range on level 1
+        auto& cur1 = _current[1];
+        auto& prev1 = _previous[1];
+        const int32_t range1 = std::max ( 1, ( _options.SearchRange ( ) + kBlock * 2 - 1 ) / ( kBlock * 2 ) );
+        if ( cur1.Size.x <= range1 * 4 || cur1.Size.y <= range1 * 4 ) return false;
+
+        uint32_t best = UINT32_MAX, worst = 0;
+        int32_t bestX = 0, bestY = 0;
+        for ( int32_t dy = -range1; dy <= range1; dy++ )
+        {
+            for ( int32_t dx = -range1; dx <= range1; dx++ )
+            {
+                uint32_t cost = MatchCost ( cur1.Pixels.data ( ), prev1.Pixels.data ( ), cur1.Size, range1, dx, dy );
+                worst = std::max ( worst, cost );
+                if ( cost < best ) { best = cost; bestX = dx; bestY = dy; }
+            }
+        }
+
+        // Nothing to lock on to (a blank wall, a lens cap), better to not correct than to guess
+        const uint32_t numPixels = (uint32_t)( ( cur1.Size.x - range1 * 2 ) * ( cur1.Size.y - range1 * 2 ) );
+        if ( worst - best < numPixels ) return false;
+
+        // Fine: +/- 2 around the coarse answer on level 0, then a parabola through the
+        // neighbouring costs for the fraction
+        auto& cur0 = _current[0];
+        auto& prev0 = _previous[0];
+        const int32_t margin0 = range1 * 2 + 3;
+        if ( cur0.Size.x <= margin0 * 2 || cur0.Size.y <= margin0 * 2 ) return false;
+        uint32_t costs[7][7];
+        uint32_t best0 = UINT32_MAX;
+        int32_t fineX = 0, fineY = 0;
+        for ( int32_t j = 0; j < 7; j++ )
+        {
+            for ( int32_t i = 0; i < 7; i++ )
+            {
+                // Only the 5x5 search and its immediate ring are ever needed, but the ring only
+                // for the winner, so cost it lazily below
+                costs[j][i] = UINT32_MAX;
+                if ( i == 0 || j == 0 || i == 6 || j == 6 ) continue;
+
+                uint32_t cost = MatchCost ( cur0.Pixels.data ( ), prev0.Pixels.data ( ), cur0.Size, margin0, bestX * 2 + i - 3, bestY * 2 + j - 3 );
+                costs[j][i] = cost;
+                if ( cost < best0 ) { best0 = cost; fineX = i; fineY = j; }
+            }
+        }
+
+        auto Cost = [&] ( int32_t i, int32_t j )
+        {
+            if ( costs[j][i] == UINT32_MAX ) costs[j][i] = MatchCost ( cur0.Pixels.data ( ), prev0.Pixels.data ( ), cur0.Size, margin0, bestX * 2 + i - 3, bestY * 2 + j - 3 );
+            return (double)costs[j][i];
+        };
+
+        double subX = Subpixel ( Cost ( fineX - 1, fineY ), best0, Cost ( fineX + 1, fineY ) );
+        double subY = Subpixel ( Cost ( fineX, fineY - 1 ), best0, Cost ( fineX, fineY + 1 ) );
+
+        motionX = ( bestX * 2 + fineX - 3 + subX ) * kBlock;
+        motionY = ( bestY * 2 + fineY - 3 + subY ) * kBlock;
+        return true;
+    }
+
+    bool Stabilizer::Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, double timestamp, double& dueTimestamp )
+    {
+        if ( !dst.Data || dst.Size.x < kBlock * 4 || dst.Size.y < kBlock * 4 ) return false;
+        if ( dst.Size != _size )
+        {
+            Reset ( );
+            _size = dst.Size;
+        }
+
+        // Estimate
+        auto start = std::chrono::steady_clock::now ( );
+        BuildPyramid ( src, srcRowBytes, dst.Size, _current );
+
+        double motionX = 0.0, motionY = 0.0;
+        if ( _hasPrevious && !EstimateMotion ( motionX, motionY ) ) motionX = motionY = 0.0;
+        std::swap ( _current, _previous );
+        _hasPrevious = true;
+        double estimateMs = std::chrono::duration<double, std::milli> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+
+        PathPoint point;
+        point.X = ( _path.empty ( ) ? 0.0 : _path.back ( ).X ) + motionX;
+        point.Y = ( _path.empty ( ) ? 0.0 : _path.back ( ).Y ) + motionY;
+        point.Timestamp = timestamp;
+        _path.push_back ( point );
+
+        // Smooth
+        const int32_t lookahead = std::max ( 0, _options.Lookahead ( ) );
+        const uint8_t* source = src;
+        ptrdiff_t sourceRowBytes = srcRowBytes;
+        PathPoint due = point;
+        double smoothX = 0.0, smoothY = 0.0;
+
+        if ( lookahead == 0 )
+        {
+            if ( _path.size ( ) == 1 )
+            {
+                _smoothX = point.X;
+                _smoothY = point.Y;
+            }
+
+            const double smoothing = std::clamp ( _options.Smoothing ( ), 0.0, 0.999 );
+            _smoothX = smoothing * _smoothX + ( 1.0 - smoothing ) * point.X;
+            _smoothY = smoothing * _smoothY + ( 1.0 - smoothing ) * point.Y;
+            smoothX = _smoothX;
+            smoothY = _smoothY;
+
+            while ( _path.size ( ) > 1 ) _path.pop_front ( );
+        } else
+        {
+            // Hold a copy of the frame until the path is known lookahead frames past it
+            std::vector<uint8_t> copy;
+            if ( !_spare.empty ( ) )
+            {
+                copy = std::move ( _spare.back ( ) );
+                _spare.pop_back ( );
+            }
+
+            const size_t rowBytes = (size_t)dst.Size.x * 4;
+            copy.resize ( rowBytes * (size_t)dst.Size.y );
+            for ( int32_t y = 0; y < dst.Size.y; y++ ) std::memcpy ( copy.data ( ) + rowBytes * y, src + srcRowBytes * y, rowBytes );
+            _pending.push_back ( std::move ( copy ) );
+
+            while ( _path.size ( ) > (size_t)lookahead * 2 + 1 ) _path.pop_front ( );
+            if ( _pending.size ( ) <= (size_t)lookahead ) return false;
+
+            // Gaussian over the window either side of the due frame, as much of it as there is
+            const size_t index = _path.size ( ) - 1 - (size_t)lookahead;
+            const double sigma = std::max ( 1.0, lookahead * 0.5 );
+            double sum = 0.0;
+            for ( size_t i = 0; i < _path.size ( ); i++ )
+            {
+                double offset = (double)i - (double)index;
+                double weight = std::exp ( -offset * offset / ( 2.0 * sigma * sigma ) );
+                smoothX += _path[i].X * weight;
+                smoothY += _path[i].Y * weight;
+                sum += weight;
+            }
+
+            smoothX /= sum;
+            smoothY /= sum;
+            due = _path[index];
+            source = _pending.front ( ).data ( );
+            sourceRowBytes = (ptrdiff_t)rowBytes;
+        }
+
+        // Correct: shift by how far the camera is from where the smoothed path says it should
+        // be, within what the crop leaves spare
+        const double crop = std::clamp ( _options.Crop ( ), 0.0, 0.4 );
+        const double limitX = crop * dst.Size.x, limitY = crop * dst.Size.y;
+        double correctionX = std::clamp ( due.X - smoothX, -limitX, limitX );
+        double correctionY = std::clamp ( due.Y - smoothY, -limitY, limitY );
+        if ( lookahead == 0 )
+        {
+            // Drag the smoothed path along rather than let it fall further behind than the crop allows
+            _smoothX = due.X - correctionX;
+            _smoothY = due.Y - correctionY;
+        }
+
+        const double scale = 1.0 - crop * 2.0;
+        const double cx = ( dst.Size.x - 1 ) * 0.5, cy = ( dst.Size.y - 1 ) * 0.5;
+        auto options = _warp.GetOptions ( );
+        options.GridStep ( 64 ).Homography ( { scale, 0.0, cx * ( 1.0 - scale ) + correctionX, 0.0, scale, cy * ( 1.0 - scale ) + correctionY, 0.0, 0.0, 1.0 } );
+        _warp.SetOptions ( options );
+        _warp.Process ( source, sourceRowBytes, dst.Size, dst );
+        dueTimestamp = due.Timestamp;
+
+        if ( lookahead > 0 )
+        {
+            _spare.push_back ( std::move ( _pending.front ( ) ) );
+            _pending.pop_front ( );
+        }
+
+        // Single writer, so a plain load/store is enough to accumulate
+        _estimateSumMs.store ( _estimateSumMs.load ( std::memory_order_relaxed ) + estimateMs, std::memory_order_relaxed );
+        _lastEstimateMs.store ( estimateMs, std::memory_order_relaxed );
+        _motionX.store ( motionX, std::memory_order_relaxed );
+        _motionY.store ( motionY, std::memory_order_relaxed );
+        _correctionX.store ( correctionX, std::memory_order_relaxed );
+        _correctionY.store ( correctionY, std::memory_order_relaxed );
+        _frames.fetch_add ( 1, std::memory_order_release );
+        return true;
+    }
+}
@@ -0,0 +1,123 @@
+//
+//  AX-VideoCaptureStabilize.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureRemap.h"
+#include <atomic>
+#include <deque>
+
+namespace AX::Video
+{
+    struct StabilizeOptions
+    {
+        StabilizeOptions ( ) { };
+        StabilizeOptions ( bool enabled ) : _enabled ( enabled ) { };
+
+        StabilizeOptions& Enabled ( bool enabled ) { _enabled = enabled; return *this; }
+        // Fraction of each edge given up to absorb the shake. Corrections are clamped to it.
+        StabilizeOptions& Crop ( double margin ) { _crop = margin; return *this; }
+        // 0 .. 1, how much of the camera's own movement is smoothed away. Lookahead 0 only.
+        StabilizeOptions& Smoothing ( double smoothing ) { _smoothing = smoothing; return *this; }
+        // Frames to wait for before correcting one, smoothing over the path either side of it.
+        // Better steadiness for that many frames of latency.
+        StabilizeOptions& Lookahead ( int32_t frames ) { _lookahead = frames; return *this; }
+        // Largest shake followed between two frames, in source pixels
+        StabilizeOptions& SearchRange ( int32_t pixels ) { _searchRange = pixels; return *this; }
+
+        bool                IsEnabled ( ) const { return _enabled; }
+        double              Crop ( ) const { return _crop; }
+        double              Smoothing ( ) const { return _smoothing; }
+        int32_t             Lookahead ( ) const { return _lookahead; }
+        int32_t             SearchRange ( ) const { return _searchRange; }
+
+    protected:
+
+        bool                _enabled{ false };
+        double              _crop{ 0.05 };
+        double              _smoothing{ 0.9 };
+        int32_t             _lookahead{ 0 };
+        int32_t             _searchRange{ 64 };
+    };
+
+    // Global (translational) motion is estimated by block matching a two level pyramid of
+    // downsampled brightness, built from a fraction of the frame's rows with SSE2 SADs, so it
+    // costs well under a millisecond at 1080p. The smoothed path's correction is then applied
+    // as a shift and crop while writing the output, through a Remapper.
+    class Stabilizer
+    {
+    public:
+
+        struct Stats
+        {
+            uint64_t    Frames{ 0 };
+            double      EstimateMs{ 0.0 };      // Mean
+            double      LastEstimateMs{ 0.0 };
+            double      MotionX{ 0.0 };         // Last frame to frame motion, in source pixels
+            double      MotionY{ 0.0 };
+            double      CorrectionX{ 0.0 };     // Last shift applied
+            double      CorrectionY{ 0.0 };
+        };
+
+        Stabilizer                  ( const StabilizeOptions& options = { } ) : _options ( options ) { }
+
+        const StabilizeOptions&     GetOptions ( ) const { return _options; }
+        Stats                       GetStats ( ) const;
+
+        // Feeds in src (dst.Size, 4 bytes per pixel) taken at timestamp and writes the frame
+        // that's due out into dst, Lookahead frames behind src. Returns false, leaving dst
+        // alone, while the lookahead fills. src and dst mustn't overlap.
+        bool                        Process ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, double timestamp, double& dueTimestamp );
+        // Applied to the output along with the correction, see Remapper::SetView
+        void                        SetView ( const std::array<double, 9>& view ) { _warp.SetView ( view ); }
+        // Forgets the path, e.g. after a format change
+        void                        Reset ( );
+
+    protected:
+
+        struct Level
+        {
+            Vec2i                   Size;
+            std::vector<uint8_t>    Pixels;
+        };
+
+        struct PathPoint
+        {
+            double                  X{ 0.0 };
+            double                  Y{ 0.0 };
+            double                  Timestamp{ 0.0 };
+        };
+
+        void                        BuildPyramid ( const uint8_t* src, ptrdiff_t srcRowBytes, const Vec2i& size, Level* levels ) const;
+        bool                        EstimateMotion ( double& x, double& y ) const;
+
+        StabilizeOptions            _options;
+        Vec2i                       _size;
+        Level                       _current[2];
+        Level                       _previous[2];
+        bool                        _hasPrevious{ false };
+
+        std::deque<PathPoint>       _path;          // Oldest first, the frame due out is at the front once full
+        std::deque<std::vector<uint8_t>> _pending;  // Frames waiting on the lookahead, paired with the path's tail
+        std::vector<std::vector<uint8_t>> _spare;
+        double                      _smoothX{ 0.0 };
+        double                      _smoothY{ 0.0 };
+        Remapper                    _warp;
+
+        // Written by whoever calls Process and read from anywhere, so plain atomics rather
+        // than a lock. A snapshot can mix fields from consecutive frames.
+        std::atomic<uint64_t>       _frames{ 0 };
+        std::atomic<double>         _estimateSumMs{ 0.0 };
+        std::atomic<double>         _lastEstimateMs{ 0.0 };
+        std::atomic<double>         _motionX{ 0.0 };
+        std::atomic<double>         _motionY{ 0.0 };
+        std::atomic<double>         _correctionX{ 0.0 };
+        std::atomic<double>         _correctionY{ 0.0 };
+    };
+}
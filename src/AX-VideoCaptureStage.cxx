@@ -0,0 +1,226 @@
+//
+//  AX-VideoCaptureStage.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureStage.h"
+
+namespace AX::Video
+{
+    namespace
+    {
+        // Items a drain task runs before handing its worker back, so a busy stage can't starve
+        // the others (or the captures' own work) on the shared executor
+        constexpr size_t kMaxBatch = 16;
+
+        // Several drain tasks can finish at once
+        void Accumulate ( std::atomic<double>& target, double value )
+        {
+            double sum = target.load ( std::memory_order_relaxed );
+            while ( !target.compare_exchange_weak ( sum, sum + value, std::memory_order_relaxed ) ) { }
+        }
+    }
+
+    const char * ToString ( DropPolicy policy )
+    {
+        switch ( policy )
+        {
+            case DropPolicy::DropNewest:    return "DropNewest";
+            case DropPolicy::DropOldest:    return "DropOldest";
+            case DropPolicy::LatestWins:    return "LatestWins";
+        }
+
+        return "Unknown";
+    }
+
+    const char * ToString ( DeadlinePolicy policy )
+    {
+        switch ( policy )
+        {
+            case DeadlinePolicy::Skip:      return "Skip";
+            case DeadlinePolicy::Cancel:    return "Cancel";
+        }
+
+        return "Unknown";
+    }
+
+    bool StageContext::IsCancelled ( ) const
+    {
+        if ( _stage.IsStale ( _sequence ) ) return true;
+        return _stage.GetDeadlinePolicy ( ) == DeadlinePolicy::Cancel && IsLate ( );
+    }
+
+    bool StageContext::IsLate ( ) const
+    {
+        return _deadline < std::numeric_limits<double>::infinity ( ) && _stage.GetTime ( ) > _deadline;
+    }
+
+    PipelineState::PipelineState ( const std::function<double ( )>& clock )
+        : Now ( clock )
+    {
+        if ( !Now )
+        {
+            Now = [] { return std::chrono::duration<double> ( std::chrono::steady_clock::now ( ).time_since_epoch ( ) ).count ( ); };
+        }
+    }
+
+    void PipelineState::Stop ( )
+    {
+        std::unique_lock<std::mutex> lock ( Mutex );
+        IsAlive.store ( false );
+        Idle.wait ( lock, [&] { return InFlight == 0; } );
+    }
+
+    StageBase::StageBase ( const std::shared_ptr<PipelineState>& state, const std::string& name, const StageOptions& options )
+        : _state ( state )
+        , _name ( name )
+        , _priority ( options.Priority ( ) )
+        , _parallelism ( std::max<size_t> ( 1, options.Parallelism ( ) ) )
+        , _drop ( (int32_t)options.Drop ( ) )
+        , _budget ( options.Budget ( ) )
+        , _deadline ( (int32_t)options.Deadline ( ) )
+    {
+    }
+
+    void StageBase::SetParallelism ( size_t count )
+    {
+        _parallelism.store ( std::max<size_t> ( 1, count ) );
+        Schedule ( );
+    }
+
+    bool StageBase::IsStale ( uint64_t sequence ) const
+    {
+        if ( !_state->IsAlive.load ( ) ) return true;
+        return GetDropPolicy ( ) == DropPolicy::LatestWins && sequence < _latest.load ( std::memory_order_acquire );
+    }
+
+    double StageBase::GetDeadline ( double timestamp ) const
+    {
+        const double budget = _budget.load ( );
+        return budget > 0.0 ? timestamp + budget : std::numeric_limits<double>::infinity ( );
+    }
+
+    uint64_t StageBase::NextSequence ( )
+    {
+        const uint64_t sequence = _sequence.fetch_add ( 1, std::memory_order_relaxed ) + 1;
+        uint64_t latest = _latest.load ( std::memory_order_relaxed );
+        while ( latest < sequence && !_latest.compare_exchange_weak ( latest, sequence, std::memory_order_release, std::memory_order_relaxed ) ) { }
+        return sequence;
+    }
+
+    void StageBase::Schedule ( )
+    {
+        // Pairs with the one in Drain: either the pusher sees the slot given back, or the
+        // drain task sees the item, so nothing's left sitting in the queue
+        std::atomic_thread_fence ( std::memory_order_seq_cst );
+        while ( _state->IsAlive.load ( ) && GetQueueDepth ( ) > 0 && TryClaim ( ) ) Submit ( );
+    }
+
+    bool StageBase::TryClaim ( )
+    {
+        size_t running = _running.load ( );
+        while ( running < _parallelism.load ( ) )
+        {
+            if ( _running.compare_exchange_weak ( running, running + 1 ) ) return true;
+        }
+
+        return false;
+    }
+
+    void StageBase::Submit ( )
+    {
+        {
+            std::lock_guard<std::mutex> lock ( _state->Mutex );
+            _state->InFlight++;
+        }
+
+        Executor::Get ( )->Submit ( [self = shared_from_this ( )] { self->Drain ( ); }, _priority );
+    }
+
+    void StageBase::Drain ( )
+    {
+        size_t count = 0;
+        while ( count < kMaxBatch && _state->IsAlive.load ( ) && RunOne ( ) ) count++;
+
+        if ( count == kMaxBatch && _state->IsAlive.load ( ) && GetQueueDepth ( ) > 0 )
+        {
+            // Still busy, go to the back of the executor's queue and keep the slot
+            Submit ( );
+        } else
+        {
+            _running.fetch_sub ( 1 );
+            Schedule ( );
+        }
+
+        std::lock_guard<std::mutex> lock ( _state->Mutex );
+        if ( --_state->InFlight == 0 ) _state->Idle.notify_all ( );
+    }
+
+    void StageBase::RecordDepth ( size_t depth )
+    {
+        size_t max = _maxDepth.load ( std::memory_order_relaxed );
+        while ( depth > max && !_maxDepth.compare_exchange_weak ( max, depth, std::memory_order_relaxed ) ) { }
+    }
+
+    void StageBase::RecordProcessed ( Clock::time_point pushed, Clock::time_point started, bool emitted, bool cancelled, bool late )
+    {
+        const auto now = Clock::now ( );
+        const double latency = std::chrono::duration<double> ( now - pushed ).count ( );
+        const double process = std::chrono::duration<double> ( now - started ).count ( );
+
+        _processed.fetch_add ( 1, std::memory_order_relaxed );
+        if ( emitted ) _emitted.fetch_add ( 1, std::memory_order_relaxed );
+        if ( cancelled ) _cancelled.fetch_add ( 1, std::memory_order_relaxed );
+        if ( late ) _late.fetch_add ( 1, std::memory_order_relaxed );
+        Accumulate ( _latencySum, latency );
+        Accumulate ( _processSum, process );
+        _latency.Record ( latency );
+        _process.Record ( process );
+    }
+
+    StageStats StageBase::GetStats ( ) const
+    {
+        StageStats stats;
+        stats.Name = _name;
+        stats.Received = _received.load ( std::memory_order_relaxed );
+        stats.Processed = _processed.load ( std::memory_order_relaxed );
+        stats.Emitted = _emitted.load ( std::memory_order_relaxed );
+        stats.Dropped = _dropped.load ( std::memory_order_relaxed );
+        stats.Cancelled = _cancelled.load ( std::memory_order_relaxed );
+        stats.Expired = _expired.load ( std::memory_order_relaxed );
+        stats.Late = _late.load ( std::memory_order_relaxed );
+        stats.QueueDepth = GetQueueDepth ( );
+        stats.MaxQueueDepth = _maxDepth.load ( std::memory_order_relaxed );
+        stats.Running = _running.load ( std::memory_order_relaxed );
+
+        if ( stats.Processed > 0 )
+        {
+            stats.MeanLatencyMs = _latencySum.load ( std::memory_order_relaxed ) / (double)stats.Processed * 1000.0;
+            stats.MeanProcessMs = _processSum.load ( std::memory_order_relaxed ) / (double)stats.Processed * 1000.0;
+            stats.P95LatencyMs = _latency.Percentile ( 0.95 ) * 1000.0;
+            stats.P95ProcessMs = _process.Percentile ( 0.95 ) * 1000.0;
+        }
+
+        return stats;
+    }
+
+    void StageBase::ResetStats ( )
+    {
+        _received.store ( 0 );
+        _processed.store ( 0 );
+        _emitted.store ( 0 );
+        _dropped.store ( 0 );
+        _cancelled.store ( 0 );
+        _expired.store ( 0 );
+        _late.store ( 0 );
+        _maxDepth.store ( 0 );
+        _latencySum.store ( 0.0 );
+        _processSum.store ( 0.0 );
+        _latency.Reset ( );
+        _process.Reset ( );
+    }
+}
@@ -0,0 +1,325 @@
+//
+//  AX-VideoCaptureStage.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include "AX-VideoCaptureExecutor.h"
+#include "AX-VideoCaptureQueue.h"
+#include <chrono>
+#include <limits>
+#include <optional>
+
+namespace AX::Video
+{
+    // What a stage does when its queue is full
+    enum class DropPolicy
+    {
+        DropNewest,     // Turn the new item away
+        DropOldest,     // Make room by discarding the oldest queued item
+        LatestWins      // As DropOldest, and anything older than the newest item is cancelled
+                        // too, whether queued or already running (see StageContext::IsCancelled)
+    };
+
+    const char * ToString ( DropPolicy policy );
+
+    // What a stage does with items that have run past their Budget
+    enum class DeadlinePolicy
+    {
+        Skip,           // Items already late when a worker reaches them aren't run, running ones finish
+        Cancel          // As Skip, and a running item is cancelled once it's late, its output discarded
+    };
+
+    const char * ToString ( DeadlinePolicy policy );
+
+    struct StageOptions
+    {
+        StageOptions ( ) { };
+
+        // Items run at once, each on its own executor task. Output order isn't kept above 1.
+        StageOptions& Parallelism ( size_t count ) { _parallelism = count; return *this; }
+        // Queued items (rounded up to a power of two), not counting the ones running
+        StageOptions& Capacity ( size_t count ) { _capacity = count; return *this; }
+        StageOptions& Drop ( DropPolicy policy ) { _drop = policy; return *this; }
+        StageOptions& Priority ( Executor::Priority priority ) { _priority = priority; return *this; }
+        // Seconds from an item's timestamp (the frame's, on the pipeline's clock) it has to be
+        // finished by, 0 for no deadline. Timestamps are carried down the chain, so the budget
+        // counts from capture rather than from reaching this stage.
+        StageOptions& Budget ( double seconds ) { _budget = seconds; return *this; }
+        StageOptions& Deadline ( DeadlinePolicy policy ) { _deadline = policy; return *this; }
+
+        size_t              Parallelism ( ) const { return _parallelism; }
+        size_t              Capacity ( ) const { return _capacity; }
+        DropPolicy          Drop ( ) const { return _drop; }
+        Executor::Priority  Priority ( ) const { return _priority; }
+        double              Budget ( ) const { return _budget; }
+        DeadlinePolicy      Deadline ( ) const { return _deadline; }
+
+    protected:
+
+        size_t              _parallelism{ 1 };
+        size_t              _capacity{ 4 };
+        DropPolicy          _drop{ DropPolicy::DropOldest };
+        Executor::Priority  _priority{ Executor::Priority::Frame };
+        double              _budget{ 0.0 };
+        DeadlinePolicy      _deadline{ DeadlinePolicy::Skip };
+    };
+
+    struct StageStats
+    {
+        std::string Name;
+        uint64_t    Received{ 0 };
+        uint64_t    Processed{ 0 };
+        uint64_t    Emitted{ 0 };           // Processed items that produced an output
+        uint64_t    Dropped{ 0 };           // By the drop policy, never run
+        uint64_t    Cancelled{ 0 };         // Made stale by a newer item under LatestWins
+        uint64_t    Expired{ 0 };           // Already past the deadline when reached, never run
+        uint64_t    Late{ 0 };              // Finished past the deadline, discarded under DeadlinePolicy::Cancel
+        size_t      QueueDepth{ 0 };
+        size_t      MaxQueueDepth{ 0 };
+        size_t      Running{ 0 };
+        double      MeanLatencyMs{ 0.0 };   // Pushed to finished, queueing included
+        double      P95LatencyMs{ 0.0 };
+        double      MeanProcessMs{ 0.0 };
+        double      P95ProcessMs{ 0.0 };
+    };
+
+    class StageBase;
+
+    // Handed to a stage's function along with each item
+    class StageContext
+    {
+    public:
+
+        StageContext                ( const StageBase& stage, uint64_t sequence, double timestamp, double deadline )
+            : _stage ( stage ), _sequence ( sequence ), _timestamp ( timestamp ), _deadline ( deadline ) { }
+
+        // Under LatestWins, true once a newer item has arrived, and under DeadlinePolicy::Cancel
+        // once the item's late, so long running work can give up early. Its output would be
+        // discarded anyway. Also true while the pipeline stops.
+        bool                        IsCancelled ( ) const;
+        bool                        IsLate ( ) const;
+        uint64_t                    GetSequence ( ) const { return _sequence; }
+        double                      GetTimestamp ( ) const { return _timestamp; }
+        // Infinite without a Budget
+        double                      GetDeadline ( ) const { return _deadline; }
+
+    protected:
+
+        const StageBase&            _stage;
+        uint64_t                    _sequence{ 0 };
+        double                      _timestamp{ 0.0 };
+        double                      _deadline{ 0.0 };
+    };
+
+    // A pushed item's timestamp, for its deadline. Overload for your own types to carry one,
+    // anything else is stamped as it's pushed. Zero or less counts as none, which is what a
+    // frame built by the host (rather than a capture) has.
+    inline double TimestampOf ( const FrameRef& frame ) { return frame ? frame->GetTimestamp ( ) : -1.0; }
+    template <typename T>
+    double TimestampOf ( const T& ) { return -1.0; }
+
+    // Shared by every stage of a pipeline, so it can wait out their work when it stops
+    struct PipelineState
+    {
+        // Steady clock seconds unless given the clock item timestamps are on
+        PipelineState               ( const std::function<double ( )>& clock = { } );
+
+        // Stops running new items and waits for the ones running to finish. Running items see
+        // themselves cancelled, queued ones are never started.
+        void                        Stop ( );
+
+        std::function<double ( )>   Now;
+        std::atomic_bool            IsAlive{ true };
+        std::mutex                  Mutex;
+        std::condition_variable     Idle;
+        size_t                      InFlight{ 0 };
+    };
+
+    // The untyped half of a stage: scheduling, the drop policy and stats
+    class StageBase : public std::enable_shared_from_this<StageBase>
+    {
+    public:
+
+        virtual                     ~StageBase ( ) { };
+
+        const std::string&          GetName ( ) const { return _name; }
+        size_t                      GetParallelism ( ) const { return _parallelism.load ( ); }
+        DropPolicy                  GetDropPolicy ( ) const { return (DropPolicy)_drop.load ( ); }
+        // Any thread, take effect from the next item
+        void                        SetParallelism ( size_t count );
+        void                        SetDropPolicy ( DropPolicy policy ) { _drop.store ( (int32_t)policy ); }
+        double                      GetBudget ( ) const { return _budget.load ( ); }
+        DeadlinePolicy              GetDeadlinePolicy ( ) const { return (DeadlinePolicy)_deadline.load ( ); }
+        void                        SetBudget ( double seconds ) { _budget.store ( seconds ); }
+        void                        SetDeadlinePolicy ( DeadlinePolicy policy ) { _deadline.store ( (int32_t)policy ); }
+
+        StageStats                  GetStats ( ) const;
+        void                        ResetStats ( );
+
+        // Whether an item with this sequence has been superseded, see StageContext::IsCancelled
+        bool                        IsStale ( uint64_t sequence ) const;
+        // For an item with timestamp, under the current budget
+        double                      GetDeadline ( double timestamp ) const;
+        // On the pipeline's clock
+        double                      GetTime ( ) const { return _state->Now ( ); }
+
+    protected:
+
+        using Clock = std::chrono::steady_clock;
+
+        StageBase                   ( const std::shared_ptr<PipelineState>& state, const std::string& name, const StageOptions& options );
+
+        virtual size_t              GetQueueDepth ( ) const = 0;
+        // Pops and runs one item, false if there wasn't one
+        virtual bool                RunOne ( ) = 0;
+
+        // Any thread, after a push. Starts drain tasks up to the parallelism.
+        void                        Schedule ( );
+        bool                        TryClaim ( );
+        void                        Submit ( );
+        // Executor
+        void                        Drain ( );
+
+        uint64_t                    NextSequence ( );
+        void                        RecordDepth ( size_t depth );
+        void                        RecordProcessed ( Clock::time_point pushed, Clock::time_point started, bool emitted, bool cancelled, bool late );
+
+        std::shared_ptr<PipelineState> _state;
+        std::string                 _name;
+        Executor::Priority          _priority;
+        std::atomic<size_t>         _parallelism{ 1 };
+        std::atomic<int32_t>        _drop{ 0 };
+        std::atomic<double>         _budget{ 0.0 };
+        std::atomic<int32_t>        _deadline{ 0 };
+        std::atomic<size_t>         _running{ 0 };
+        std::atomic<uint64_t>       _sequence{ 0 };
+        std::atomic<uint64_t>       _latest{ 0 };   // Newest item's sequence
+
+        std::atomic<uint64_t>       _received{ 0 };
+        std::atomic<uint64_t>       _processed{ 0 };
+        std::atomic<uint64_t>       _emitted{ 0 };
+        std::atomic<uint64_t>       _dropped{ 0 };
+        std::atomic<uint64_t>       _cancelled{ 0 };
+        std::atomic<uint64_t>       _expired{ 0 };
+        std::atomic<uint64_t>       _late{ 0 };
+        std::atomic<size_t>         _maxDepth{ 0 };
+        std::atomic<double>         _latencySum{ 0.0 };
+        std::atomic<double>         _processSum{ 0.0 };
+        DurationHistogram           _latency;
+        DurationHistogram           _process;
+    };
+
+    // Takes In, produces Out (or nothing, by returning std::nullopt) for every stage connected
+    // after it. In and Out need to be default constructible and movable, Out copyable when it
+    // fans out to more than one stage.
+    template <typename In, typename Out>
+    class Stage : public StageBase
+    {
+    public:
+
+        using Fn = std::function<std::optional<Out> ( In& input, const StageContext& context )>;
+
+        Stage                       ( const std::shared_ptr<PipelineState>& state, const std::string& name, const StageOptions& options, const Fn& fn )
+            : StageBase ( state, name, options ), _fn ( fn ), _queue ( std::max<size_t> ( 1, options.Capacity ( ) ) ) { }
+
+        // Connect before the first Push, the outputs aren't guarded
+        template <typename Next>
+        void                        Connect ( const std::shared_ptr<Stage<Out, Next>>& next )
+        {
+            _outputs.push_back ( [next] ( Out value, double timestamp ) { next->Push ( std::move ( value ), timestamp ); } );
+        }
+
+        // Any thread. False if the item was turned away. Without a timestamp (zero or less)
+        // it's taken from TimestampOf, or failing that, now.
+        bool                        Push ( In value, double timestamp = -1.0 )
+        {
+            if ( !_state->IsAlive.load ( ) ) return false;
+
+            _received.fetch_add ( 1, std::memory_order_relaxed );
+            if ( timestamp <= 0.0 ) timestamp = TimestampOf ( value );
+            if ( timestamp <= 0.0 ) timestamp = GetTime ( );
+            Item item{ std::move ( value ), NextSequence ( ), timestamp, Clock::now ( ) };
+            bool isPushed = _queue.TryPush ( item );
+            while ( !isPushed && GetDropPolicy ( ) != DropPolicy::DropNewest )
+            {
+                Item oldest;
+                if ( _queue.TryPop ( oldest ) ) _dropped.fetch_add ( 1, std::memory_order_relaxed );
+                isPushed = _queue.TryPush ( item );
+            }
+
+            if ( !isPushed )
+            {
+                _dropped.fetch_add ( 1, std::memory_order_relaxed );
+                return false;
+            }
+
+            RecordDepth ( _queue.Size ( ) );
+            Schedule ( );
+            return true;
+        }
+
+    protected:
+
+        struct Item
+        {
+            In                      Value{ };
+            uint64_t                Sequence{ 0 };
+            double                  Timestamp{ 0.0 };
+            Clock::time_point       Pushed;
+        };
+
+        size_t                      GetQueueDepth ( ) const override { return _queue.Size ( ); }
+
+        bool                        RunOne ( ) override
+        {
+            Item item;
+            if ( !_queue.TryPop ( item ) ) return false;
+
+            if ( IsStale ( item.Sequence ) )
+            {
+                _cancelled.fetch_add ( 1, std::memory_order_relaxed );
+                return true;
+            }
+
+            // Late already, so skip it for whatever's queued behind it, which is fresher
+            const double deadline = GetDeadline ( item.Timestamp );
+            const bool hasDeadline = deadline < std::numeric_limits<double>::infinity ( );
+            if ( hasDeadline && GetTime ( ) > deadline )
+            {
+                _expired.fetch_add ( 1, std::memory_order_relaxed );
+                return true;
+            }
+
+            const auto started = Clock::now ( );
+            StageContext context ( *this, item.Sequence, item.Timestamp, deadline );
+            std::optional<Out> out = _fn ? _fn ( item.Value, context ) : std::nullopt;
+            const bool isLate = hasDeadline && GetTime ( ) > deadline;
+            // Counted whether or not it produced anything, a sink's superseded work is still wasted
+            const bool isCancelled = IsStale ( item.Sequence );
+            const bool isEmitted = out && !isCancelled && !( isLate && GetDeadlinePolicy ( ) == DeadlinePolicy::Cancel );
+            RecordProcessed ( item.Pushed, started, isEmitted, isCancelled, isLate );
+
+            if ( isEmitted )
+            {
+                for ( size_t i = 0; i < _outputs.size ( ); i++ )
+                {
+                    if ( i + 1 < _outputs.size ( ) ) _outputs[i] ( *out, item.Timestamp );
+                    else _outputs[i] ( std::move ( *out ), item.Timestamp );
+                }
+            }
+
+            return true;
+        }
+
+        Fn                          _fn;
+        BoundedQueue<Item>          _queue;
+        std::vector<std::function<void ( Out value, double timestamp )>> _outputs;
+    };
+}
@@ -0,0 +1,255 @@
+//
+//  AX-VideoCaptureStats.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureStats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr double kBucketsPerOctave = 4.0;
+
+        inline size_t BucketForMicroseconds ( double us )
+        {
+            if ( us <= 1.0 ) return 0;
+            auto index = (size_t)( std::log2 ( us ) * kBucketsPerOctave );
+            return std::min ( index, DurationHistogram::kNumBuckets - 1 );
+        }
+
+        inline double MicrosecondsForBucket ( size_t index )
+        {
+            // Geometric centre of the bucket
+            return std::exp2 ( ( (double)index + 0.5 ) / kBucketsPerOctave );
+        }
+
+        // Single writer (Reset hands the clearing to it too), so a plain load/store is enough to accumulate
+        inline void Accumulate ( std::atomic<double>& target, double value )
+        {
+            target.store ( target.load ( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+        }
+    }
+
+    void DurationHistogram::Record ( double seconds )
+    {
+        _buckets[BucketForMicroseconds ( seconds * 1.0e6 )].fetch_add ( 1, std::memory_order_relaxed );
+    }
+
+    uint64_t DurationHistogram::Count ( ) const
+    {
+        uint64_t count = 0;
+        for ( auto& b : _buckets ) count += b.load ( std::memory_order_relaxed );
+        return count;
+    }
+
+    double DurationHistogram::Percentile ( double p ) const
+    {
+        std::array<uint64_t, kNumBuckets> counts;
+        uint64_t total = 0;
+        for ( size_t i = 0; i < kNumBuckets; i++ )
+        {
+            counts[i] = _buckets[i].load ( std::memory_order_relaxed );
+            total += counts[i];
+        }
+
+        if ( total == 0 ) return 0.0;
+
+        auto target = (uint64_t)std::ceil ( std::clamp ( p, 0.0, 1.0 ) * (double)total );
+        uint64_t seen = 0;
+        for ( size_t i = 0; i < kNumBuckets; i++ )
+        {
+            seen += counts[i];
+            if ( seen >= target && counts[i] > 0 ) return MicrosecondsForBucket ( i ) * 1.0e-6;
+        }
+
+        return MicrosecondsForBucket ( kNumBuckets - 1 ) * 1.0e-6;
+    }
+
+    void DurationHistogram::Reset ( )
+    {
+        for ( auto& b : _buckets ) b.store ( 0, std::memory_order_relaxed );
+    }
+
+    void FrameStatistics::Stage::Record ( double seconds )
+    {
+        if ( seconds < 0.0 ) return;
+
+        // Unlike the frame stats these can come from more than one thread
+        double sum = Sum.load ( std::memory_order_relaxed );
+        while ( !Sum.compare_exchange_weak ( sum, sum + seconds, std::memory_order_relaxed ) ) { }
+        Histogram.Record ( seconds );
+        Count.fetch_add ( 1, std::memory_order_relaxed );
+    }
+
+    void FrameStatistics::Stage::Reset ( )
+    {
+        Count.store ( 0 );
+        Sum.store ( 0.0 );
+        Histogram.Reset ( );
+    }
+
+    FrameStatistics::FrameStatistics ( double expectedFPS )
+    {
+        SetExpectedFPS ( expectedFPS );
+    }
+
+    void FrameStatistics::RecordFrame ( double arrival, double sampleTime, double latency, size_t bytes )
+    {
+        if ( _restart.exchange ( false, std::memory_order_acq_rel ) )
+        {
+            _firstArrival = _lastArrival = arrival;
+            _lastSampleTime = -1.0;
+            ClearFrames ( );
+        }
+
+        // Prefer the device's own clock for spacing, arrival times carry our scheduling noise
+        double previous = sampleTime >= 0.0 ? _lastSampleTime : _lastArrival;
+        double now = sampleTime >= 0.0 ? sampleTime : arrival;
+
+        if ( _frames.load ( std::memory_order_relaxed ) > 0 && previous >= 0.0 )
+        {
+            double interval = now - previous;
+            double expected = _expectedInterval.load ( std::memory_order_relaxed );
+            if ( expected > 0.0 && interval > expected * 1.5 )
+            {
+                // A gap, count what's missing but keep it out of the jitter
+                _dropped.fetch_add ( (uint64_t)std::llround ( interval / expected ) - 1, std::memory_order_relaxed );
+            } else if ( interval > 0.0 )
+            {
+                _intervals.fetch_add ( 1, std::memory_order_relaxed );
+                Accumulate ( _intervalSum, interval );
+                Accumulate ( _intervalSumSq, interval * interval );
+            }
+        }
+
+        if ( latency >= 0.0 )
+        {
+            _latencies.fetch_add ( 1, std::memory_order_relaxed );
+            Accumulate ( _latencySum, latency );
+            _latency.Record ( latency );
+        }
+
+        _lastArrival = arrival;
+        if ( sampleTime >= 0.0 ) _lastSampleTime = sampleTime;
+
+        _elapsed.store ( _lastArrival - _firstArrival, std::memory_order_relaxed );
+        _bytes.fetch_add ( bytes, std::memory_order_relaxed );
+        _frames.fetch_add ( 1, std::memory_order_release );
+    }
+
+    void FrameStatistics::RecordDrop ( uint64_t count )
+    {
+        _dropped.fetch_add ( count, std::memory_order_relaxed );
+    }
+
+    void FrameStatistics::RecordError ( int64_t code )
+    {
+        _errors.fetch_add ( 1, std::memory_order_relaxed );
+
+        for ( auto& slot : _errorCodes )
+        {
+            int64_t current = slot.Code.load ( std::memory_order_acquire );
+            if ( current == ErrorSlot::kUnused && slot.Code.compare_exchange_strong ( current, code, std::memory_order_acq_rel ) )
+            {
+                current = code;
+            }
+
+            if ( current == code )
+            {
+                slot.Count.fetch_add ( 1, std::memory_order_relaxed );
+                return;
+            }
+        }
+    }
+
+    void FrameStatistics::ClearFrames ( )
+    {
+        _frames.store ( 0, std::memory_order_relaxed );
+        _bytes.store ( 0, std::memory_order_relaxed );
+        _elapsed.store ( 0.0, std::memory_order_relaxed );
+        _intervals.store ( 0, std::memory_order_relaxed );
+        _intervalSum.store ( 0.0, std::memory_order_relaxed );
+        _intervalSumSq.store ( 0.0, std::memory_order_relaxed );
+        _latencies.store ( 0, std::memory_order_relaxed );
+        _latencySum.store ( 0.0, std::memory_order_relaxed );
+        _latency.Reset ( );
+    }
+
+    CaptureStats FrameStatistics::Snapshot ( ) const
+    {
+        CaptureStats stats{};
+        stats.FramesDropped = _dropped.load ( std::memory_order_relaxed );
+        stats.Errors = _errors.load ( std::memory_order_relaxed );
+        stats.Restarts = _restarts.load ( std::memory_order_relaxed );
+        for ( auto& slot : _errorCodes )
+        {
+            int64_t code = slot.Code.load ( std::memory_order_acquire );
+            if ( code == ErrorSlot::kUnused ) break;
+            if ( auto count = slot.Count.load ( std::memory_order_relaxed ) ) stats.ErrorCodes.emplace_back ( code, count );
+        }
+
+        if ( auto count = _delivery.Count.load ( std::memory_order_relaxed ) )
+        {
+            stats.DeliveryMs = _delivery.Sum.load ( std::memory_order_relaxed ) / (double)count * 1000.0;
+            stats.DeliveryP95Ms = _delivery.Histogram.Percentile ( 0.95 ) * 1000.0;
+        }
+
+        if ( auto count = _pickup.Count.load ( std::memory_order_relaxed ) )
+        {
+            stats.PickupMs = _pickup.Sum.load ( std::memory_order_relaxed ) / (double)count * 1000.0;
+            stats.PickupP95Ms = _pickup.Histogram.Percentile ( 0.95 ) * 1000.0;
+        }
+
+        // Reset but not yet cleared by the sample thread
+        if ( _restart.load ( std::memory_order_acquire ) ) return stats;
+
+        stats.FramesDelivered = _frames.load ( std::memory_order_acquire );
+        stats.BytesDelivered = _bytes.load ( std::memory_order_relaxed );
+        stats.ElapsedSeconds = _elapsed.load ( std::memory_order_relaxed );
+
+        if ( stats.ElapsedSeconds > 0.0 && stats.FramesDelivered > 1 )
+        {
+            stats.FPS = (double)( stats.FramesDelivered - 1 ) / stats.ElapsedSeconds;
+        }
+
+        auto intervals = _intervals.load ( std::memory_order_relaxed );
+        if ( intervals > 0 )
+        {
+            double mean = _intervalSum.load ( std::memory_order_relaxed ) / (double)intervals;
+            double variance = _intervalSumSq.load ( std::memory_order_relaxed ) / (double)intervals - mean * mean;
+            stats.JitterMs = std::sqrt ( std::max ( 0.0, variance ) ) * 1000.0;
+        }
+
+        auto latencies = _latencies.load ( std::memory_order_relaxed );
+        if ( latencies > 0 )
+        {
+            stats.LatencySamples = latencies;
+            stats.LatencyMs = _latencySum.load ( std::memory_order_relaxed ) / (double)latencies * 1000.0;
+            stats.LatencyP50Ms = _latency.Percentile ( 0.50 ) * 1000.0;
+            stats.LatencyP95Ms = _latency.Percentile ( 0.95 ) * 1000.0;
+            stats.LatencyP99Ms = _latency.Percentile ( 0.99 ) * 1000.0;
+        }
+
+        return stats;
+    }
+
+    void FrameStatistics::Reset ( )
+    {
+        // Everything here is only ever added to atomically, so it's safe to clear from any
+        // thread. The sample thread's running sums it clears itself, see RecordFrame.
+        _dropped.store ( 0 );
+        _delivery.Reset ( );
+        _pickup.Reset ( );
+        _errors.store ( 0 );
+        _restarts.store ( 0 );
+        for ( auto& slot : _errorCodes ) slot.Count.store ( 0 ); // Codes keep their slots
+        _restart.store ( true, std::memory_order_release );
+    }
+}
@@ -0,0 +1,109 @@
+//
+//  AX-VideoCaptureStats.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+#include <array>
+
+namespace AX::Video
+{
+    // Log-scaled histogram of durations in microseconds, 4 buckets per octave.
+    // Safe to Record() from one thread while others read it.
+    class DurationHistogram
+    {
+    public:
+
+        static constexpr size_t kNumBuckets = 128;
+
+        void                        Record ( double seconds );
+        double                      Percentile ( double p ) const; // Seconds
+        uint64_t                    Count ( ) const;
+        void                        Reset ( );
+
+    protected:
+
+        std::array<std::atomic<uint64_t>, kNumBuckets> _buckets{ };
+    };
+
+    // Per-capture frame timing, written from the sample thread and snapshotted from anywhere
+    class FrameStatistics
+    {
+    public:
+
+        FrameStatistics             ( double expectedFPS = 30.0 );
+
+        // Timestamps are in seconds, pass a negative value for anything the source couldn't provide
+        void                        RecordFrame ( double arrival, double sampleTime, double latency, size_t bytes );
+        void                        RecordDrop ( uint64_t count = 1 );
+        // Any thread. Codes past the first kMaxErrorCodes distinct ones only count towards the total.
+        void                        RecordError ( int64_t code );
+        void                        RecordRestart ( ) { _restarts.fetch_add ( 1, std::memory_order_relaxed ); }
+        // Any thread, in seconds. See CaptureStats::DeliveryMs / PickupMs.
+        void                        RecordDelivery ( double seconds ) { _delivery.Record ( seconds ); }
+        void                        RecordPickup ( double seconds ) { _pickup.Record ( seconds ); }
+
+        void                        SetExpectedFPS ( double fps ) { _expectedInterval.store ( fps > 0.0 ? 1.0 / fps : 0.0 ); }
+        CaptureStats                Snapshot ( ) const;
+        // Any thread. The frame timings belong to the sample thread, so they're only cleared
+        // when it records its next frame, and read as zero until then.
+        void                        Reset ( );
+
+        static constexpr size_t     kMaxErrorCodes = 16;
+
+    protected:
+
+        struct Stage
+        {
+            void                    Record ( double seconds );
+            void                    Reset ( );
+
+            std::atomic<uint64_t>   Count{ 0 };
+            std::atomic<double>     Sum{ 0.0 };
+            DurationHistogram       Histogram;
+        };
+
+        // Claimed with a single CAS on Code, so writers never wait on each other
+        struct ErrorSlot
+        {
+            static constexpr int64_t kUnused = INT64_MIN;
+
+            std::atomic<int64_t>    Code{ kUnused };
+            std::atomic<uint64_t>   Count{ 0 };
+        };
+
+        std::atomic<double>         _expectedInterval{ 0.0 };
+        void                        ClearFrames ( );
+
+        std::atomic_bool            _restart{ true };
+
+        // Only touched by the writer
+        double                      _firstArrival{ 0.0 };
+        double                      _lastArrival{ 0.0 };
+        double                      _lastSampleTime{ -1.0 };
+
+        std::atomic<double>         _elapsed{ 0.0 };
+        std::atomic<uint64_t>       _frames{ 0 };
+        std::atomic<uint64_t>       _dropped{ 0 };
+        std::atomic<uint64_t>       _bytes{ 0 };
+        std::atomic<uint64_t>       _intervals{ 0 };
+        std::atomic<double>         _intervalSum{ 0.0 };
+        std::atomic<double>         _intervalSumSq{ 0.0 };
+        std::atomic<uint64_t>       _latencies{ 0 };
+        std::atomic<double>         _latencySum{ 0.0 };
+        DurationHistogram           _latency;
+        Stage                       _delivery;
+        Stage                       _pickup;
+
+        std::atomic<uint64_t>       _errors{ 0 };
+        std::atomic<uint64_t>       _restarts{ 0 };
+        std::array<ErrorSlot, kMaxErrorCodes> _errorCodes;
+    };
+}
@@ -0,0 +1,315 @@
+//
+//  AX-VideoCaptureStitch.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureStitch.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace AX::Video
+{
+    namespace
+    {
+        constexpr double kOne = 65536.0;
+        constexpr uint16_t kWritten = 0xFFFF; // A tile total for pixels a single camera wrote directly
+
+        // Full weight Feather pixels in from the edge, falling off linearly to the edge itself
+        double FeatherWeight ( const Vec2i& size, int32_t feather, double x, double y )
+        {
+            if ( x < 0.0 || y < 0.0 || x > size.x - 1 || y > size.y - 1 ) return 0.0;
+            if ( feather <= 0 ) return 1.0;
+
+            double distance = std::min ( std::min ( x, size.x - 1 - x ), std::min ( y, size.y - 1 - y ) );
+            return std::min ( 1.0, ( distance + 1.0 ) / (double)feather );
+        }
+    }
+
+    Stitcher::Stitcher ( const std::vector<StitchCamera>& cameras, const Options& options )
+        : _options ( options )
+        , _cameras ( cameras )
+    {
+        _step = std::max ( 1, _options.GridStep ( ) );
+        _tileSize = std::max ( _step, _options.TileSize ( ) );
+
+        auto& canvas = _options.Canvas ( );
+        _numTiles = { ( canvas.x + _tileSize - 1 ) / _tileSize, ( canvas.y + _tileSize - 1 ) / _tileSize };
+
+        BuildTables ( );
+    }
+
+    bool Stitcher::ToCamera ( const StitchCamera& camera, double u, double v, double& x, double& y ) const
+    {
+        auto& t = camera.Transform;
+        double px = u, py = v, pz = 1.0;
+
+        if ( _options.Projection ( ) == StitchProjection::Cylindrical )
+        {
+            auto& canvas = _options.Canvas ( );
+            const double focal = _options.Focal ( ) > 0.0 ? _options.Focal ( ) : canvas.x / ( 2.0 * 3.14159265358979323846 );
+            double theta = ( u - canvas.x * 0.5 ) / focal;
+            px = std::sin ( theta );
+            py = ( v - canvas.y * 0.5 ) / focal;
+            pz = std::cos ( theta );
+        }
+
+        double w = t[6] * px + t[7] * py + t[8] * pz;
+        if ( w <= 1.0e-9 ) return false; // Behind the camera
+
+        x = ( t[0] * px + t[1] * py + t[2] * pz ) / w;
+        y = ( t[3] * px + t[4] * py + t[5] * pz ) / w;
+        return true;
+    }
+
+    void Stitcher::BuildTables ( )
+    {
+        auto& canvas = _options.Canvas ( );
+        _tables.assign ( _cameras.size ( ), Table ( ) );
+
+        for ( size_t c = 0; c < _cameras.size ( ); c++ )
+        {
+            auto& camera = _cameras[c];
+            auto& table = _tables[c];
+
+            // Bounds: every grid cell with a corner that lands on the camera, padded by a cell
+            // so the curved edges in between aren't clipped
+            Rect bounds { canvas.x, canvas.y, 0, 0 };
+            for ( int32_t v = 0; v <= canvas.y; v += _step )
+            {
+                for ( int32_t u = 0; u <= canvas.x; u += _step )
+                {
+                    double x, y;
+                    if ( !ToCamera ( camera, u, v, x, y ) || FeatherWeight ( camera.Size, 0, x, y ) <= 0.0 ) continue;
+                    bounds.Left = std::min ( bounds.Left, u );
+                    bounds.Top = std::min ( bounds.Top, v );
+                    bounds.Right = std::max ( bounds.Right, u );
+                    bounds.Bottom = std::max ( bounds.Bottom, v );
+                }
+            }
+
+            if ( bounds.Right < bounds.Left ) continue; // Never reaches the canvas
+
+            table.Bounds.Left = std::max ( 0, bounds.Left - _step );
+            table.Bounds.Top = std::max ( 0, bounds.Top - _step );
+            table.Bounds.Right = std::min ( canvas.x, bounds.Right + _step );
+            table.Bounds.Bottom = std::min ( canvas.y, bounds.Bottom + _step );
+
+            const int32_t width = table.Bounds.Right - table.Bounds.Left;
+            const int32_t height = table.Bounds.Bottom - table.Bounds.Top;
+            table.MapSize = { ( width + _step - 1 ) / _step + 1, ( height + _step - 1 ) / _step + 1 };
+            table.Map.resize ( (size_t)table.MapSize.x * (size_t)table.MapSize.y * 2 );
+
+            for ( int32_t gy = 0; gy < table.MapSize.y; gy++ )
+            {
+                for ( int32_t gx = 0; gx < table.MapSize.x; gx++ )
+                {
+                    double x = -1.0e4, y = -1.0e4;
+                    ToCamera ( camera, table.Bounds.Left + gx * _step, table.Bounds.Top + gy * _step, x, y );
+
+                    auto point = &table.Map[( (size_t)gy * table.MapSize.x + gx ) * 2];
+                    point[0] = (int32_t)std::clamp ( x * kOne, -1.0e9, 1.0e9 );
+                    point[1] = (int32_t)std::clamp ( y * kOne, -1.0e9, 1.0e9 );
+                }
+            }
+
+            // Each camera's share of every pixel it covers, normalised against every other camera
+            // that covers the same pixel
+            table.Weights.assign ( (size_t)width * (size_t)height, 0 );
+            for ( int32_t v = table.Bounds.Top; v < table.Bounds.Bottom; v++ )
+            {
+                for ( int32_t u = table.Bounds.Left; u < table.Bounds.Right; u++ )
+                {
+                    double x, y;
+                    if ( !ToCamera ( camera, u, v, x, y ) ) continue;
+                    double own = FeatherWeight ( camera.Size, _options.Feather ( ), x, y );
+                    if ( own <= 0.0 ) continue;
+
+                    double total = own;
+                    for ( size_t other = 0; other < _cameras.size ( ); other++ )
+                    {
+                        if ( other == c ) continue;
+                        if ( ToCamera ( _cameras[other], u, v, x, y ) ) total += FeatherWeight ( _cameras[other].Size, _options.Feather ( ), x, y );
+                    }
+
+                    uint8_t weight = (uint8_t)std::clamp ( std::lround ( 255.0 * own / total ), 0L, 255L );
+                    table.Weights[(size_t)( v - table.Bounds.Top ) * width + ( u - table.Bounds.Left )] = weight;
+                }
+            }
+        }
+    }
+
+    size_t Stitcher::GetTableBytes ( ) const
+    {
+        size_t bytes = 0;
+        for ( auto& table : _tables ) bytes += table.Map.size ( ) * sizeof ( int32_t ) + table.Weights.size ( );
+        return bytes;
+    }
+
+    void Stitcher::StitchTile ( const std::vector<const Frame*>& frames, const Plane& canvas, int32_t tile ) const
+    {
+        const int32_t left = ( tile % _numTiles.x ) * _tileSize;
+        const int32_t top = ( tile / _numTiles.x ) * _tileSize;
+        const int32_t right = std::min ( left + _tileSize, canvas.Size.x );
+        const int32_t bottom = std::min ( top + _tileSize, canvas.Size.y );
+        const int32_t tileWidth = right - left;
+
+        // Weighted sums for the overlaps, resolved into the canvas once every camera's been through
+        thread_local std::vector<uint32_t> kSums;
+        thread_local std::vector<uint16_t> kTotals;
+        kSums.assign ( (size_t)tileWidth * ( bottom - top ) * 4, 0 );
+        kTotals.assign ( (size_t)tileWidth * ( bottom - top ), 0 );
+
+        for ( size_t c = 0; c < _tables.size ( ); c++ )
+        {
+            auto& table = _tables[c];
+            auto frame = frames[c];
+            if ( !frame || table.Weights.empty ( ) ) continue;
+
+            const int32_t x0 = std::max ( left, table.Bounds.Left );
+            const int32_t x1 = std::min ( right, table.Bounds.Right );
+            const int32_t y0 = std::max ( top, table.Bounds.Top );
+            const int32_t y1 = std::min ( bottom, table.Bounds.Bottom );
+            if ( x0 >= x1 || y0 >= y1 ) continue;
+
+            auto& source = frame->GetPlane ( );
+            const int64_t maxX = (int64_t)( source.Size.x - 1 ) << 16;
+            const int64_t maxY = (int64_t)( source.Size.y - 1 ) << 16;
+            const int32_t tableWidth = table.Bounds.Right - table.Bounds.Left;
+
+            for ( int32_t v = y0; v < y1; v++ )
+            {
+                const int32_t ly = v - table.Bounds.Top;
+                const int32_t gy = ly / _step;
+                const int64_t ty = ly - gy * _step;
+                const int32_t* upper = &table.Map[(size_t)gy * table.MapSize.x * 2];
+                const int32_t* lower = upper + table.MapSize.x * 2;
+                const uint8_t* weights = &table.Weights[(size_t)ly * tableWidth];
+
+                uint8_t* row = canvas.Data + canvas.RowBytes * (ptrdiff_t)v;
+                uint32_t* sums = &kSums[( (size_t)( v - top ) * tileWidth ) * 4];
+                uint16_t* totals = &kTotals[(size_t)( v - top ) * tileWidth];
+
+                for ( int32_t u = x0; u < x1; )
+                {
+                    const int32_t lx = u - table.Bounds.Left;
+                    const int32_t gx = lx / _step;
+                    const int32_t cellEnd = std::min ( table.Bounds.Left + ( gx + 1 ) * _step, x1 );
+
+                    auto Lerp = [&] ( int32_t i ) { return (int64_t)upper[i] + ( ( (int64_t)lower[i] - upper[i] ) * ty ) / _step; };
+                    const int64_t ax = Lerp ( gx * 2 ), ay = Lerp ( gx * 2 + 1 );
+                    const int64_t dx = ( Lerp ( gx * 2 + 2 ) - ax ) / _step;
+                    const int64_t dy = ( Lerp ( gx * 2 + 3 ) - ay ) / _step;
+                    int64_t x = ax + dx * ( lx - gx * _step );
+                    int64_t y = ay + dy * ( lx - gx * _step );
+
+                    for ( ; u < cellEnd; u++, x += dx, y += dy )
+                    {
+                        const uint32_t weight = weights[u - table.Bounds.Left];
+                        if ( weight == 0 || x < 0 || y < 0 || x > maxX || y > maxY ) continue;
+
+                        // Most of the canvas is one camera's alone, straight through to the output
+                        if ( weight == 255 )
+                        {
+                            SampleBilinear ( row + (ptrdiff_t)u * 4, source.Data, source.RowBytes, source.Size, (int32_t)x, (int32_t)y );
+                            totals[u - left] = kWritten;
+                            continue;
+                        }
+
+                        if ( totals[u - left] == kWritten ) continue;
+
+                        uint8_t pixel[4];
+                        SampleBilinear ( pixel, source.Data, source.RowBytes, source.Size, (int32_t)x, (int32_t)y );
+
+                        uint32_t* sum = sums + ( u - left ) * 4;
+                        sum[0] += pixel[0] * weight;
+                        sum[1] += pixel[1] * weight;
+                        sum[2] += pixel[2] * weight;
+                        sum[3] += pixel[3] * weight;
+                        totals[u - left] += (uint16_t)weight;
+                    }
+                }
+            }
+        }
+
+        const uint32_t fill = _options.FillColor ( );
+        for ( int32_t v = top; v < bottom; v++ )
+        {
+            const uint32_t* sums = &kSums[( (size_t)( v - top ) * tileWidth ) * 4];
+            const uint16_t* totals = &kTotals[(size_t)( v - top ) * tileWidth];
+            uint8_t* out = canvas.Data + canvas.RowBytes * (ptrdiff_t)v + (ptrdiff_t)left * 4;
+
+            for ( int32_t i = 0; i < tileWidth; i++, out += 4, sums += 4 )
+            {
+                const uint32_t total = totals[i];
+                if ( total == kWritten )
+                {
+                    continue;
+                } else if ( total == 0 )
+                {
+                    std::memcpy ( out, &fill, 4 );
+                } else if ( total == 255 )
+                {
+                    // Exact divide by 255 for sums up to 255 * 255
+                    for ( int ch = 0; ch < 4; ch++ ) { uint32_t s = sums[ch] + 128; out[ch] = (uint8_t)( ( s + ( s >> 8 ) ) >> 8 ); }
+                } else
+                {
+                    // A camera was missing, or rounding left the shares a little off 255
+                    for ( int ch = 0; ch < 4; ch++ ) out[ch] = (uint8_t)std::min<uint32_t> ( 255, ( sums[ch] + total / 2 ) / total );
+                }
+            }
+        }
+    }
+
+    FrameRef Stitcher::Stitch ( const std::vector<FrameRef>& frames )
+    {
+        auto start = std::chrono::steady_clock::now ( );
+
+        std::vector<const Frame*> sources ( _cameras.size ( ), nullptr );
+        double timestamp = 0.0;
+        bool isComplete = true;
+
+        for ( size_t c = 0; c < _cameras.size ( ); c++ )
+        {
+            auto frame = c < frames.size ( ) ? frames[c].get ( ) : nullptr;
+            if ( frame && frame->GetFormat ( ) == PixelFormat::RGB32 && frame->GetSize ( ) == _cameras[c].Size && frame->GetSize ( ).x >= 2 && frame->GetSize ( ).y >= 2 )
+            {
+                sources[c] = frame;
+                timestamp = std::max ( timestamp, frame->GetTimestamp ( ) );
+            } else
+            {
+                isComplete = false;
+            }
+        }
+
+        auto canvas = _framePool->Acquire ( _options.Canvas ( ), PixelFormat::RGB32 );
+        auto& plane = canvas->GetPlane ( );
+        Executor::Get ( )->ParallelFor ( (size_t)_numTiles.x * (size_t)_numTiles.y, [&] ( size_t tile ) { StitchTile ( sources, plane, (int32_t)tile ); } );
+
+        canvas->SetTimestamp ( timestamp );
+        canvas->SetSequence ( _sequence++ );
+
+        double ms = std::chrono::duration<double, std::milli> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+        _stats.Frames++;
+        if ( !isComplete ) _stats.Incomplete++;
+        _stats.LastMs = ms;
+        _stats.MeanMs += ( ms - _stats.MeanMs ) / (double)_stats.Frames;
+
+        return canvas;
+    }
+
+    FrameRef Stitcher::Stitch ( const FrameBatcher::Batch& batch )
+    {
+        std::vector<FrameRef> frames ( _cameras.size ( ) );
+        for ( auto& entry : batch.Frames )
+        {
+            if ( entry.Source < frames.size ( ) ) frames[entry.Source] = entry.Image;
+        }
+
+        return Stitch ( frames );
+    }
+}
@@ -0,0 +1,126 @@
+//
+//  AX-VideoCaptureStitch.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureBatch.h"
+#include "AX-VideoCaptureFramePool.h"
+#include "AX-VideoCaptureRemap.h"
+
+namespace AX::Video
+{
+    enum class StitchProjection
+    {
+        Planar,         // The canvas is a plane, each camera's Transform is a homography
+        Cylindrical     // The canvas is unrolled from a cylinder, for wide horizontal rigs
+    };
+
+    struct StitchCamera
+    {
+        Vec2i                   Size;   // What this camera's frames arrive at
+        // Row major 3x3 into this camera's pixels. Planar: from canvas pixels (u, v, 1).
+        // Cylindrical: from the ray ( sin θ, h, cos θ ) through the canvas pixel, i.e. the
+        // camera's K * R.
+        std::array<double, 9>   Transform{ 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+    };
+
+    // Warps frames from several cameras into one canvas and feathers the overlaps, on the CPU.
+    // Each camera's warp (a 16.16 grid, as Remapper uses) and per pixel blend weights are
+    // built once, over just the part of the canvas it covers. Canvas tiles are stitched in
+    // parallel on the Executor. Feed it from a FrameBatcher so the frames line up in time.
+    class Stitcher
+    {
+    public:
+
+        struct Options
+        {
+            Options ( ) { };
+
+            Options& Canvas ( const Vec2i& size ) { _canvas = size; return *this; }
+            Options& Projection ( StitchProjection projection ) { _projection = projection; return *this; }
+            // Cylindrical only, canvas pixels per radian. 0 wraps the canvas width around 360°.
+            Options& Focal ( double focal ) { _focal = focal; return *this; }
+            // How far in from a camera's edge its weight ramps up to full, in camera pixels
+            Options& Feather ( int32_t pixels ) { _feather = pixels; return *this; }
+            Options& GridStep ( int32_t step ) { _gridStep = step; return *this; }
+            Options& TileSize ( int32_t size ) { _tileSize = size; return *this; }
+            Options& FillColor ( uint32_t color ) { _fillColor = color; return *this; }
+
+            const Vec2i&        Canvas ( ) const { return _canvas; }
+            StitchProjection    Projection ( ) const { return _projection; }
+            double              Focal ( ) const { return _focal; }
+            int32_t             Feather ( ) const { return _feather; }
+            int32_t             GridStep ( ) const { return _gridStep; }
+            int32_t             TileSize ( ) const { return _tileSize; }
+            uint32_t            FillColor ( ) const { return _fillColor; }
+
+        protected:
+
+            Vec2i               _canvas{ 3840, 1080 };
+            StitchProjection    _projection{ StitchProjection::Planar };
+            double              _focal{ 0.0 };
+            int32_t             _feather{ 64 };
+            int32_t             _gridStep{ 8 };
+            int32_t             _tileSize{ 64 };
+            uint32_t            _fillColor{ 0xFF000000 };
+        };
+
+        struct Stats
+        {
+            uint64_t            Frames{ 0 };
+            uint64_t            Incomplete{ 0 };    // A camera's frame was missing or the wrong size
+            double              LastMs{ 0.0 };
+            double              MeanMs{ 0.0 };
+        };
+
+        Stitcher                ( const std::vector<StitchCamera>& cameras, const Options& options = Options ( ) );
+
+        // frames[i] is cameras[i]'s, a null or wrongly sized frame leaves that camera out.
+        // One call at a time.
+        FrameRef                Stitch ( const std::vector<FrameRef>& frames );
+        // Sources map to cameras by index
+        FrameRef                Stitch ( const FrameBatcher::Batch& batch );
+
+        const Options&          GetOptions ( ) const { return _options; }
+        size_t                  GetTableBytes ( ) const;
+        Stats                   GetStats ( ) const { return _stats; }
+
+    protected:
+
+        struct Rect
+        {
+            int32_t Left{ 0 };
+            int32_t Top{ 0 };
+            int32_t Right{ 0 };
+            int32_t Bottom{ 0 };
+        };
+
+        struct Table
+        {
+            Rect                        Bounds;     // Canvas pixels this camera reaches
+            Vec2i                       MapSize;
+            std::vector<int32_t>        Map;        // 16.16 x, y pairs every GridStep canvas pixels
+            std::vector<uint8_t>        Weights;    // One per Bounds pixel, 255 is all this camera
+        };
+
+        bool                    ToCamera ( const StitchCamera& camera, double u, double v, double& x, double& y ) const;
+        void                    BuildTables ( );
+        void                    StitchTile ( const std::vector<const Frame*>& frames, const Plane& canvas, int32_t tile ) const;
+
+        Options                 _options;
+        std::vector<StitchCamera> _cameras;
+        std::vector<Table>      _tables;
+        int32_t                 _step{ 8 };
+        int32_t                 _tileSize{ 64 };
+        Vec2i                   _numTiles;
+        FramePoolRef            _framePool{ FramePool::Create ( ) };
+        uint64_t                _sequence{ 0 };
+        Stats                   _stats;
+    };
+}
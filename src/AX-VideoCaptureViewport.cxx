@@ -0,0 +1,212 @@
+//
+//  AX-VideoCaptureViewport.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureViewport.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AX::Video
+{
+    namespace
+    {
+        // Longest step Follow takes in one go, so a stall doesn't throw the view across the frame
+        constexpr double kMaxStep = 0.25;
+
+        // Critically damped spring towards target (Game Programming Gems 4, 1.10)
+        double SmoothDamp ( double current, double target, double& velocity, double smoothing, double dt )
+        {
+            const double omega = 2.0 / std::max ( smoothing, 1.0e-4 );
+            const double x = omega * dt;
+            const double decay = 1.0 / ( 1.0 + x + 0.48 * x * x + 0.235 * x * x * x );
+            const double change = current - target;
+            const double temp = ( velocity + omega * change ) * dt;
+            velocity = ( velocity - omega * temp ) * decay;
+            return target + ( change + temp ) * decay;
+        }
+    }
+
+    const char * ToString ( Easing easing )
+    {
+        switch ( easing )
+        {
+            case Easing::Linear:    return "Linear";
+            case Easing::EaseIn:    return "EaseIn";
+            case Easing::EaseOut:   return "EaseOut";
+            case Easing::EaseInOut: return "EaseInOut";
+        }
+
+        return "Unknown";
+    }
+
+    double Ease ( Easing easing, double t )
+    {
+        t = std::clamp ( t, 0.0, 1.0 );
+        switch ( easing )
+        {
+            case Easing::EaseIn:    return t * t * t;
+            case Easing::EaseOut:   { double s = 1.0 - t; return 1.0 - s * s * s; }
+            case Easing::EaseInOut: return t < 0.5 ? 4.0 * t * t * t : 1.0 - std::pow ( -2.0 * t + 2.0, 3.0 ) * 0.5;
+            default:                return t;
+        }
+    }
+
+    void ViewportController::Publish ( Mode mode, const Viewport& viewport, double seconds, Easing easing )
+    {
+        // Claim the sequence by making it odd, waiting out any other writer part way through
+        uint64_t sequence = _sequence.load ( std::memory_order_relaxed );
+        for ( ;; )
+        {
+            if ( sequence & 1 )
+            {
+                sequence = _sequence.load ( std::memory_order_relaxed );
+                continue;
+            }
+
+            if ( _sequence.compare_exchange_weak ( sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed ) ) break;
+        }
+
+        std::atomic_thread_fence ( std::memory_order_release );
+        _mode.store ( (int32_t)mode, std::memory_order_relaxed );
+        _easing.store ( (int32_t)easing, std::memory_order_relaxed );
+        _targetX.store ( viewport.X, std::memory_order_relaxed );
+        _targetY.store ( viewport.Y, std::memory_order_relaxed );
+        _targetZoom.store ( viewport.Zoom, std::memory_order_relaxed );
+        _seconds.store ( seconds, std::memory_order_relaxed );
+        _sequence.store ( sequence + 2, std::memory_order_release );
+    }
+
+    void ViewportController::Set ( const Viewport& viewport )
+    {
+        Publish ( Mode::Set, viewport, 0.0, Easing::Linear );
+    }
+
+    void ViewportController::AnimateTo ( const Viewport& viewport, double seconds, Easing easing )
+    {
+        Publish ( Mode::Animate, viewport, std::max ( 0.0, seconds ), easing );
+    }
+
+    void ViewportController::Follow ( const Viewport& target )
+    {
+        Publish ( Mode::Follow, target, 0.0, Easing::Linear );
+    }
+
+    Viewport ViewportController::GetCurrent ( ) const
+    {
+        Viewport viewport;
+        viewport.X = _currentX.load ( std::memory_order_relaxed );
+        viewport.Y = _currentY.load ( std::memory_order_relaxed );
+        viewport.Zoom = _currentZoom.load ( std::memory_order_relaxed );
+        return viewport;
+    }
+
+    Viewport ViewportController::Clamp ( Viewport viewport ) const
+    {
+        viewport.Zoom = std::clamp ( viewport.Zoom, 1.0, std::max ( 1.0, _options.MaxZoom ( ) ) );
+        const double half = 0.5 / viewport.Zoom;
+        viewport.X = std::clamp ( viewport.X, half, 1.0 - half );
+        viewport.Y = std::clamp ( viewport.Y, half, 1.0 - half );
+        return viewport;
+    }
+
+    Viewport ViewportController::Evaluate ( double time )
+    {
+        const double dt = _lastTime < 0.0 ? 0.0 : std::clamp ( time - _lastTime, 0.0, kMaxStep );
+        _lastTime = time;
+
+        // Pick up a new command, if one's been published and no writer's part way through. A
+        // torn read is just tried again next frame.
+        const uint64_t sequence = _sequence.load ( std::memory_order_acquire );
+        if ( sequence != _lastSequence && !( sequence & 1 ) )
+        {
+            Mode mode = (Mode)_mode.load ( std::memory_order_relaxed );
+            Easing easing = (Easing)_easing.load ( std::memory_order_relaxed );
+            Viewport target;
+            target.X = _targetX.load ( std::memory_order_relaxed );
+            target.Y = _targetY.load ( std::memory_order_relaxed );
+            target.Zoom = _targetZoom.load ( std::memory_order_relaxed );
+            double seconds = _seconds.load ( std::memory_order_relaxed );
+            std::atomic_thread_fence ( std::memory_order_acquire );
+
+            if ( _sequence.load ( std::memory_order_relaxed ) == sequence )
+            {
+                _lastSequence = sequence;
+                if ( mode == Mode::Follow && target.Zoom <= 0.0 ) target.Zoom = _current.Zoom;
+
+                _currentMode = mode;
+                _currentEasing = easing;
+                _target = Clamp ( target );
+                _from = _current;
+                _duration = seconds;
+                _startTime = time;
+
+                // Carry on from the current velocity when following a moving target, anything else starts still
+                if ( mode != Mode::Follow ) std::fill ( std::begin ( _velocity ), std::end ( _velocity ), 0.0 );
+            }
+        }
+
+        switch ( _currentMode )
+        {
+            case Mode::Set:
+            {
+                _current = _target;
+                break;
+            }
+
+            case Mode::Animate:
+            {
+                const double t = _duration > 0.0 ? ( time - _startTime ) / _duration : 1.0;
+                const double e = Ease ( _currentEasing, t );
+                _current.X = _from.X + ( _target.X - _from.X ) * e;
+                _current.Y = _from.Y + ( _target.Y - _from.Y ) * e;
+                _current.Zoom = _from.Zoom * std::pow ( _target.Zoom / _from.Zoom, e );
+                break;
+            }
+
+            case Mode::Follow:
+            {
+                // Only the part of the offset beyond the dead zone is chased, so the target
+                // ends up resting at its edge rather than dragged back to the centre
+                const double deadZone = std::max ( 0.0, _options.FollowDeadZone ( ) ) / _current.Zoom;
+                const double goalX = _target.X - std::clamp ( _target.X - _current.X, -deadZone, deadZone );
+                const double goalY = _target.Y - std::clamp ( _target.Y - _current.Y, -deadZone, deadZone );
+                const double smoothing = _options.FollowSmoothing ( );
+
+                _current.X = SmoothDamp ( _current.X, goalX, _velocity[0], smoothing, dt );
+                _current.Y = SmoothDamp ( _current.Y, goalY, _velocity[1], smoothing, dt );
+                _current.Zoom = std::exp ( SmoothDamp ( std::log ( _current.Zoom ), std::log ( _target.Zoom ), _velocity[2], smoothing, dt ) );
+                break;
+            }
+        }
+
+        _current = Clamp ( _current );
+        _currentX.store ( _current.X, std::memory_order_relaxed );
+        _currentY.store ( _current.Y, std::memory_order_relaxed );
+        _currentZoom.store ( _current.Zoom, std::memory_order_relaxed );
+        return _current;
+    }
+
+    std::array<double, 9> ViewportController::ToMatrix ( const Viewport& viewport, const Vec2i& size )
+    {
+        // The view's first and last output pixels land on the first and last source pixels it
+        // covers, so a view at the frame's edge never samples past it
+        const double w = size.x / viewport.Zoom;
+        const double h = size.y / viewport.Zoom;
+        const double left = viewport.X * size.x - w * 0.5;
+        const double top = viewport.Y * size.y - h * 0.5;
+        const double sx = size.x > 1 ? ( w - 1.0 ) / ( size.x - 1.0 ) : 1.0;
+        const double sy = size.y > 1 ? ( h - 1.0 ) / ( size.y - 1.0 ) : 1.0;
+
+        return { sx, 0.0, left, 0.0, sy, top, 0.0, 0.0, 1.0 };
+    }
+
+    bool ViewportController::IsWholeFrame ( const Viewport& viewport )
+    {
+        return viewport.Zoom <= 1.0 + 1.0e-6;
+    }
+}
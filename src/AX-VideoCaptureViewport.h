@@ -0,0 +1,132 @@
+//
+//  AX-VideoCaptureViewport.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include "AX-VideoCaptureCore.h"
+#include <atomic>
+
+namespace AX::Video
+{
+    // The part of the frame shown, for electronic pan / tilt / zoom
+    struct Viewport
+    {
+        double      X{ 0.5 };       // Centre, 0 .. 1 across the frame
+        double      Y{ 0.5 };       // Centre, 0 .. 1 down the frame
+        double      Zoom{ 1.0 };    // 1 is the whole frame, 2 half its width and height...
+    };
+
+    enum class Easing
+    {
+        Linear,
+        EaseIn,
+        EaseOut,
+        EaseInOut
+    };
+
+    const char * ToString ( Easing easing );
+    // t and the result are 0 .. 1, cubic
+    double Ease ( Easing easing, double t );
+
+    struct ViewportOptions
+    {
+        ViewportOptions ( ) { };
+        ViewportOptions ( bool enabled ) : _enabled ( enabled ) { };
+
+        ViewportOptions& Enabled ( bool enabled ) { _enabled = enabled; return *this; }
+        ViewportOptions& MaxZoom ( double zoom ) { _maxZoom = zoom; return *this; }
+        // Follow's time constant in seconds, longer is smoother but lags the target more
+        ViewportOptions& FollowSmoothing ( double seconds ) { _followSmoothing = seconds; return *this; }
+        // Follow holds still while the target's within this fraction of the view from its
+        // centre, so a jittery tracker doesn't keep nudging the picture
+        ViewportOptions& FollowDeadZone ( double fraction ) { _followDeadZone = fraction; return *this; }
+
+        bool                IsEnabled ( ) const { return _enabled; }
+        double              MaxZoom ( ) const { return _maxZoom; }
+        double              FollowSmoothing ( ) const { return _followSmoothing; }
+        double              FollowDeadZone ( ) const { return _followDeadZone; }
+
+    protected:
+
+        bool                _enabled{ false };
+        double              _maxZoom{ 8.0 };
+        double              _followSmoothing{ 0.35 };
+        double              _followDeadZone{ 0.05 };
+    };
+
+    // Drives a capture's viewport. Set, AnimateTo and Follow can be called from any thread
+    // without locking: each publishes a command through a sequence lock the capture thread
+    // reads as it evaluates the viewport for a frame, so it never waits on the caller. Views
+    // are kept inside the frame, and zoom is interpolated geometrically so it feels even.
+    class ViewportController
+    {
+    public:
+
+        ViewportController          ( const ViewportOptions& options = { } ) : _options ( options ) { }
+
+        const ViewportOptions&      GetOptions ( ) const { return _options; }
+
+        // Each replaces whatever the viewport was doing
+        void                        Set ( const Viewport& viewport );
+        void                        AnimateTo ( const Viewport& viewport, double seconds, Easing easing = Easing::EaseInOut );
+        // Eases towards target and keeps following it, call again as it moves (a face
+        // tracker's output, say). Zoom 0 leaves the zoom as it is.
+        void                        Follow ( const Viewport& target );
+
+        // Any thread, as of the last frame
+        Viewport                    GetCurrent ( ) const;
+
+        // Capture thread. Advances to time (seconds, the frame's) and returns its viewport.
+        Viewport                    Evaluate ( double time );
+
+        // Row major 3x3 taking output pixels to the source pixels viewport shows, for Remapper::SetView
+        static std::array<double, 9> ToMatrix ( const Viewport& viewport, const Vec2i& size );
+        static bool                 IsWholeFrame ( const Viewport& viewport );
+
+    protected:
+
+        enum class Mode : int32_t
+        {
+            Set,
+            Animate,
+            Follow
+        };
+
+        void                        Publish ( Mode mode, const Viewport& viewport, double seconds, Easing easing );
+        Viewport                    Clamp ( Viewport viewport ) const;
+
+        ViewportOptions             _options;
+
+        // Published by any thread, odd while a writer's part way through
+        std::atomic<uint64_t>       _sequence{ 0 };
+        std::atomic<int32_t>        _mode{ (int32_t)Mode::Set };
+        std::atomic<int32_t>        _easing{ (int32_t)Easing::Linear };
+        std::atomic<double>         _targetX{ 0.5 };
+        std::atomic<double>         _targetY{ 0.5 };
+        std::atomic<double>         _targetZoom{ 1.0 };
+        std::atomic<double>         _seconds{ 0.0 };
+
+        // Capture thread
+        uint64_t                    _lastSequence{ 0 };
+        Mode                        _currentMode{ Mode::Set };
+        Easing                      _currentEasing{ Easing::Linear };
+        Viewport                    _target;
+        Viewport                    _from;
+        Viewport                    _current;
+        double                      _duration{ 0.0 };
+        double                      _startTime{ -1.0 };
+        double                      _lastTime{ -1.0 };
+        double                      _velocity[3]{ 0.0, 0.0, 0.0 };  // Follow's, X, Y and log zoom per second
+
+        // For GetCurrent
+        std::atomic<double>         _currentX{ 0.5 };
+        std::atomic<double>         _currentY{ 0.5 };
+        std::atomic<double>         _currentZoom{ 1.0 };
+    };
+}
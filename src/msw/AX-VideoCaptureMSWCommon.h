@@ -0,0 +1,94 @@
+//
+//  AX-VideoCaptureMSWCommon.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include <windows.h>
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+#include "AX-VideoCaptureLog.h"
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+#include "cinder/app/App.h"
+#endif
+
+namespace AX::Video
+{
+    inline std::string HRToString ( HRESULT hresult )
+    {
+        LPSTR errorText = nullptr;
+
+        // @NOTE(andrew): Win32 is bananas.
+        FormatMessageA ( FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_IGNORE_INSERTS,
+                         nullptr, hresult, MAKELANGID ( LANG_NEUTRAL, SUBLANG_DEFAULT ), (LPSTR)&errorText, 0, nullptr );
+
+        if ( errorText != nullptr )
+        {
+            std::string result = errorText;
+            LocalFree ( errorText );
+            errorText = nullptr;
+
+            return result;
+        }
+
+        return "Unknown error";
+    }
+
+    // ErrorDescriber for HRESULTs, so FormatMessage only runs on the log's drain thread
+    inline std::string DescribeHRESULT ( int64_t code )
+    {
+        std::string text = HRToString ( (HRESULT)code );
+        while ( !text.empty ( ) && ( text.back ( ) == '\n' || text.back ( ) == '\r' ) ) text.pop_back ( );
+        return text;
+    }
+
+    // Signals are emitted on the app's thread when there is one, and straight from the
+    // Media Foundation thread for headless hosts (tools, servers) that don't run an app::App
+    template <typename Fn>
+    void DispatchToMain ( Fn&& fn )
+    {
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        if ( auto app = ci::app::App::get ( ) )
+        {
+            app->dispatchAsync ( std::forward<Fn> ( fn ) );
+            return;
+        }
+#endif
+        fn ( );
+    }
+
+    // Stand ins for cinder::msw's string helpers, so the backend builds without Cinder
+    inline std::wstring ToWideString ( const std::string& utf8 )
+    {
+        if ( utf8.empty ( ) ) return { };
+        int length = MultiByteToWideChar ( CP_UTF8, 0, utf8.data ( ), (int)utf8.size ( ), nullptr, 0 );
+        std::wstring result ( length, L'\0' );
+        MultiByteToWideChar ( CP_UTF8, 0, utf8.data ( ), (int)utf8.size ( ), result.data ( ), length );
+        return result;
+    }
+
+    inline std::string ToUtf8String ( const std::wstring& wide )
+    {
+        if ( wide.empty ( ) ) return { };
+        int length = WideCharToMultiByte ( CP_UTF8, 0, wide.data ( ), (int)wide.size ( ), nullptr, 0, nullptr, nullptr );
+        std::string result ( length, '\0' );
+        WideCharToMultiByte ( CP_UTF8, 0, wide.data ( ), (int)wide.size ( ), result.data ( ), length, nullptr, nullptr );
+        return result;
+    }
+}
+
+#define AX_PRINT_HR(level, x, hr) AX_LOG_CODE ( level, x, hr, AX::Video::DescribeHRESULT );
+
+#define AssertSucceeded(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX::Video::LogLevel::Error, #x, hr ); assert ( false && #x ); } }
+#define CheckSucceeded(x) [&] { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX::Video::LogLevel::Warning, #x, hr ); return false; } return true; }()
+#define ReturnIfFailed(x) { hr = (x); if ( !SUCCEEDED(hr) ) { return hr; } }
+#define BailIfFailed(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { return; } }
+#define ReturnFalseIfFailed(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX::Video::LogLevel::Warning, #x, hr ); return false; } }
@@ -8,199 +8,43 @@
 //
 
 #include "AX-VideoCaptureMSWImpl.h"
+#include "AX-VideoCaptureExecutor.h"
+#include "AX-VideoCaptureMSWCommon.h"
+#include "AX-VideoCaptureMSWInterop.h"
 
-#if (CINDER_VERSION < 903)
-    // Cinder 0.9.2 and younger used GLLoad
-#include "glload/wgl_all.h"
-#else
-    // Cinder 0.9.3 and (presumably) going forward uses GLAD
-#include "glad/glad_wgl.h"
-#endif
-
-#include "cinder/app/App.h"
-#include "cinder/DataSource.h"
-#include "cinder/msw/CinderMsw.h"
-#include "cinder/Log.h"
-#include "cinder/audio/Device.h"
+#include <chrono>
 #include <string>
 #include <unordered_map>
 #include <set>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
 
 #include <mfapi.h>
 #include <mferror.h>
 #include <mfreadwrite.h>
 #include <mfidl.h>
-#include <d3d11.h>
-#include <dxgi.h>
 #include <ks.h>
 #include <ksproxy.h>
 #include <ksmedia.h>
 #include <cfgmgr32.h>
+#include <initguid.h>
+#include <devpkey.h>
+#include <usbioctl.h>
+#include <vector>
 
-#pragma comment(lib, "d3d11.lib")
-#pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "OneCoreUAP.lib")
 
-using namespace ci;
-
-namespace
-{
-    inline static std::string HRToString ( HRESULT hresult )
-    {
-        LPSTR errorText = nullptr;
-
-        // @NOTE(andrew): Win32 is bananas.
-        FormatMessageA ( FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_IGNORE_INSERTS,
-                         nullptr, hresult, MAKELANGID ( LANG_NEUTRAL, SUBLANG_DEFAULT ), (LPSTR)&errorText, 0, nullptr );
-
-        if ( errorText != nullptr )
-        {
-            std::string result = errorText;
-            LocalFree ( errorText );
-            errorText = nullptr;
-
-            return result;
-        }
-
-        return "Unknown error";
-    }
-
-    #define AX_PRINT_HR(level, x, hr) std::printf ( "%s returned HR: (%x) => %s\n", x, hr, HRToString ( hr ).c_str ( ) );
-
-    #define AssertSucceeded(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX_ERROR, #x, hr ); assert ( false && #x ); } }
-    #define CheckSucceeded(x) [&] { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX_WARN, #x, hr ); return false; } return true; }()
-    #define ReturnIfFailed(x) { hr = (x); if ( !SUCCEEDED(hr) ) { return hr; } }
-    #define BailIfFailed(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { return; } }
-    #define ReturnFalseIfFailed(x) { HRESULT hr = (x); if ( !SUCCEEDED(hr) ) { AX_PRINT_HR ( AX_WARN, #x, hr ); return false; } }
-
-    using SharedTexture = AX::Video::SharedTexture;
-    using SharedTextureRef = AX::Video::SharedTextureRef;
-    using InteropContextRef = std::unique_ptr<class InteropContext>;
-
-    // @note(andrew): Have a single D3D + interop context for all capture sessions
-    class InteropContext : public ci::Noncopyable
-    {
-    public:
-
-        static void                     StaticInitialize ( const AX::Video::Capture::Format& format );
-        static InteropContext&          Get ( );
-
-        ~InteropContext ( );
-
-        inline ID3D11Device*            Device ( ) const { return _device.Get ( ); }
-        inline ID3D11DeviceContext*     DeviceContext ( ) const { return _deviceContext.Get ( ); }
-        inline HANDLE                   Handle ( ) const { return _interopHandle; }
-        inline IMFDXGIDeviceManager*    DXGIManager ( ) const { return _dxgiManager.Get ( ); }
-
-        SharedTextureRef                CreateSharedTexture ( const ivec2& size );
-        inline bool                     IsValid ( ) const { return _isValid; }
-
-    protected:
-
-        InteropContext ( const AX::Video::Capture::Format& format );
-
-        ComPtr<ID3D11Device>            _device{ nullptr };
-        ComPtr<ID3D11DeviceContext>     _deviceContext{ nullptr };
-        ComPtr<IMFDXGIDeviceManager>    _dxgiManager{ nullptr };
-
-        HANDLE                          _interopHandle{ nullptr };
-        bool                            _isValid{ false };
-    };
-}
-
 namespace AX::Video
 {
-    class SharedTexture
-    {
-    public:
-
-        SharedTexture               ( const ivec2& size );
-        ~SharedTexture              ( );
-
-        bool                        Lock ( );
-        bool                        Unlock ( );
-        inline bool                 IsLocked ( ) const { return _isLocked; }
-
-        inline bool                 IsValid ( ) const { return _isValid; }
-        ID3D11Texture2D*            DXTextureHandle ( ) const { return _dxTexture.Get ( ); }
-        const ci::gl::TextureRef&   GLTextureHandle ( ) const { return _glTexture; }
-
-    protected:
-
-        ci::gl::TextureRef          _glTexture;
-        ComPtr<ID3D11Texture2D>     _dxTexture{ nullptr };
-        HANDLE                      _shareHandle{ nullptr };
-        bool                        _isValid{ false };
-        bool                        _isLocked{ false };
-    };
-
-    SharedTexture::SharedTexture ( const ivec2& size )
-    {
-        D3D11_TEXTURE2D_DESC desc = {};
-        desc.Width = size.x;
-        desc.Height = size.y;
-        desc.MipLevels = 1;
-        desc.ArraySize = 1;
-        desc.Format = DXGI_FORMAT_B8G8R8X8_UNORM;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-        desc.BindFlags = D3D11_BIND_RENDER_TARGET;
-        desc.Usage = D3D11_USAGE_DEFAULT;
-
-        auto& context = InteropContext::Get ( );
-
-        if ( SUCCEEDED ( context.Device ( )->CreateTexture2D ( &desc, nullptr, _dxTexture.GetAddressOf ( ) ) ) )
-        {
-            gl::Texture::Format fmt;
-            fmt.internalFormat ( GL_RGBA ).loadTopDown ( );
-
-            _glTexture = gl::Texture::create ( size.x, size.y, fmt );
-            _shareHandle = wglDXRegisterObjectNV ( context.Handle ( ), _dxTexture.Get ( ), _glTexture->getId ( ), GL_TEXTURE_2D, WGL_ACCESS_READ_ONLY_NV );
-            _isValid = _shareHandle != nullptr;
-        }
-    }
-
-    bool SharedTexture::Lock ( )
-    {
-        assert ( !IsLocked ( ) );
-        _isLocked = wglDXLockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle );
-        return _isLocked;
-    }
-
-    bool SharedTexture::Unlock ( )
-    {
-        assert ( IsLocked ( ) );
-        if ( wglDXUnlockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle ) )
-        {
-            _isLocked = false;
-            return true;
-        }
-
-        return false;
-    }
-
-    SharedTexture::~SharedTexture ( )
-    {
-        if ( _shareHandle != nullptr )
-        {
-            if ( wglGetCurrentContext ( ) != nullptr ) // No GL Context, so we're likely in the process of shutting down
-            {
-                if ( IsLocked ( ) ) wglDXUnlockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle );
-                wglDXUnregisterObjectNV ( InteropContext::Get ( ).Handle ( ), _shareHandle );
-                _shareHandle = nullptr;
-            }
-        }
-    }
-
     struct ControlMSW : public AX::Video::Capture::Control
     {
-        ControlMSW ( const std::string& name, const ComPtr<IMFCameraControlMonitor> monitor, const ComPtr<IKsControl>& control, int key, GUID set = PROPSETID_VIDCAP_VIDEOPROCAMP )
+        ControlMSW ( const std::string& name, const ComPtr<IMFCameraControlMonitor> monitor, const ComPtr<IKsControl>& control, int key, GUID set = PROPSETID_VIDCAP_VIDEOPROCAMP, const FlightRecorderRef& recorder = nullptr )
             : _control ( control )
             , _set ( set )
             , _key ( key )
             , _monitor ( monitor )
+            , _recorder ( recorder )
         {
             _name = name;
 
@@ -264,14 +108,37 @@ namespace AX::Video
 
         void StoreValue ( int32_t value ) override
         {
-            KSPROPERTY_CAMERACONTROL_S videoControl = {};
-            videoControl.Property.Set = _set;
-            videoControl.Property.Id = _key;
-            videoControl.Property.Flags = KSPROPERTY_TYPE_SET;
-            videoControl.Value = _value = value;
-            ULONG retSize = 0;
+            _value = value;
+            _pending->Value.store ( value );
+            if ( _recorder ) _recorder->Record ( FlightEvent::ControlWrite, _key, value );
+
+            // KsProperty is a synchronous round trip to the device, so writes go out on the shared
+            // executor instead of the caller's (usually UI) thread. A slider drag queues one write
+            // at a time and the write always sends the newest value.
+            if ( !_pending->IsQueued.exchange ( true ) )
+            {
+                Executor::Get ( )->Submit ( [pending = _pending, control = _control, set = _set, key = _key]
+                {
+                    for ( ;; )
+                    {
+                        const int32_t value = pending->Value.load ( );
 
-            CheckSucceeded ( _control->KsProperty ( (PKSPROPERTY)&videoControl, sizeof ( videoControl ), &videoControl, sizeof ( videoControl ), &retSize ) );
+                        KSPROPERTY_CAMERACONTROL_S videoControl = {};
+                        videoControl.Property.Set = set;
+                        videoControl.Property.Id = key;
+                        videoControl.Property.Flags = KSPROPERTY_TYPE_SET;
+                        videoControl.Value = value;
+                        ULONG retSize = 0;
+
+                        CheckSucceeded ( control->KsProperty ( (PKSPROPERTY)&videoControl, sizeof ( videoControl ), &videoControl, sizeof ( videoControl ), &retSize ) );
+
+                        // Only cleared once the write is done, so no second one can overtake it. A value
+                        // stored meanwhile either queues its own write or is picked up here.
+                        pending->IsQueued.store ( false );
+                        if ( pending->Value.load ( ) == value || pending->IsQueued.exchange ( true ) ) break;
+                    }
+                }, Executor::Priority::Background );
+            }
         }
 
         int32_t LoadValue ( ) override
@@ -290,43 +157,19 @@ namespace AX::Video
         }
 
     protected:
+
+        struct PendingWrite
+        {
+            std::atomic<int32_t>        Value{ 0 };
+            std::atomic_bool            IsQueued{ false };
+        };
+
+        std::shared_ptr<PendingWrite>   _pending{ std::make_shared<PendingWrite> ( ) };
         ComPtr<IKsControl>              _control;
         GUID                            _set{ PROPSETID_VIDCAP_VIDEOPROCAMP };
         int                             _key{ KSPROPERTY_VIDEOPROCAMP_BRIGHTNESS };
         ComPtr<IMFCameraControlMonitor> _monitor;
-    };
-
-    void SharedTextureDeleter::operator ( ) ( SharedTexture* ptr ) const
-    {
-        std::default_delete<SharedTexture> deleter;
-        deleter ( ptr );
-    }
-
-    class DXGIRenderPathFrameLease : public AX::Video::Capture::FrameLease
-    {
-    public:
-
-        DXGIRenderPathFrameLease ( const SharedTextureRef& texture )
-            : _texture ( texture.get ( ) )
-        {
-            if ( _texture ) _texture->Lock ( );
-        }
-
-        inline bool    IsValid ( ) const override { return ToTexture ( ) != nullptr; }
-        gl::TextureRef ToTexture ( ) const override { return _texture ? _texture->GLTextureHandle ( ) : nullptr; };
-
-        ~DXGIRenderPathFrameLease ( )
-        {
-            if ( _texture && _texture->IsLocked ( ) )
-            {
-                _texture->Unlock ( );
-                _texture = nullptr;
-            }
-        }
-
-    protected:
-
-        SharedTexture* _texture{ nullptr };
+        FlightRecorderRef               _recorder;
     };
 
     static void DispatchDeviceChangeSignals ( )
@@ -376,7 +219,7 @@ namespace
         return ERROR_SUCCESS;
     }
     
-    static struct Notifier
+    struct Notifier
     {
         HCMNOTIFICATION handle{ nullptr };
         
@@ -394,19 +237,15 @@ namespace
         {
             CM_Unregister_Notification ( handle );
         }
-        
-    } kNotifier;
-
-    static std::atomic_int kNumMediaFoundationInstances = 0;
-    static std::atomic_bool kIsMFInitialized = false;
+    };
 
     using MFCreateCaptureEngineFn = HRESULT ( * ) ( IMFCaptureEngine** );
 
     struct Lib
     {
-        Lib ( const fs::path& path )
+        Lib ( const std::string& path )
         {
-            _handle = LoadLibraryA ( path.string ( ).c_str ( ) );
+            _handle = LoadLibraryA ( path.c_str ( ) );
         }
 
         template <typename T>
@@ -436,129 +275,159 @@ namespace
         return result;
     }
 
-    template <typename T>
-    struct ComArray : public ci::Noncopyable
-    {
-        ~ComArray ( )
-        {
-            for ( uint32_t i = 0; i < Count; i++ )
-            {
-                if ( Data[i] ) Data[i]->Release ( );
-            }
-            CoTaskMemFree ( Data );
-            Data = nullptr;
-        }
-
-        T* operator[] ( int index ) { return Data[index]; };
-        const T* operator[] ( int index ) const { return Data[index]; };
+    using PixelFormat = AX::Video::Capture::PixelFormat;
 
-        uint32_t Count{ 0 };
-        T** Data{ nullptr };
-    };
-   
-    static InteropContext* kInteropContext{ nullptr };
+    PixelFormat SubtypeToPixelFormat ( const GUID& subtype )
+    {
+        if ( subtype == MFVideoFormat_RGB32 ) return PixelFormat::RGB32;
+        if ( subtype == MFVideoFormat_RGB24 ) return PixelFormat::RGB24;
+        if ( subtype == MFVideoFormat_YUY2 )  return PixelFormat::YUY2;
+        if ( subtype == MFVideoFormat_UYVY )  return PixelFormat::UYVY;
+        if ( subtype == MFVideoFormat_NV12 )  return PixelFormat::NV12;
+        if ( subtype == MFVideoFormat_I420 )  return PixelFormat::I420;
+        if ( subtype == MFVideoFormat_MJPG )  return PixelFormat::MJPEG;
+        if ( subtype == MFVideoFormat_H264 )  return PixelFormat::H264;
+        return PixelFormat::Unknown;
+    }
 
-    static void OnCaptureCreated ( )
+    std::wstring GetDeviceInstanceID ( DEVINST node )
     {
-        if ( kNumMediaFoundationInstances++ == 0 )
+        wchar_t buffer[MAX_DEVICE_ID_LEN] = {};
+        if ( CM_Get_Device_IDW ( node, buffer, MAX_DEVICE_ID_LEN, 0 ) == CR_SUCCESS )
         {
-            kIsMFInitialized = SUCCEEDED ( MFStartup ( MF_VERSION ) );
+            return buffer;
         }
+
+        return {};
     }
 
-    static void OnCaptureDestroyed ( )
+    bool IsUSBHub ( DEVINST node )
     {
-        if ( --kNumMediaFoundationInstances == 0 )
+        wchar_t service[64] = {};
+        ULONG length = sizeof ( service );
+        if ( CM_Get_DevNode_Registry_PropertyW ( node, CM_DRP_SERVICE, nullptr, service, &length, 0 ) == CR_SUCCESS )
         {
-            delete kInteropContext;
-            kInteropContext = nullptr;
-            MFShutdown ( );
-            kIsMFInitialized = false;
+            return _wcsnicmp ( service, L"usbhub", 6 ) == 0;
         }
+
+        return false;
     }
 
-    void InteropContext::StaticInitialize ( const AX::Video::Capture::Format& format )
+    // What the device on the hub's port actually negotiated. A USB2 camera on a USB3 port
+    // only gets a USB2 link, whatever the controller can do.
+    BusSpeed GetConnectionSpeed ( DEVINST device, DEVINST hub )
     {
-        if ( !kInteropContext )
+        // A USB device's address is the hub port it's plugged into
+        UINT32 port{ 0 };
+        ULONG size = sizeof ( port );
+        DEVPROPTYPE type{};
+        if ( CM_Get_DevNode_PropertyW ( device, &DEVPKEY_Device_Address, &type, (PBYTE)&port, &size, 0 ) != CR_SUCCESS || type != DEVPROP_TYPE_UINT32 ) return BusSpeed::Unknown;
+
+        auto hubId = GetDeviceInstanceID ( hub );
+        ULONG length{ 0 };
+        if ( CM_Get_Device_Interface_List_SizeW ( &length, (LPGUID)&GUID_DEVINTERFACE_USB_HUB, (DEVINSTID_W)hubId.c_str ( ), CM_GET_DEVICE_INTERFACE_LIST_PRESENT ) != CR_SUCCESS || length <= 1 ) return BusSpeed::Unknown;
+
+        std::vector<wchar_t> paths ( length );
+        if ( CM_Get_Device_Interface_ListW ( (LPGUID)&GUID_DEVINTERFACE_USB_HUB, (DEVINSTID_W)hubId.c_str ( ), paths.data ( ), length, CM_GET_DEVICE_INTERFACE_LIST_PRESENT ) != CR_SUCCESS ) return BusSpeed::Unknown;
+
+        HANDLE handle = CreateFileW ( paths.data ( ), GENERIC_WRITE, FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr );
+        if ( handle == INVALID_HANDLE_VALUE ) return BusSpeed::Unknown;
+
+        BusSpeed speed = BusSpeed::Unknown;
+        DWORD returned{ 0 };
+
+        USB_NODE_CONNECTION_INFORMATION_EX_V2 v2 = {};
+        v2.ConnectionIndex = port;
+        v2.Length = sizeof ( v2 );
+        v2.SupportedUsbProtocols.Usb300 = 1;
+        if ( DeviceIoControl ( handle, IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX_V2, &v2, sizeof ( v2 ), &v2, sizeof ( v2 ), &returned, nullptr ) &&
+             ( v2.Flags.DeviceIsOperatingAtSuperSpeedOrHigher || v2.Flags.DeviceIsOperatingAtSuperSpeedPlusOrHigher ) )
+        {
+            speed = BusSpeed::USB3;
+        } else
         {
-            kInteropContext = new InteropContext ( format );
+            // USB2 hubs don't answer V2. Anything below high speed is budgeted as USB2, the
+            // slowest the planner knows.
+            USB_NODE_CONNECTION_INFORMATION_EX info = {};
+            info.ConnectionIndex = port;
+            if ( DeviceIoControl ( handle, IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX, &info, sizeof ( info ), &info, sizeof ( info ), &returned, nullptr ) )
+            {
+                speed = info.Speed >= UsbSuperSpeed ? BusSpeed::USB3 : BusSpeed::USB2;
+            }
         }
-    }
 
-    InteropContext& InteropContext::Get ( )
-    {
-        assert ( kInteropContext );
-        return *kInteropContext;
+        CloseHandle ( handle );
+        return speed;
     }
 
-    InteropContext::InteropContext ( const AX::Video::Capture::Format& format )
-        : _isValid ( false )
+    template <typename T>
+    struct ComArray
     {
-        UINT deviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_VIDEO_SUPPORT;
+        ComArray ( ) = default;
+        ComArray ( const ComArray& ) = delete;
+        ComArray& operator = ( const ComArray& ) = delete;
 
-#ifndef NDEBUG
-        deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
+        ~ComArray ( )
+        {
+            for ( uint32_t i = 0; i < Count; i++ )
+            {
+                if ( Data[i] ) Data[i]->Release ( );
+            }
+            CoTaskMemFree ( Data );
+            Data = nullptr;
+        }
 
-        UINT resetToken{ 0 };
-        BailIfFailed ( MFCreateDXGIDeviceManager ( &resetToken, _dxgiManager.GetAddressOf ( ) ) );
-        BailIfFailed ( D3D11CreateDevice ( nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, deviceFlags, nullptr, 0, D3D11_SDK_VERSION, _device.GetAddressOf ( ), nullptr, _deviceContext.GetAddressOf ( ) ) );
+        T* operator[] ( int index ) { return Data[index]; };
+        const T* operator[] ( int index ) const { return Data[index]; };
 
-        ComPtr<ID3D10Multithread> multiThread{ nullptr };
-        BailIfFailed ( _device->QueryInterface ( multiThread.GetAddressOf ( ) ) );
-        multiThread->SetMultithreadProtected ( true );
-        
-        BailIfFailed ( _dxgiManager->ResetDevice ( _device.Get ( ), resetToken ) );
+        uint32_t Count{ 0 };
+        T** Data{ nullptr };
+    };
+   
+    // Each capture's position in the callbacks it's currently inside, so Detach() called from
+    // within one (a signal handler destroying its capture) doesn't wait on itself
+    thread_local std::vector<const void *> kCallbackStack;
 
-        _interopHandle = wglDXOpenDeviceNV ( _device.Get ( ) );
-        _isValid = _interopHandle != nullptr;
-    }
+}
 
-    SharedTextureRef InteropContext::CreateSharedTexture ( const ivec2& size )
+namespace AX::Video
+{
+    // Nothing here runs at static init. The DLL, hotplug registration and device list are
+    // all set up on first use, so binaries that link the library but never open a camera
+    // don't pay for them.
+    static Lib& GetCaptureLib ( )
     {
-        static AX::Video::SharedTextureDeleter kSharedTextureDeleter;
-
-        auto texture = SharedTextureRef ( new SharedTexture ( size ), kSharedTextureDeleter );
-        if ( texture->IsValid ( ) ) return std::move ( texture );
-
-        return nullptr;
+        static Lib kCaptureLib{ "MFCaptureEngine.dll" };
+        return kCaptureLib;
     }
 
-    InteropContext::~InteropContext ( )
+    struct DeviceCache
     {
-        if ( _interopHandle != nullptr )
-        {
-            wglDXCloseDeviceNV ( _interopHandle );
-            _interopHandle = nullptr;
-        }
-
-        _dxgiManager = nullptr;
+        std::mutex                              Mutex;
+        std::vector<Capture::DeviceDescriptor>  Devices;
+    };
 
-        // @leak(andrew): Debug layer is whinging about live objects but is this 
-        // this because the ComPtr destructors haven't had a chance to fire yet?
-#ifndef NDEBUG
-        if ( _device )
-        {
-            ComPtr<ID3D11Debug> debug{ nullptr };
-            if ( CheckSucceeded ( _device->QueryInterface ( debug.GetAddressOf ( ) ) ) )
-            {
-                debug->ReportLiveDeviceObjects ( D3D11_RLDO_DETAIL | D3D11_RLDO_IGNORE_INTERNAL );
-            }
-        }
-#endif
+    static DeviceCache& GetDeviceCache ( )
+    {
+        static DeviceCache kCache;
+        return kCache;
     }
-    
-}
 
-namespace AX::Video
-{
-    static Lib kCaptureLib{ "MFCaptureEngine.dll" };
+    void Capture::Impl::WatchDevices ( )
+    {
+        static Notifier kNotifier;
+    }
 
     ComPtr<IMFMediaSource> FindDeviceSource ( const Capture::DeviceDescriptor& descriptor );
-    static std::vector<Capture::DeviceDescriptor> kCaptureDevices;
     std::vector<Capture::DeviceDescriptor> Capture::Impl::GetDevices ( bool refresh )
     {
-        if ( kCaptureDevices.empty ( ) || refresh )
+        WatchDevices ( );
+
+        // The notification thread refreshes this too
+        auto& cache = GetDeviceCache ( );
+        std::lock_guard<std::mutex> lock ( cache.Mutex );
+
+        if ( cache.Devices.empty ( ) || refresh )
         {
             ComPtr<IMFAttributes> attributes;
             MFCreateAttributes ( &attributes, 1 );
@@ -567,8 +436,8 @@ namespace AX::Video
             ComArray<IMFActivate> activates{};
             CheckSucceeded ( MFEnumDeviceSources ( attributes.Get ( ), &activates.Data, &activates.Count ) );
 
-            kCaptureDevices.clear ( );
-            kCaptureDevices.reserve ( activates.Count );
+            cache.Devices.clear ( );
+            cache.Devices.reserve ( activates.Count );
 
             for ( uint32_t i = 0; i < activates.Count; i++ )
             {
@@ -579,20 +448,20 @@ namespace AX::Video
                 if ( CheckSucceeded ( activates[i]->GetString ( MF_DEVSOURCE_ATTRIBUTE_FRIENDLY_NAME, buffer, 128, &length ) ) )
                 {
                     std::wstring w = buffer;
-                    device.Name = msw::toUtf8String ( w );
+                    device.Name = ToUtf8String ( w );
                 }
 
                 if ( CheckSucceeded ( activates[i]->GetString ( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_SYMBOLIC_LINK, buffer, 128, &length ) ) )
                 {
                     auto w = buffer;
-                    device.ID = msw::toUtf8String ( w );
+                    device.ID = ToUtf8String ( w );
                 }
 
-                kCaptureDevices.push_back ( device );
+                cache.Devices.push_back ( device );
             }
         }
 
-        return kCaptureDevices;
+        return cache.Devices;
     }
 
     std::vector<Capture::DeviceProfile> Capture::Impl::GetProfiles ( const DeviceDescriptor& descriptor )
@@ -626,14 +495,17 @@ namespace AX::Video
                         {
                             UINT32 width, height;
                             UINT32 fpsNum, fpsDen;
+                            GUID subtype{ GUID_NULL };
                             bool size = CheckSucceeded ( MFGetAttributeSize ( type.Get(), MF_MT_FRAME_SIZE, &width, &height ) );
                             bool fps = CheckSucceeded ( MFGetAttributeRatio ( type.Get(), MF_MT_FRAME_RATE, &fpsNum, &fpsDen ) );
+                            type->GetGUID ( MF_MT_SUBTYPE, &subtype );
 
                             if ( size && fps )
                             {
                                 DeviceProfile profile{};
-                                profile.Size = ivec2 ( width, height );
-                                profile.FPS = ivec2 ( fpsNum, fpsDen );
+                                profile.Size = Vec2i ( width, height );
+                                profile.FPS = Vec2i ( fpsNum, fpsDen );
+                                profile.Subtype = SubtypeToPixelFormat ( subtype );
                                 unique.insert ( profile );
                             }
                             break;
@@ -648,11 +520,68 @@ namespace AX::Video
         {
             auto aV = a.Size.x * a.Size.y + ( (float)( a.FPS.x ) / (float)( a.FPS.y ) );
             auto bV = b.Size.x * b.Size.y + ( (float)( b.FPS.x ) / (float)( b.FPS.y ) );
+            if ( aV == bV ) return a.Subtype < b.Subtype;
             return bV < aV;
         } );
         return result;
     }
 
+    Capture::DeviceTopology Capture::Impl::GetDeviceTopology ( const DeviceDescriptor& descriptor )
+    {
+        Capture::DeviceTopology topology{};
+
+        // The symbolic link names the device interface, walk from its device node up towards
+        // the root hub. The first hub on the way is the link the camera shares with its
+        // siblings, and the port on it says how fast the camera's own link is. The root hub's
+        // parent is the host controller.
+        auto symlink = ToWideString ( descriptor.ID );
+        wchar_t instanceId[MAX_DEVICE_ID_LEN] = {};
+        ULONG size = sizeof ( instanceId );
+        DEVPROPTYPE type{};
+        if ( CM_Get_Device_Interface_PropertyW ( symlink.c_str ( ), &DEVPKEY_Device_InstanceId, &type, (PBYTE)instanceId, &size, 0 ) != CR_SUCCESS )
+        {
+            topology.Controller = topology.Hub = descriptor.ID;
+            return topology;
+        }
+
+        DEVINST node{ 0 };
+        if ( CM_Locate_DevNodeW ( &node, instanceId, CM_LOCATE_DEVNODE_NORMAL ) != CR_SUCCESS )
+        {
+            topology.Controller = topology.Hub = descriptor.ID;
+            return topology;
+        }
+
+        DEVINST parent{ 0 };
+        while ( CM_Get_Parent ( &parent, node, 0 ) == CR_SUCCESS )
+        {
+            auto id = GetDeviceInstanceID ( parent );
+            const bool isRootHub = id.rfind ( L"USB\\ROOT_HUB", 0 ) == 0;
+            if ( topology.Hub.empty ( ) && ( isRootHub || IsUSBHub ( parent ) ) )
+            {
+                topology.Hub = ToUtf8String ( id );
+                topology.Speed = GetConnectionSpeed ( node, parent );
+            }
+
+            if ( isRootHub )
+            {
+                DEVINST controller{ 0 };
+                if ( CM_Get_Parent ( &controller, parent, 0 ) == CR_SUCCESS )
+                {
+                    topology.Controller = ToUtf8String ( GetDeviceInstanceID ( controller ) );
+                }
+                break;
+            }
+
+            node = parent;
+        }
+
+        // Not on USB (or the tree couldn't be walked), treat the device as having its own bus
+        if ( topology.Controller.empty ( ) ) topology.Controller = descriptor.ID;
+        if ( topology.Hub.empty ( ) ) topology.Hub = topology.Controller;
+
+        return topology;
+    }
+
     ComPtr<IMFMediaSource> FindDeviceSource ( const Capture::DeviceDescriptor& descriptor )
     {
         ComPtr<IMFAttributes> attributes;
@@ -662,8 +591,11 @@ namespace AX::Video
         ComArray<IMFActivate> activates{};
         CheckSucceeded ( MFEnumDeviceSources ( attributes.Get ( ), &activates.Data, &activates.Count ) );
 
-        kCaptureDevices.clear ( );
-        kCaptureDevices.reserve ( activates.Count );
+        {
+            auto& cache = GetDeviceCache ( );
+            std::lock_guard<std::mutex> lock ( cache.Mutex );
+            cache.Devices.clear ( );
+        }
 
         for ( uint32_t i = 0; i < activates.Count; i++ )
         {
@@ -673,7 +605,7 @@ namespace AX::Video
             if ( CheckSucceeded ( activates[i]->GetString ( MF_DEVSOURCE_ATTRIBUTE_SOURCE_TYPE_VIDCAP_SYMBOLIC_LINK, buffer, 128, &length ) ) )
             {
                 auto w = buffer;
-                if ( descriptor.ID == msw::toUtf8String ( w ) )
+                if ( descriptor.ID == ToUtf8String ( w ) )
                 {
                     ComPtr<IMFMediaSource> source;
                     if ( CheckSucceeded ( activates[i]->ActivateObject ( IID_PPV_ARGS ( &source ) ) ) )
@@ -687,20 +619,88 @@ namespace AX::Video
         return nullptr;
     }
 
+    Capture::Impl::CallbackScope::CallbackScope ( Impl& impl )
+        : _impl ( impl )
+    {
+        // Increment before checking, Detach() sets the flag before counting, so one of the
+        // two always sees the other
+        _impl._callbacksInside++;
+        if ( _impl._isDetached.load ( ) )
+        {
+            _impl._callbacksInside--;
+            return;
+        }
+
+        kCallbackStack.push_back ( &_impl );
+        _isOpen = true;
+    }
+
+    Capture::Impl::CallbackScope::~CallbackScope ( )
+    {
+        if ( !_isOpen ) return;
+
+        kCallbackStack.pop_back ( );
+        _impl._callbacksInside--;
+    }
+
+    template <typename Fn>
+    void Capture::Impl::DispatchToOwner ( Fn&& fn )
+    {
+        AddRef ( );
+        DispatchToMain ( [this, fn = std::forward<Fn> ( fn )]
+        {
+            {
+                // Declared first so it's released after the scope closes
+                std::shared_ptr<Capture> owner;
+
+                CallbackScope scope ( *this );
+                if ( scope )
+                {
+                    owner = _owner.weak_from_this ( ).lock ( );
+                    fn ( );
+                }
+            }
+
+            Release ( );
+        } );
+    }
+
     Capture::Impl::Impl ( Capture & owner, const Format& format )
         : _owner ( owner )
         , _format( format )
+        , _deinterlacer ( format.Deinterlace ( ) )
+        , _denoiser ( format.Denoise ( ) )
+        , _remapper ( format.Remap ( ) )
+        , _stabilizer ( format.Stabilize ( ) )
+        , _viewWarp ( RemapOptions ( ).Homography ( { 1, 0, 0, 0, 1, 0, 0, 0, 1 } ).GridStep ( 64 ) )
+        , _flicker ( format.FlickerDetection ( ) )
+        , _coverDetector ( format.ThrottleWhenOccluded ( ) )
     {
-        OnCaptureCreated ();
+        _runtime = CaptureRuntime::Acquire ( format.IsHardwareAccelerated ( ) );
+        _frameSize = _format.Size ( );
+        _fieldInterval.store ( 0.5 * (double)std::max ( 1, _format.FPS ( ).y ) / (double)std::max ( 1, _format.FPS ( ).x ) );
+        _stats.SetExpectedFPS ( (double)_format.FPS ( ).x / (double)std::max ( 1, _format.FPS ( ).y ) );
+        if ( _format.IsHardwareAccelerated ( ) && ( _format.Denoise ( ).IsEnabled ( ) || _format.Remap ( ).IsEnabled ( ) || _format.Stabilize ( ).IsEnabled ( ) || _format.ElectronicPTZ ( ).IsEnabled ( ) ) )
+        {
+            AX_LOG ( LogLevel::Warning, "Denoising, remap, stabilisation and ePTZ only apply to software captures, hardware frames are left as is" );
+        }
+        if ( _format.IsHardwareAccelerated ( ) && _format.FlickerDetection ( ).IsEnabled ( ) )
+        {
+            AX_LOG ( LogLevel::Warning, "Flicker detection needs software frames, it's off for hardware captures" );
+        }
+        if ( _format.IsHardwareAccelerated ( ) && _format.ThrottleWhenOccluded ( ).IsEnabled ( ) && _format.ThrottleWhenOccluded ( ).LuminanceFallback ( ) )
+        {
+            AX_LOG ( LogLevel::Warning, "The covered lens fallback needs software frames, hardware captures only throttle on occlusion reports" );
+        }
         
-        MFCreateCaptureEngineFn MFCreateCaptureEngine = kCaptureLib.GetFunction<MFCreateCaptureEngineFn> ( "MFCreateCaptureEngine" );
+        MFCreateCaptureEngineFn MFCreateCaptureEngine = GetCaptureLib ( ).GetFunction<MFCreateCaptureEngineFn> ( "MFCreateCaptureEngine" );
         BailIfFailed ( MFCreateCaptureEngine ( _captureEngine.GetAddressOf ( ) ) );
 
         if ( auto source = FindDeviceSource ( format.Device() ) )
         {
             {
                 ComPtr<IKsControl> control;
-                auto symlink = msw::toWideString ( _format.Device ( ).ID );
+                auto symlink = ToWideString ( _format.Device ( ).ID );
                 CheckSucceeded ( source->QueryInterface ( control.GetAddressOf ( ) ) );
                 CheckSucceeded ( MFCreateCameraControlMonitor ( symlink.c_str(), this, &_monitor ) );
                 CheckSucceeded ( MFCreateCameraOcclusionStateMonitor ( symlink.c_str(), this, &_occlusion ) );
@@ -717,13 +717,15 @@ namespace AX::Video
                     { "White Balance", { KSPROPERTY_VIDEOPROCAMP_WHITEBALANCE, PROPSETID_VIDCAP_VIDEOPROCAMP } },
                     { "Backlight Compensation", { KSPROPERTY_VIDEOPROCAMP_BACKLIGHT_COMPENSATION, PROPSETID_VIDCAP_VIDEOPROCAMP } },
                     { "Gain", { KSPROPERTY_VIDEOPROCAMP_GAIN, PROPSETID_VIDCAP_VIDEOPROCAMP } },
+                    { "Power Line Frequency", { KSPROPERTY_VIDEOPROCAMP_POWERLINE_FREQUENCY, PROPSETID_VIDCAP_VIDEOPROCAMP } },
+                    { "Exposure", { KSPROPERTY_CAMERACONTROL_EXPOSURE, PROPSETID_VIDCAP_CAMERACONTROL } },
                     { "Zoom", { KSPROPERTY_CAMERACONTROL_ZOOM, PROPSETID_VIDCAP_CAMERACONTROL } },
                     { "Focus", { KSPROPERTY_CAMERACONTROL_FOCUS, PROPSETID_VIDCAP_CAMERACONTROL } }
                 };
 
                 for ( auto& [name, key] : keys )
                 {
-                    auto ctrl = std::make_unique<ControlMSW> ( name, _monitor, control, key.first, key.second );
+                    auto ctrl = std::make_unique<ControlMSW> ( name, _monitor, control, key.first, key.second, _owner._flightRecorder );
                     ctrl->InitState ( );
                     if ( ctrl->IsSupported() )
                     {
@@ -736,15 +738,16 @@ namespace AX::Video
             }
 
             ComPtr<IMFAttributes> attributes;
-            MFCreateAttributes ( &attributes, 3 );
+            MFCreateAttributes ( &attributes, 4 );
             attributes->SetUINT32 ( MF_CAPTURE_ENGINE_USE_VIDEO_DEVICE_ONLY, 1 );
+            if ( _format.IsLowLatency ( ) ) attributes->SetUINT32 ( MF_LOW_LATENCY, TRUE );
 
             bool hardware = format.IsHardwareAccelerated ( );
             if ( !hardware ) attributes->SetUINT32 ( MF_CAPTURE_ENGINE_DISABLE_HARDWARE_TRANSFORMS, 1 );
 
+#ifndef AX_VIDEOCAPTURE_HEADLESS
             if ( hardware )
             {
-                InteropContext::StaticInitialize ( _format );
                 auto& ic = InteropContext::Get ( );
 
                 _sharedTextures[0] = ic.CreateSharedTexture ( _format.Size ( ) );
@@ -752,7 +755,7 @@ namespace AX::Video
 
                 if ( !_sharedTextures[0] || !_sharedTextures[1] )
                 {
-                    std::printf ( "Error allocating shared textures\n" );
+                    AX_LOG ( LogLevel::Error, "Error allocating shared textures" );
                     _isValid = false;
                     return;
                 }
@@ -760,24 +763,147 @@ namespace AX::Video
 
                 attributes->SetUnknown ( MF_CAPTURE_ENGINE_D3D_MANAGER, ic.DXGIManager() );
             }
+#endif
 
             BailIfFailed ( _captureEngine->Initialize ( this, attributes.Get ( ), nullptr, source.Get ( ) ) );
             _isValid = true;
         }
     }
 
+    void Capture::Impl::SelectDeviceMediaType ( )
+    {
+        if ( _format.Subtype ( ) == PixelFormat::Unknown ) return;
+
+        // Pin the device's native type so the engine doesn't pick a different subtype (and
+        // therefore a different bus bandwidth) than the one the caller planned for
+        ComPtr<IMFCaptureSource> source;
+        BailIfFailed ( _captureEngine->GetSource ( source.GetAddressOf ( ) ) );
+
+        const DWORD stream = (DWORD)MF_CAPTURE_ENGINE_PREFERRED_SOURCE_STREAM_FOR_VIDEO_PREVIEW;
+        DWORD index = 0;
+        ComPtr<IMFMediaType> type;
+        while ( SUCCEEDED ( source->GetAvailableDeviceMediaType ( stream, index++, type.ReleaseAndGetAddressOf ( ) ) ) )
+        {
+            UINT32 width, height, fpsNum, fpsDen;
+            GUID subtype{ GUID_NULL };
+            if ( FAILED ( MFGetAttributeSize ( type.Get ( ), MF_MT_FRAME_SIZE, &width, &height ) ) ) continue;
+            if ( FAILED ( MFGetAttributeRatio ( type.Get ( ), MF_MT_FRAME_RATE, &fpsNum, &fpsDen ) ) ) continue;
+            if ( FAILED ( type->GetGUID ( MF_MT_SUBTYPE, &subtype ) ) ) continue;
+
+            if ( Vec2i ( width, height ) == _format.Size ( ) && Vec2i ( fpsNum, fpsDen ) == _format.FPS ( ) && SubtypeToPixelFormat ( subtype ) == _format.Subtype ( ) )
+            {
+                CheckSucceeded ( source->SetCurrentDeviceMediaType ( stream, type.Get ( ) ) );
+                return;
+            }
+        }
+    }
+
+    bool Capture::Impl::QueryStreamFormat ( Vec2i& size, Vec2i& fps, PixelFormat& subtype )
+    {
+        if ( !_captureEngine ) return false;
+
+        ComPtr<IMFMediaType> type;
+        UINT32 width{ 0 }, height{ 0 };
+        if ( _previewSink && SUCCEEDED ( _previewSink->GetOutputMediaType ( _previewStream, type.GetAddressOf ( ) ) ) )
+        {
+            if ( SUCCEEDED ( MFGetAttributeSize ( type.Get ( ), MF_MT_FRAME_SIZE, &width, &height ) ) ) size = Vec2i ( width, height );
+        }
+
+        ComPtr<IMFCaptureSource> source;
+        if ( FAILED ( _captureEngine->GetSource ( source.GetAddressOf ( ) ) ) ) return false;
+        if ( FAILED ( source->GetCurrentDeviceMediaType ( (DWORD)MF_CAPTURE_ENGINE_PREFERRED_SOURCE_STREAM_FOR_VIDEO_PREVIEW, type.ReleaseAndGetAddressOf ( ) ) ) ) return false;
+
+        UINT32 fpsNum{ 0 }, fpsDen{ 0 };
+        GUID guid{ GUID_NULL };
+        if ( SUCCEEDED ( MFGetAttributeRatio ( type.Get ( ), MF_MT_FRAME_RATE, &fpsNum, &fpsDen ) ) ) fps = Vec2i ( fpsNum, fpsDen );
+        if ( SUCCEEDED ( type->GetGUID ( MF_MT_SUBTYPE, &guid ) ) ) subtype = SubtypeToPixelFormat ( guid );
+
+        // No preview type to go on, the engine passes the device's size through
+        if ( size.x == 0 && SUCCEEDED ( MFGetAttributeSize ( type.Get ( ), MF_MT_FRAME_SIZE, &width, &height ) ) ) size = Vec2i ( width, height );
+
+        return true;
+    }
+
+    void Capture::Impl::ChangeFormat ( const Vec2i& size, const Vec2i& fps, PixelFormat subtype )
+    {
+        if ( size.x > 0 )
+        {
+            AX_LOG ( LogLevel::Info, "Stream changed size to %dx%d", size.x, size.y );
+            _owner._flightRecorder->Record ( FlightEvent::FormatChanged, size.x, size.y );
+            _frameSize = size;
+            _isResizing.store ( _format.IsHardwareAccelerated ( ) );
+        } else
+        {
+            AX_LOG ( LogLevel::Info, "Stream changed to %s at %d/%d fps", ToString ( subtype ), fps.x, fps.y );
+            _owner._flightRecorder->Record ( FlightEvent::FormatChanged );
+        }
+
+        if ( fps.x > 0 )
+        {
+            _stats.SetExpectedFPS ( (double)fps.x / (double)std::max ( 1, fps.y ) );
+            _fieldInterval.store ( 0.5 * (double)std::max ( 1, fps.y ) / (double)fps.x );
+        }
+
+        DispatchToOwner ( [=] { ApplyFormatChange ( size, fps, subtype ); } );
+    }
+
+    void Capture::Impl::ApplyFormatChange ( const Vec2i& size, const Vec2i& fps, PixelFormat subtype )
+    {
+        for ( auto format : { &_format, &_owner._format } )
+        {
+            if ( size.x > 0 ) format->Size ( size );
+            if ( fps.x > 0 ) format->FPS ( fps.x, fps.y );
+            if ( subtype != PixelFormat::Unknown ) format->Subtype ( subtype );
+        }
+
+        if ( size.x > 0 )
+        {
+            // Blocks of the old size will never be handed out again
+            _framePool->Trim ( );
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+            if ( _format.IsHardwareAccelerated ( ) )
+            {
+                auto& ic = InteropContext::Get ( );
+                _sharedTextures[0] = ic.CreateSharedTexture ( size );
+                _sharedTextures[1] = ic.CreateSharedTexture ( size );
+
+                if ( !_sharedTextures[0] || !_sharedTextures[1] )
+                {
+                    // The samples are dropped (and counted) until the next format change rather
+                    // than copied into nothing, but the owner still hears about the change
+                    AX_LOG ( LogLevel::Error, "Error reallocating shared textures at %dx%d", size.x, size.y );
+                    _sharedTextures[0] = _sharedTextures[1] = nullptr;
+                    _stats.RecordError ( E_OUTOFMEMORY );
+                    _owner._flightRecorder->Record ( FlightEvent::Error, E_OUTOFMEMORY );
+                    _owner.OnError.emit ( E_OUTOFMEMORY );
+                }
+            }
+#endif
+            _isResizing.store ( false );
+        }
+
+        _owner.OnFormatChanged.emit ( _owner._format );
+    }
+
     void Capture::Impl::Start ( )
     {
         if ( !_isInitialized ) return;
         if ( IsStarted ( ) ) return;
         _isStarted.store ( true );
+        if ( _numStarts++ > 0 ) _stats.RecordRestart ( );
+        _owner._flightRecorder->Record ( FlightEvent::Started );
         CheckSucceeded ( _captureEngine->StartPreview ( ) );
+        UpdateOcclusion ( );
     }
 
     void Capture::Impl::Stop ( )
     {
         if ( IsStopped ( ) ) return;
         _isStarted.store ( false );
+        _owner._flightRecorder->Record ( FlightEvent::Stopped );
+        // Leave the device at the rate it was asked for, Start picks the throttle back up
+        if ( _isThrottled.exchange ( false ) ) ApplyDeviceRate ( );
         CheckSucceeded ( _captureEngine->StopPreview ( ) );
     }
 
@@ -791,20 +917,298 @@ namespace AX::Video
         return !IsStarted ( );
     }
 
-    const Surface8uRef & Capture::Impl::GetSurface ( ) const
+    Capture::Stats Capture::Impl::GetStats ( ) const
     {
-        _hasNewFrame.store ( false );
+        auto stats = _stats.Snapshot ( );
+        stats.MemoryBytes = _framePool->GetNumBytes ( );
+        if ( _stabilizer.GetOptions ( ).IsEnabled ( ) ) stats.StabilizeMs = _stabilizer.GetStats ( ).EstimateMs;
+        return stats;
+    }
+
+    void Capture::Impl::UpdateOcclusion ( )
+    {
+        const auto& options = _format.ThrottleWhenOccluded ( );
+        if ( !options.IsEnabled ( ) || !IsStarted ( ) ) return;
+
+        bool isOccluded = _isReportedOccluded.load ( ) || _isCovered.load ( );
+        if ( _isThrottled.exchange ( isOccluded ) == isOccluded ) return;
+
+        AX_LOG ( LogLevel::Info, "Camera %s", isOccluded ? "occluded, throttling" : "open, resuming" );
+        _owner._flightRecorder->Record ( FlightEvent::Throttled, isOccluded ? 1 : 0 );
+
+        // Setting the device type is a round trip to the driver, so it goes out on the executor.
+        // The task applies whatever the state is by the time it runs.
+        if ( options.LowerDeviceRate ( ) && !_isDeviceRateQueued.exchange ( true ) )
+        {
+            AddRef ( );
+            Executor::Get ( )->Submit ( [this]
+            {
+                _isDeviceRateQueued.store ( false );
+                {
+                    CallbackScope scope ( *this );
+                    if ( scope ) ApplyDeviceRate ( );
+                }
+                Release ( );
+            }, Executor::Priority::Background );
+        }
+    }
+
+    void Capture::Impl::ApplyDeviceRate ( )
+    {
+        std::lock_guard<std::mutex> lock ( _deviceRateMutex );
+
+        ComPtr<IMFCaptureSource> source;
+        if ( !_captureEngine || FAILED ( _captureEngine->GetSource ( source.GetAddressOf ( ) ) ) ) return;
+
+        const DWORD stream = (DWORD)MF_CAPTURE_ENGINE_PREFERRED_SOURCE_STREAM_FOR_VIDEO_PREVIEW;
+        if ( _isThrottled.load ( ) && !_resumeType )
+        {
+            ComPtr<IMFMediaType> current;
+            UINT32 width, height, fpsNum, fpsDen;
+            GUID subtype{ GUID_NULL };
+            if ( FAILED ( source->GetCurrentDeviceMediaType ( stream, current.GetAddressOf ( ) ) ) ) return;
+            if ( FAILED ( MFGetAttributeSize ( current.Get ( ), MF_MT_FRAME_SIZE, &width, &height ) ) ) return;
+            if ( FAILED ( MFGetAttributeRatio ( current.Get ( ), MF_MT_FRAME_RATE, &fpsNum, &fpsDen ) ) ) return;
+            if ( FAILED ( current->GetGUID ( MF_MT_SUBTYPE, &subtype ) ) ) return;
+
+            // Same size and subtype, so the sink and the frames don't have to change with it
+            double slowest = (double)fpsNum / (double)std::max<UINT32> ( 1, fpsDen );
+            ComPtr<IMFMediaType> type, slowestType;
+            DWORD index = 0;
+            while ( SUCCEEDED ( source->GetAvailableDeviceMediaType ( stream, index++, type.ReleaseAndGetAddressOf ( ) ) ) )
+            {
+                UINT32 w, h, num, den;
+                GUID s{ GUID_NULL };
+                if ( FAILED ( MFGetAttributeSize ( type.Get ( ), MF_MT_FRAME_SIZE, &w, &h ) ) ) continue;
+                if ( FAILED ( MFGetAttributeRatio ( type.Get ( ), MF_MT_FRAME_RATE, &num, &den ) ) ) continue;
+                if ( FAILED ( type->GetGUID ( MF_MT_SUBTYPE, &s ) ) ) continue;
+
+                double fps = (double)num / (double)std::max<UINT32> ( 1, den );
+                if ( w == width && h == height && s == subtype && fps < slowest )
+                {
+                    slowest = fps;
+                    slowestType = type;
+                }
+            }
+
+            // A single rate, frames are dropped as they arrive instead
+            if ( !slowestType ) return;
+
+            _pendingTypeChanges++;
+            if ( FAILED ( source->SetCurrentDeviceMediaType ( stream, slowestType.Get ( ) ) ) )
+            {
+                _pendingTypeChanges--;
+                AX_LOG ( LogLevel::Warning, "Couldn't lower the device's rate while occluded" );
+                return;
+            }
+
+            _resumeType = current;
+        } else if ( !_isThrottled.load ( ) && _resumeType )
+        {
+            _pendingTypeChanges++;
+            if ( FAILED ( source->SetCurrentDeviceMediaType ( stream, _resumeType.Get ( ) ) ) )
+            {
+                _pendingTypeChanges--;
+                AX_LOG ( LogLevel::Error, "Couldn't restore the device's rate after occlusion" );
+            }
+
+            _resumeType = nullptr;
+        }
+    }
+
+    bool Capture::Impl::IsIdleFrameDue ( MFTIME now )
+    {
+        const double fps = _format.ThrottleWhenOccluded ( ).IdleFPS ( );
+        if ( fps <= 0.0 ) return false;
+        if ( _lastIdleFrame != 0 && now - _lastIdleFrame < (MFTIME)( 1.0e7 / fps ) ) return false;
+
+        _lastIdleFrame = now;
+        return true;
+    }
+
+    void Capture::Impl::ApplyPowerLineFrequency ( PowerLineFrequency frequency )
+    {
+        const auto& options = _format.FlickerDetection ( );
+        AX_LOG ( LogLevel::Info, "Detected %s flicker", ToString ( frequency ) );
+
+        for ( auto& c : _owner._controls )
+        {
+            auto ctrl = dynamic_cast<ControlMSW *> ( c.get ( ) );
+            if ( !ctrl ) continue;
+
+            if ( options.AutoApply ( ) && ctrl->Set ( ) == PROPSETID_VIDCAP_VIDEOPROCAMP && ctrl->Key ( ) == KSPROPERTY_VIDEOPROCAMP_POWERLINE_FREQUENCY )
+            {
+                ctrl->Value ( ToControlValue ( frequency ) );
+            } else if ( options.AutoApply ( ) && options.AdjustExposure ( ) && ctrl->Set ( ) == PROPSETID_VIDCAP_CAMERACONTROL && ctrl->Key ( ) == KSPROPERTY_CAMERACONTROL_EXPOSURE )
+            {
+                const auto& fps = _format.FPS ( );
+                const double interval = fps.x > 0 ? (double)std::max ( 1, fps.y ) / (double)fps.x : 0.0;
+                int32_t exposure = FlickerFreeExposure ( frequency, ctrl->Value ( ), ctrl->Min ( ), ctrl->Max ( ), interval );
+                if ( exposure != ctrl->Value ( ) ) ctrl->Value ( exposure );
+            }
+        }
+
+        _owner.OnPowerLineDetected.emit ( frequency );
+    }
+
+    bool Capture::Impl::RenderStages ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, int output, double time, double& due )
+    {
+        const bool isDeinterlacing = _deinterlacer.GetOptions ( ).IsEnabled ( );
+        const bool isDenoising = _denoiser.GetOptions ( ).IsEnabled ( );
+        const bool isRemapping = _remapper.GetOptions ( ).IsEnabled ( );
+        const bool isStabilizing = _stabilizer.GetOptions ( ).IsEnabled ( );
+
+        // The view's folded into whichever geometric stage runs last, so ePTZ costs no extra
+        // pass over the pixels with them on, just a re-sampled map while the view's moving (see
+        // Remapper::SetView). Otherwise it's a pass of its own, skipped for the whole frame.
+        bool isViewing = false;
+        if ( _owner._viewport.GetOptions ( ).IsEnabled ( ) )
+        {
+            const Viewport view = _owner._viewport.Evaluate ( time );
+            const auto matrix = ViewportController::ToMatrix ( view, dst.Size );
+            if ( isStabilizing )
+            {
+                _stabilizer.SetView ( matrix );
+            } else if ( isRemapping )
+            {
+                _remapper.SetView ( matrix );
+            } else if ( !ViewportController::IsWholeFrame ( view ) )
+            {
+                _viewWarp.SetView ( matrix );
+                isViewing = true;
+            }
+        }
+
+        // Each stage writes straight into dst if it's the last one on, otherwise into scratch.
+        // The denoiser can work in place, so shares the deinterlacer's.
+        auto Scratch = [&] ( int index )
+        {
+            _stageScratch[index].resize ( (size_t)dst.Size.x * 4 * (size_t)dst.Size.y );
+            return Plane { _stageScratch[index].data ( ), (ptrdiff_t)dst.Size.x * 4, dst.Size };
+        };
+
+        if ( isDeinterlacing )
+        {
+            Plane out = isDenoising || isRemapping || isStabilizing || isViewing ? Scratch ( 0 ) : dst;
+            _deinterlacer.Process ( src, srcRowBytes, out, output );
+            src = out.Data;
+            srcRowBytes = out.RowBytes;
+        }
+
+        if ( isDenoising )
+        {
+            Plane out = isRemapping || isStabilizing || isViewing ? Scratch ( 0 ) : dst;
+            _denoiser.Process ( src, srcRowBytes, out );
+            src = out.Data;
+            srcRowBytes = out.RowBytes;
+        }
+
+        if ( isRemapping )
+        {
+            Plane out = isStabilizing ? Scratch ( 1 ) : dst;
+            _remapper.Process ( src, srcRowBytes, dst.Size, out );
+            src = out.Data;
+            srcRowBytes = out.RowBytes;
+        }
+
+        if ( isStabilizing ) return _stabilizer.Process ( src, srcRowBytes, dst, time, due );
+        if ( isViewing ) _viewWarp.Process ( src, srcRowBytes, dst.Size, dst );
+
+        due = time;
+        return true;
+    }
+
+    void Capture::Impl::PublishFrame ( MFTIME arrival )
+    {
+        MFTIME now = MFGetSystemTime ( );
+        _stats.RecordDelivery ( ( now - arrival ) * 1.0e-7 );
+        _publishTime.store ( now, std::memory_order_relaxed );
+        _hasNewFrame.store ( true );
+
+        // Only pay for the lock when someone is actually waiting
+        if ( _numFrameWaiters.load ( ) > 0 )
+        {
+            std::lock_guard<std::mutex> lock ( _frameMutex );
+            _frameReady.notify_all ( );
+        }
+    }
+
+    void Capture::Impl::TakeFrame ( ) const
+    {
+        if ( _hasNewFrame.exchange ( false ) )
+        {
+            _stats.RecordPickup ( ( MFGetSystemTime ( ) - _publishTime.load ( std::memory_order_relaxed ) ) * 1.0e-7 );
+        }
+    }
+
+    bool Capture::Impl::WaitForFrame ( double timeout ) const
+    {
+        if ( _hasNewFrame.load ( ) ) return true;
+
+        std::unique_lock<std::mutex> lock ( _frameMutex );
+        _numFrameWaiters++;
+        bool ready = _frameReady.wait_for ( lock, std::chrono::duration<double> ( std::max ( 0.0, timeout ) ), [=]
+        {
+            return _hasNewFrame.load ( ) || _isDetached.load ( );
+        } );
+        _numFrameWaiters--;
+
+        return ready && _hasNewFrame.load ( );
+    }
+
+    void Capture::Impl::SwapFrames ( )
+    {
+        std::lock_guard<std::mutex> lock ( _swapMutex );
+        std::swap ( _readIndex, _writeIndex );
+    }
+
+    FrameRef Capture::Impl::GetFrame ( ) const
+    {
+        TakeFrame ( );
+
+        // Copied under the lock, so the capture thread sees the reference in IsFrameHeld before
+        // it can come round to write into this slot again
+        std::lock_guard<std::mutex> lock ( _swapMutex );
+        return _frames[_readIndex];
+    }
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+    ci::Surface8uRef Capture::Impl::GetSurface ( ) const
+    {
+        TakeFrame ( );
+
+        std::lock_guard<std::mutex> lock ( _swapMutex );
         return _surfaces[_readIndex];
     }
 
     Capture::FrameLeaseRef Capture::Impl::GetTexture ( ) const
     {
-        _hasNewFrame.store ( false );
-        return std::make_unique<DXGIRenderPathFrameLease> ( _sharedTextures[_readIndex] );
+        TakeFrame ( );
+
+        std::lock_guard<std::mutex> lock ( _swapMutex );
+        return std::make_unique<DXGIRenderPathFrameLease> ( _sharedTextures[_readIndex], _owner._flightRecorder, _readIndex );
+    }
+#endif
+
+    bool Capture::Impl::IsFrameHeld ( int index ) const
+    {
+        // Our own reference, plus the one held by the Surface view over it
+        long owned = 1;
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        if ( _surfaces[index] )
+        {
+            if ( _surfaces[index].use_count ( ) > 1 ) return true;
+            owned++;
+        }
+#endif
+        return _frames[index].use_count ( ) > owned;
     }
 
     HRESULT STDMETHODCALLTYPE Capture::Impl::OnEvent ( IMFMediaEvent* pEvent )
     {
+        CallbackScope scope ( *this );
+        if ( !scope ) return S_OK;
+
         auto threadId = GetCurrentThreadId ( );
         MediaEventType type{};
         pEvent->GetType ( &type );
@@ -812,6 +1216,11 @@ namespace AX::Video
         {
             GUID extendedType;
             pEvent->GetExtendedType ( &extendedType );
+
+            HRESULT eventStatus{ S_OK };
+            pEvent->GetStatus ( &eventStatus );
+            _owner._flightRecorder->Record ( FlightEvent::EngineEvent, (int64_t)extendedType.Data1, eventStatus );
+
             if ( extendedType == MF_CAPTURE_ENGINE_INITIALIZED )
             {
                 ComPtr<IMFCaptureSink> sink;
@@ -822,6 +1231,8 @@ namespace AX::Video
 
                 DWORD streamIndex = -1;
 
+                SelectDeviceMediaType ( );
+
                 ComPtr<IMFMediaType> streamType;
                 MFCreateMediaType ( &streamType );
 
@@ -829,13 +1240,20 @@ namespace AX::Video
                 CheckSucceeded ( streamType->SetGUID ( MF_MT_SUBTYPE, MFVideoFormat_RGB32 ) );
                 CheckSucceeded ( MFSetAttributeRatio ( streamType.Get ( ), MF_MT_FRAME_RATE, _format.FPS().x, _format.FPS().y ) );
                 CheckSucceeded ( MFSetAttributeSize ( streamType.Get ( ), MF_MT_FRAME_SIZE, _format.Size().x, _format.Size().y ) );
+                // Hardware frames never reach the CPU deinterlacer, have the engine's video processor do it
+                if ( _format.IsHardwareAccelerated ( ) && _format.Deinterlace ( ).IsEnabled ( ) )
+                {
+                    CheckSucceeded ( streamType->SetUINT32 ( MF_MT_INTERLACE_MODE, MFVideoInterlace_Progressive ) );
+                }
 
                 CheckSucceeded ( previewSink->AddStream ( 0, streamType.Get ( ), nullptr, &streamIndex ) );
                 CheckSucceeded ( previewSink->SetSampleCallback ( 0, this ) );
                 CheckSucceeded ( previewSink->SetRotation ( 0, (int)_format.RotationAngle() * 90 ) );
+                _previewSink = previewSink;
+                _previewStream = streamIndex;
 
                 _isInitialized.store ( true );
-                app::App::get ( )->dispatchAsync ( [=] { _owner.OnInitialize.emit ( ); } );
+                DispatchToOwner ( [=] { _owner.OnInitialize.emit ( ); } );
                 
                 if ( _format.AutoStart ( ) )
                 {
@@ -844,20 +1262,49 @@ namespace AX::Video
 
             } else if ( extendedType == MF_CAPTURE_ENGINE_PREVIEW_STARTED )
             {
-                app::App::get ( )->dispatchAsync ( [=] { _owner.OnStart.emit ( ); } );
+                DispatchToOwner ( [=] { _owner.OnStart.emit ( ); } );
 
             } else if ( extendedType == MF_CAPTURE_ENGINE_PREVIEW_STOPPED )
             {
-                app::App::get ( )->dispatchAsync ( [=] { _owner.OnStop.emit ( ); } );
+                DispatchToOwner ( [=] { _owner.OnStop.emit ( ); } );
+            } else if ( extendedType == MF_CAPTURE_SOURCE_CURRENT_DEVICE_MEDIA_TYPE_SET )
+            {
+                // Size changes are picked up from the samples themselves, they're what has to fit
+                Vec2i size, fps;
+                PixelFormat subtype = PixelFormat::Unknown;
+                if ( QueryStreamFormat ( size, fps, subtype ) )
+                {
+                    // Throttling's own switches aren't the stream changing
+                    bool isOwn = false;
+                    if ( _pendingTypeChanges.load ( ) > 0 )
+                    {
+                        _pendingTypeChanges--;
+                        isOwn = true;
+                    }
+
+                    bool isFirst = _deviceFPS.x == 0;
+                    bool isChanged = fps != _deviceFPS || subtype != _deviceSubtype;
+                    _deviceFPS = fps;
+                    _deviceSubtype = subtype;
+
+                    if ( !isFirst && isChanged && !isOwn ) ChangeFormat ( { }, fps, subtype );
+                }
+
             } else if ( extendedType == MF_CAPTURE_ENGINE_ERROR )
             {
                 HRESULT status{};
                 CheckSucceeded ( pEvent->GetStatus ( &status ) );
+                _stats.RecordError ( status );
+                _owner._flightRecorder->Record ( FlightEvent::Error, status );
+
                 switch ( status )
                 {
                     case MF_E_VIDEO_RECORDING_DEVICE_INVALIDATED :
                     {
-                        app::App::get ( )->dispatchAsync ( [=] 
+                        _owner._flightRecorder->Record ( FlightEvent::DeviceLost );
+                        _owner.DumpFlightRecord ( "DeviceLost" );
+
+                        DispatchToOwner ( [=] 
                         { 
                             _isInitialized = false; 
                             _isStarted.store ( false ); // @NOTE(andrew): Don't call ::Stop() here or it'll trigger some async events to fire
@@ -869,13 +1316,14 @@ namespace AX::Video
 
                     default :
                     {
-                        app::App::get ( )->dispatchAsync ( [=] { _owner.OnError.emit ( status ); } );
+                        _owner.DumpFlightRecord ( "Error" );
+                        DispatchToOwner ( [=] { _owner.OnError.emit ( status ); } );
                     }
                 }
                 
             } else
             {
-                std::printf ( "  Unhandled Event: %S\n", GUIDToString ( extendedType ).c_str ( ) );
+                AX_LOG ( LogLevel::Verbose, "Unhandled Event: %s", ToUtf8String ( GUIDToString ( extendedType ) ).c_str ( ) );
             }
         }
         
@@ -884,10 +1332,31 @@ namespace AX::Video
 
     HRESULT STDMETHODCALLTYPE Capture::Impl::OnSample ( IMFSample* sample )
     {
+        CallbackScope scope ( *this );
+        if ( !scope ) return S_OK;
+
         ComPtr<IMFMediaBuffer> buffer;
         HRESULT hr;
         ReturnIfFailed ( sample->GetBufferByIndex ( 0, &buffer ) );
 
+        // MFGetSystemTime and the device reference time share the same QPC derived clock
+        MFTIME now = MFGetSystemTime ( );
+        double arrival = now * 1.0e-7;
+
+        {
+            LONGLONG sampleTime{ 0 };
+            UINT64 deviceTime{ 0 };
+            DWORD length{ 0 };
+
+            double time = SUCCEEDED ( sample->GetSampleTime ( &sampleTime ) ) ? sampleTime * 1.0e-7 : -1.0;
+            double latency = SUCCEEDED ( sample->GetUINT64 ( MFSampleExtension_DeviceReferenceSystemTime, &deviceTime ) ) ? ( now - (MFTIME)deviceTime ) * 1.0e-7 : -1.0;
+            sample->GetTotalLength ( &length );
+
+            _stats.RecordFrame ( arrival, time, latency, length );
+            _owner._flightRecorder->Record ( FlightEvent::SampleArrived, (int64_t)_frameSequence, length );
+        }
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
         if ( _format.IsHardwareAccelerated ( ) )
         {
             ComPtr<IMFDXGIBuffer> dxgiBuffer;
@@ -899,13 +1368,29 @@ namespace AX::Video
                 D3D11_TEXTURE2D_DESC desc;
                 texture->GetDesc ( &desc );
 
+                // The shared textures can only be replaced on the GL thread, drop frames until they are
+                Vec2i size ( (int32_t)desc.Width, (int32_t)desc.Height );
+                if ( !_isResizing.load ( ) && size != _frameSize ) ChangeFormat ( size, { }, PixelFormat::Unknown );
+                if ( _isResizing.load ( ) || !_sharedTextures[_writeIndex] )
+                {
+                    _stats.RecordDrop ( );
+                    return S_OK;
+                }
+
+                if ( _isThrottled.load ( ) && !IsIdleFrameDue ( now ) ) return S_OK;
+
                 auto& ic = InteropContext::Get ( );
                 ic.DeviceContext ( )->CopyResource ( _sharedTextures[_writeIndex]->DXTextureHandle ( ), texture.Get ( ) );
 
-                std::swap ( _readIndex, _writeIndex );
+                // Otherwise the copy sits in the command buffer until the driver gets round to it
+                if ( _format.IsLowLatency ( ) ) ic.DeviceContext ( )->Flush ( );
+
+                SwapFrames ( );
+                PublishFrame ( now );
                 return S_OK;
             }
         } else
+#endif
         {
             ComPtr<IMFMediaBuffer> mediaBuffer = nullptr;
             DWORD bmpLength = 0;
@@ -914,16 +1399,131 @@ namespace AX::Video
             ReturnIfFailed ( sample->ConvertToContiguousBuffer ( &mediaBuffer ) );
             ReturnIfFailed ( mediaBuffer->Lock ( &bmpBuffer, NULL, &bmpLength ) );
 
-            auto& surface = _surfaces[_writeIndex];
-            auto allocatedSurfaceBytes = surface ? surface->getRowBytes ( ) * surface->getHeight ( ) : 0;
-            if ( !surface || allocatedSurfaceBytes < bmpLength )
+            // A different length than last time, or too little for the size we think we're at,
+            // means the stream changed under us. Never copy a frame we can't place.
+            const DWORD expectedBytes = (DWORD)_frameSize.x * 4 * (DWORD)_frameSize.y;
+            if ( ( _lastSampleBytes != 0 && bmpLength != _lastSampleBytes ) || bmpLength < expectedBytes )
+            {
+                Vec2i size, fps;
+                PixelFormat subtype = PixelFormat::Unknown;
+                if ( QueryStreamFormat ( size, fps, subtype ) && size != _frameSize && size.x > 0 && bmpLength >= (DWORD)size.x * 4 * (DWORD)size.y )
+                {
+                    ChangeFormat ( size, { }, PixelFormat::Unknown );
+                } else if ( bmpLength < expectedBytes )
+                {
+                    CheckSucceeded ( mediaBuffer->Unlock ( ) );
+                    _stats.RecordDrop ( );
+                    return S_OK;
+                }
+            }
+            _lastSampleBytes = bmpLength;
+            const ptrdiff_t sampleRowBytes = _frameSize.y > 0 ? (ptrdiff_t)( bmpLength / (DWORD)_frameSize.y ) : 0;
+
+            // While occluded, only the fallback's sparse grid is read unless an idle frame is due
+            const auto& occlusion = _format.ThrottleWhenOccluded ( );
+            if ( occlusion.IsEnabled ( ) )
+            {
+                if ( occlusion.LuminanceFallback ( ) )
+                {
+                    bool isCovered = _coverDetector.Process ( bmpBuffer, sampleRowBytes, _frameSize );
+                    if ( isCovered != _isCovered.exchange ( isCovered ) )
+                    {
+                        UpdateOcclusion ( );
+                        if ( isCovered || !_isReportedOccluded.load ( ) )
+                        {
+                            auto state = isCovered ? OcclusionState::LensCovered : OcclusionState::Open;
+                            DispatchToOwner ( [=] { _owner.OnOcclusionChanged.emit ( state ); } );
+                        }
+                    }
+                }
+
+                if ( _isThrottled.load ( ) && !IsIdleFrameDue ( now ) )
+                {
+                    CheckSucceeded ( mediaBuffer->Unlock ( ) );
+                    return S_OK;
+                }
+            }
+
+            // Before any stage touches it, deinterlacing and denoising would blur the bands
+            if ( _flicker.GetOptions ( ).IsEnabled ( ) && _frameSize.y > 0 )
+            {
+                if ( _flicker.Process ( bmpBuffer, sampleRowBytes, _frameSize, arrival ) )
+                {
+                    auto frequency = _flicker.GetResult ( ).Frequency;
+                    DispatchToOwner ( [=] { ApplyPowerLineFrequency ( frequency ); } );
+                }
+            }
+
+            // If a frame callback (or anyone else) is still holding the frame we wrote last time
+            // round, leave it with them and write into a fresh one from the pool. Same if the
+            // buffer provider changed since it was acquired.
+            auto& frame = _frames[_writeIndex];
+            auto generation = _framePool->GetGeneration ( );
+            auto allocatedFrameBytes = frame ? frame->GetPlane ( ).RowBytes * frame->GetSize ( ).y : 0;
+            if ( !frame || frame->GetSize ( ) != _frameSize || allocatedFrameBytes < bmpLength || IsFrameHeld ( _writeIndex ) || _frameGenerations[_writeIndex] != generation )
+            {
+                frame = _framePool->Acquire ( _frameSize, PixelFormat::RGB32 );
+                _frameGenerations[_writeIndex] = generation;
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+                _surfaces[_writeIndex] = ToSurface ( frame );
+#endif
+            } else
+            {
+                // Written over in place, so nothing derived from the last pixels can be served
+                frame->ResetDerived ( );
+            }
+
+            // Provider buffers can be padded, so fall back to a row at a time when the strides differ
+            auto& plane = frame->GetPlane ( );
+            const size_t height = (size_t)plane.Size.y;
+            const size_t srcRowBytes = height > 0 ? bmpLength / height : 0;
+            const size_t dstRowBytes = (size_t)plane.RowBytes;
+            double timestamp = arrival;
+            if ( _deinterlacer.GetOptions ( ).IsEnabled ( ) || _denoiser.GetOptions ( ).IsEnabled ( ) || _remapper.GetOptions ( ).IsEnabled ( ) || _stabilizer.GetOptions ( ).IsEnabled ( ) || _owner._viewport.GetOptions ( ).IsEnabled ( ) )
             {
-                surface = Surface::create ( _format.Size ( ).x, _format.Size ( ).y, _format.Size ( ).x * 4, SurfaceChannelOrder::BGRA );
+                // At field rate the earlier field only goes to the frame callbacks, the later
+                // one becomes the latest frame as usual. The earlier one's rendered even with no
+                // callbacks, so the temporal stages (denoise, stabilise) see the same cadence
+                // whether or not anyone's listening.
+                const int outputs = _deinterlacer.GetNumOutputs ( );
+                auto callbacks = std::atomic_load ( &_owner._frameCallbacks );
+                for ( int output = 0; output + 1 < outputs; output++ )
+                {
+                    auto field = _framePool->Acquire ( _frameSize, PixelFormat::RGB32 );
+                    double due = 0.0;
+                    if ( !RenderStages ( bmpBuffer, (ptrdiff_t)srcRowBytes, field->GetPlane ( ), output, now * 1.0e-7 - _fieldInterval.load ( ) * ( outputs - 1 - output ), due ) ) continue;
+                    if ( !callbacks || callbacks->empty ( ) ) continue;
+
+                    field->SetTimestamp ( due );
+                    field->SetSequence ( _frameSequence++ );
+                    _owner.DispatchFrame ( field );
+                }
+
+                bool isDue = RenderStages ( bmpBuffer, (ptrdiff_t)srcRowBytes, plane, outputs - 1, arrival, timestamp );
+                if ( _deinterlacer.GetOptions ( ).IsEnabled ( ) ) _deinterlacer.EndFrame ( bmpBuffer, (ptrdiff_t)srcRowBytes, plane.Size );
+
+                if ( !isDue )
+                {
+                    CheckSucceeded ( mediaBuffer->Unlock ( ) );
+                    return S_OK;
+                }
+            } else if ( srcRowBytes == dstRowBytes )
+            {
+                std::memcpy ( plane.Data, bmpBuffer, std::min<size_t> ( bmpLength, dstRowBytes * height ) );
+            } else
+            {
+                const size_t rowBytes = std::min ( srcRowBytes, dstRowBytes );
+                for ( size_t y = 0; y < height; y++ ) std::memcpy ( plane.Data + dstRowBytes * y, bmpBuffer + srcRowBytes * y, rowBytes );
             }
-            
-            std::memcpy ( surface->getData ( ), bmpBuffer, bmpLength );
             CheckSucceeded ( mediaBuffer->Unlock ( ) );
-            std::swap ( _readIndex, _writeIndex );                           
+
+            frame->SetTimestamp ( timestamp );
+            frame->SetSequence ( _frameSequence++ );
+            _owner.DispatchFrame ( frame );
+            _owner._flightRecorder->OfferFrame ( frame );
+
+            SwapFrames ( );
+            PublishFrame ( now );
         }
 
         return S_OK;
@@ -931,13 +1531,16 @@ namespace AX::Video
 
     void STDMETHODCALLTYPE Capture::Impl::OnChange ( REFGUID controlSet, UINT32 id )
     {
+        CallbackScope scope ( *this );
+        if ( !scope ) return;
+
         for ( auto& c : _owner._controls )
         {
             if ( auto ctrl = dynamic_cast<ControlMSW *> ( c.get() ) )
             {
                 if ( ctrl->Set ( ) == controlSet && ctrl->Key ( ) == id )
                 {
-                    app::App::get ( )->dispatchAsync ( [=]
+                    DispatchToOwner ( [=]
                     {
                         ctrl->LoadValue ( );
                         _owner.OnControlChanged.emit ( *ctrl );
@@ -952,56 +1555,109 @@ namespace AX::Video
 
     void STDMETHODCALLTYPE Capture::Impl::OnError ( HRESULT hrStatus )
     {
+        CallbackScope scope ( *this );
+        if ( !scope ) return;
+
+        if ( FAILED ( hrStatus ) )
+        {
+            _stats.RecordError ( hrStatus );
+            _owner._flightRecorder->Record ( FlightEvent::Error, hrStatus );
+            _owner.DumpFlightRecord ( "ControlError" );
+        }
+
         CheckSucceeded ( hrStatus );
     }
 
     HRESULT STDMETHODCALLTYPE Capture::Impl::OnOcclusionStateReport ( IMFCameraOcclusionStateReport* occlusionStateReport )
     {
+        CallbackScope scope ( *this );
+        if ( !scope ) return S_OK;
+
         OcclusionState state{ 0 };
         CheckSucceeded ( occlusionStateReport->GetOcclusionState ( (DWORD *)&state ) );
+
+        _isReportedOccluded.store ( state != OcclusionState::Open );
+        UpdateOcclusion ( );
  
-        app::App::get ( )->dispatchAsync ( [=] { _owner.OnOcclusionChanged.emit ( state ); } );
+        DispatchToOwner ( [=] { _owner.OnOcclusionChanged.emit ( state ); } );
 
         return S_OK;
     }
 
     HRESULT STDMETHODCALLTYPE Capture::Impl::QueryInterface ( REFIID riid, _COM_Outptr_ void __RPC_FAR* __RPC_FAR* ppvObject )
     {
-        if ( riid == __uuidof ( IMFCaptureEngineOnSampleCallback ) )
+        if ( riid == __uuidof ( IUnknown ) || riid == __uuidof ( IMFCaptureEngineOnSampleCallback ) )
         {
-            *ppvObject = this;
-            return S_OK;
+            *ppvObject = static_cast<IMFCaptureEngineOnSampleCallback *> ( this );
         } else if ( riid == __uuidof ( IMFCaptureEngineOnEventCallback ) )
         {
-            *ppvObject = this;
-            return S_OK;
+            *ppvObject = static_cast<IMFCaptureEngineOnEventCallback *> ( this );
+        } else if ( riid == __uuidof ( IMFCameraControlNotify ) )
+        {
+            *ppvObject = static_cast<IMFCameraControlNotify *> ( this );
+        } else if ( riid == __uuidof ( IMFCameraOcclusionStateReportCallback ) )
+        {
+            *ppvObject = static_cast<IMFCameraOcclusionStateReportCallback *> ( this );
         } else
         {
             *ppvObject = nullptr;
+            return E_NOINTERFACE;
         }
 
-        return E_NOINTERFACE;
+        AddRef ( );
+        return S_OK;
     }
 
     ULONG STDMETHODCALLTYPE Capture::Impl::AddRef ( void )
     {
-        return 1;
+        return ++_refCount;
     }
 
     ULONG STDMETHODCALLTYPE Capture::Impl::Release ( void )
     {
-        return 1;
+        ULONG count = --_refCount;
+        if ( count == 0 ) delete this;
+        return count;
     }
 
-    Capture::Impl::~Impl ( )
+    void Capture::Impl::Detach ( )
     {
+        if ( _isDetached.exchange ( true ) ) return;
+
+        int inside = (int)std::count ( kCallbackStack.begin ( ), kCallbackStack.end ( ), this );
+        while ( _callbacksInside.load ( ) > inside ) std::this_thread::yield ( );
+
         _hasNewFrame.store ( false );
+
+        // The controls unsubscribe from the monitor Teardown() is about to shut down
+        _owner._controls.clear ( );
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        // GL objects, so they have to go on this thread. OnSample can't reach them any more.
+        _sharedTextures[0].reset ( );
+        _sharedTextures[1].reset ( );
+#endif
+
+        // Nothing more is coming
+        std::lock_guard<std::mutex> lock ( _frameMutex );
+        _frameReady.notify_all ( );
+    }
+
+    void Capture::Impl::Teardown ( )
+    {
+        // Releasing the engine and monitors also drops their references to us
         if ( _monitor ) _monitor->Shutdown ( );
         if ( _occlusion ) _occlusion->Stop ( );
+        _monitor = nullptr;
+        _occlusion = nullptr;
+        _previewSink = nullptr;
         _captureEngine = nullptr;
-        _sharedTextures[0].reset ( );
-        _sharedTextures[1].reset ( );
-        
-        OnCaptureDestroyed ( );
+
+        // The runtime lingers, rather than shutting down under the next capture
+        _runtime = nullptr;
+    }
+
+    Capture::Impl::~Impl ( )
+    {
     }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 #include <queue>
 
@@ -39,12 +40,17 @@ using namespace Microsoft::WRL;
 #endif
 
 #include "AX-VideoCapture.h"
+#include "AX-VideoCaptureStats.h"
+#include "AX-VideoCaptureFramePool.h"
+#include "AX-VideoCaptureRuntime.h"
 
 namespace AX::Video
 {
+#ifndef AX_VIDEOCAPTURE_HEADLESS
     class  SharedTexture;
     struct SharedTextureDeleter { void operator() ( SharedTexture* ) const; };
     using  SharedTextureRef = std::unique_ptr<SharedTexture, SharedTextureDeleter>;
+#endif
 
     class Capture::Impl 
         : public IMFCaptureEngineOnSampleCallback
@@ -56,12 +62,23 @@ namespace AX::Video
         Impl    ( Capture & owner, const Format& format );
 
         static std::vector<Capture::DeviceDescriptor> GetDevices ( bool refresh );
+        // Registers for hotplug notifications, once
+        static void                                   WatchDevices ( );
         static std::vector<Capture::DeviceProfile>    GetProfiles ( const DeviceDescriptor& descriptor );
+        static Capture::DeviceTopology                GetDeviceTopology ( const DeviceDescriptor& descriptor );
+        static double                                 GetTime ( ) { return MFGetSystemTime ( ) * 1.0e-7; }
         
-        const   ci::ivec2 &         GetSize ( ) const { return _format.Size(); }
+        const   Vec2i &             GetSize ( ) const { return _format.Size(); }
         bool                        CheckNewFrame ( ) const { return _hasNewFrame.load ( ); }
-        const   ci::Surface8uRef &  GetSurface ( ) const;
+        bool                        WaitForFrame ( double timeout ) const;
+        Capture::Stats              GetStats ( ) const;
+        void                        ResetStats ( ) { _stats.Reset ( ); }
+        void                        SetBufferProvider ( const BufferProvider& provider ) { _framePool->SetProvider ( provider ); }
+        FrameRef                    GetFrame ( ) const;
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        ci::Surface8uRef            GetSurface ( ) const;
         Capture::FrameLeaseRef      GetTexture ( ) const;
+#endif
 
         void                        Start ( );
         void                        Stop ( );
@@ -69,6 +86,13 @@ namespace AX::Video
         bool                        IsStopped ( ) const;
         bool                        IsValid ( ) const { return _isValid; }
 
+        // Destruction happens in two halves. Detach() runs on the owner's thread and returns
+        // once nothing can reach the Capture any more (GL resources are released here too).
+        // Teardown() stops and releases the engine, which can take a while, and is safe on any
+        // thread. The last Release() (ours, or one Media Foundation is still holding) deletes.
+        void                        Detach ( );
+        void                        Teardown ( );
+
         // IMFCaptureEngineOnEventCallback
         HRESULT STDMETHODCALLTYPE   OnEvent ( IMFMediaEvent* pEvent ) override;
 
@@ -87,13 +111,64 @@ namespace AX::Video
         ULONG STDMETHODCALLTYPE     AddRef ( void ) override;
         ULONG STDMETHODCALLTYPE     Release ( void ) override;
         
+    protected:
+
         ~Impl ( );
 
-    protected:
+        // Held by every callback for as long as it touches _owner. Closed by Detach().
+        struct CallbackScope
+        {
+            CallbackScope                   ( Impl& impl );
+            ~CallbackScope                  ( );
+            explicit operator bool          ( ) const { return _isOpen; }
+
+            Impl&                           _impl;
+            bool                            _isOpen{ false };
+        };
+
+        // DispatchToMain, but the call is dropped if the capture has gone away in the meantime,
+        // and the capture is kept alive while it runs (so a signal handler can destroy it)
+        template <typename Fn>
+        void                            DispatchToOwner ( Fn&& fn );
+
+        void                            SelectDeviceMediaType ( );
+        // What the preview stream delivers now (size) and what the device is running (rate, subtype)
+        bool                            QueryStreamFormat ( Vec2i& size, Vec2i& fps, PixelFormat& subtype );
+        // Any callback thread. Zero / Unknown leave that part of the format as it was.
+        void                            ChangeFormat ( const Vec2i& size, const Vec2i& fps, PixelFormat subtype );
+        // Owner thread, reallocates whatever depends on the format and tells the owner
+        void                            ApplyFormatChange ( const Vec2i& size, const Vec2i& fps, PixelFormat subtype );
+        bool                            IsFrameHeld ( int index ) const;
+        // Capture thread. Runs the software frame stages (deinterlace, denoise, remap, stabilise) from
+        // src into dst. The ePTZ crop rides along with the last geometric stage, or is its own
+        // resample when neither's on. False while the stabiliser's lookahead is filling, otherwise due is the
+        // time of the frame written, which the lookahead can put behind time.
+        bool                            RenderStages ( const uint8_t* src, ptrdiff_t srcRowBytes, const Plane& dst, int output, double time, double& due );
+        // Any thread. Throttles while the device reports occlusion or the lens looks covered.
+        void                            UpdateOcclusion ( );
+        // Capture thread, whether an occluded capture lets this frame through
+        bool                            IsIdleFrameDue ( MFTIME now );
+        // Executor or owner thread, moves the device to its slowest rate or back to match _isThrottled
+        void                            ApplyDeviceRate ( );
+        // Owner thread, sets the anti-flicker (and maybe exposure) controls and tells the owner
+        void                            ApplyPowerLineFrequency ( PowerLineFrequency frequency );
+        // Capture thread, hands the slot just written to the consumer
+        void                            SwapFrames ( );
+        // Capture thread, once the frame at _readIndex is ready for the consumer
+        void                            PublishFrame ( MFTIME arrival );
+        // Consumer side, clears the new frame flag and records how long the frame waited
+        void                            TakeFrame ( ) const;
         
         ComPtr<IMFCaptureEngine>        _captureEngine{ nullptr };
         ComPtr<IMFCameraControlMonitor> _monitor;
         ComPtr<IMFCameraOcclusionStateMonitor>  _occlusion;
+        ComPtr<IMFCapturePreviewSink>   _previewSink;
+        DWORD                           _previewStream{ 0 };
+
+        std::atomic<ULONG>              _refCount{ 1 };
+        std::atomic_int                 _callbacksInside{ 0 };
+        std::atomic_bool                _isDetached{ false };
+        CaptureRuntimeRef               _runtime;
 
         Capture &                       _owner;
         Capture::Format                 _format;
@@ -102,10 +177,49 @@ namespace AX::Video
         std::atomic_bool                _isStarted{ false };
         std::atomic_bool                _isInitialized{ false };
         
-        ci::Surface8uRef                _surfaces[2];
+        FrameRef                        _frames[2];
+        FramePoolRef                    _framePool{ FramePool::Create ( ) };
+        uint32_t                        _frameGenerations[2]{ 0, 0 };
+        uint64_t                        _frameSequence{ 0 };
+        uint32_t                        _numStarts{ 0 };
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+        ci::Surface8uRef                _surfaces[2];   // Views over _frames
         SharedTextureRef                _sharedTextures[2];
+#endif
         int                             _readIndex{ 0 };
         int                             _writeIndex{ 1 };
-        
+        mutable std::mutex              _swapMutex;     // Between SwapFrames and the consumer's reads of _readIndex
+
+        // Sample thread's view of the stream, _format catches up on the owner's thread
+        Vec2i                           _frameSize;
+        std::atomic<double>             _fieldInterval{ 0.0 };
+        Deinterlacer                    _deinterlacer;
+        Denoiser                        _denoiser;
+        Remapper                        _remapper;
+        Stabilizer                      _stabilizer;
+        Remapper                        _viewWarp;
+        FlickerDetector                 _flicker;
+        CoveredLensDetector             _coverDetector;
+        std::atomic_bool                _isReportedOccluded{ false };
+        std::atomic_bool                _isCovered{ false };
+        std::atomic_bool                _isThrottled{ false };
+        std::atomic_bool                _isDeviceRateQueued{ false };
+        std::atomic_int                 _pendingTypeChanges{ 0 };   // Device type changes of our own, not the stream's
+        std::mutex                      _deviceRateMutex;
+        ComPtr<IMFMediaType>            _resumeType;                // The device's type from before throttling
+        MFTIME                          _lastIdleFrame{ 0 };
+        std::vector<uint8_t>            _stageScratch[2];       // Between stages, when more than one is on
+        DWORD                           _lastSampleBytes{ 0 };
+        std::atomic_bool                _isResizing{ false };   // Hardware frames are dropped until the textures are replaced
+        // Event thread, the device type last reported
+        Vec2i                           _deviceFPS;
+        PixelFormat                     _deviceSubtype{ PixelFormat::Unknown };
+
+        mutable FrameStatistics         _stats;
+        std::atomic<MFTIME>             _publishTime{ 0 };
+
+        mutable std::mutex              _frameMutex;
+        mutable std::condition_variable _frameReady;
+        mutable std::atomic_int         _numFrameWaiters{ 0 };
     };
 }
@@ -0,0 +1,176 @@
+//
+//  AX-VideoCaptureMSWInterop.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+
+#include "AX-VideoCaptureMSWInterop.h"
+#include "AX-VideoCaptureMSWCommon.h"
+
+#if (CINDER_VERSION < 903)
+    // Cinder 0.9.2 and younger used GLLoad
+#include "glload/wgl_all.h"
+#else
+    // Cinder 0.9.3 and (presumably) going forward uses GLAD
+#include "glad/glad_wgl.h"
+#endif
+
+#include <dxgi.h>
+
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "dxgi.lib")
+
+using namespace ci;
+
+namespace AX::Video
+{
+    static InteropContext* kInteropContext{ nullptr };
+
+    void InteropContext::StaticInitialize ( )
+    {
+        if ( !kInteropContext )
+        {
+            kInteropContext = new InteropContext ( );
+        }
+    }
+
+    void InteropContext::StaticShutdown ( )
+    {
+        delete kInteropContext;
+        kInteropContext = nullptr;
+    }
+
+    InteropContext& InteropContext::Get ( )
+    {
+        assert ( kInteropContext );
+        return *kInteropContext;
+    }
+
+    InteropContext::InteropContext ( )
+        : _isValid ( false )
+    {
+        UINT deviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_VIDEO_SUPPORT;
+
+#ifndef NDEBUG
+        deviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+        UINT resetToken{ 0 };
+        BailIfFailed ( MFCreateDXGIDeviceManager ( &resetToken, _dxgiManager.GetAddressOf ( ) ) );
+        BailIfFailed ( D3D11CreateDevice ( nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, deviceFlags, nullptr, 0, D3D11_SDK_VERSION, _device.GetAddressOf ( ), nullptr, _deviceContext.GetAddressOf ( ) ) );
+
+        ComPtr<ID3D10Multithread> multiThread{ nullptr };
+        BailIfFailed ( _device->QueryInterface ( multiThread.GetAddressOf ( ) ) );
+        multiThread->SetMultithreadProtected ( true );
+        
+        BailIfFailed ( _dxgiManager->ResetDevice ( _device.Get ( ), resetToken ) );
+
+        _interopHandle = wglDXOpenDeviceNV ( _device.Get ( ) );
+        _isValid = _interopHandle != nullptr;
+    }
+
+    SharedTextureRef InteropContext::CreateSharedTexture ( const Vec2i& size )
+    {
+        static AX::Video::SharedTextureDeleter kSharedTextureDeleter;
+
+        auto texture = SharedTextureRef ( new SharedTexture ( size ), kSharedTextureDeleter );
+        if ( texture->IsValid ( ) ) return std::move ( texture );
+
+        return nullptr;
+    }
+
+    InteropContext::~InteropContext ( )
+    {
+        if ( _interopHandle != nullptr )
+        {
+            wglDXCloseDeviceNV ( _interopHandle );
+            _interopHandle = nullptr;
+        }
+
+        _dxgiManager = nullptr;
+
+        // @leak(andrew): Debug layer is whinging about live objects but is this 
+        // this because the ComPtr destructors haven't had a chance to fire yet?
+#ifndef NDEBUG
+        if ( _device )
+        {
+            ComPtr<ID3D11Debug> debug{ nullptr };
+            if ( CheckSucceeded ( _device->QueryInterface ( debug.GetAddressOf ( ) ) ) )
+            {
+                debug->ReportLiveDeviceObjects ( D3D11_RLDO_DETAIL | D3D11_RLDO_IGNORE_INTERNAL );
+            }
+        }
+#endif
+    }
+
+    SharedTexture::SharedTexture ( const Vec2i& size )
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = size.x;
+        desc.Height = size.y;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_B8G8R8X8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+        desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+
+        auto& context = InteropContext::Get ( );
+
+        if ( SUCCEEDED ( context.Device ( )->CreateTexture2D ( &desc, nullptr, _dxTexture.GetAddressOf ( ) ) ) )
+        {
+            gl::Texture::Format fmt;
+            fmt.internalFormat ( GL_RGBA ).loadTopDown ( );
+
+            _glTexture = gl::Texture::create ( size.x, size.y, fmt );
+            _shareHandle = wglDXRegisterObjectNV ( context.Handle ( ), _dxTexture.Get ( ), _glTexture->getId ( ), GL_TEXTURE_2D, WGL_ACCESS_READ_ONLY_NV );
+            _isValid = _shareHandle != nullptr;
+        }
+    }
+
+    bool SharedTexture::Lock ( )
+    {
+        assert ( !IsLocked ( ) );
+        _isLocked = wglDXLockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle );
+        return _isLocked;
+    }
+
+    bool SharedTexture::Unlock ( )
+    {
+        assert ( IsLocked ( ) );
+        if ( wglDXUnlockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle ) )
+        {
+            _isLocked = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    SharedTexture::~SharedTexture ( )
+    {
+        if ( _shareHandle != nullptr )
+        {
+            if ( wglGetCurrentContext ( ) != nullptr ) // No GL Context, so we're likely in the process of shutting down
+            {
+                if ( IsLocked ( ) ) wglDXUnlockObjectsNV ( InteropContext::Get ( ).Handle ( ), 1, &_shareHandle );
+                wglDXUnregisterObjectNV ( InteropContext::Get ( ).Handle ( ), _shareHandle );
+                _shareHandle = nullptr;
+            }
+        }
+    }
+
+    void SharedTextureDeleter::operator ( ) ( SharedTexture* ptr ) const
+    {
+        std::default_delete<SharedTexture> deleter;
+        deleter ( ptr );
+    }
+}
+
+#endif
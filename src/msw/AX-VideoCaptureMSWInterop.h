@@ -0,0 +1,114 @@
+//
+//  AX-VideoCaptureMSWInterop.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+// D3D11 <-> GL texture sharing for the hardware accelerated path. This is the only part of
+// the backend that needs Cinder and GL, so it drops out of headless builds entirely.
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+
+#include "AX-VideoCaptureMSWImpl.h"
+#include <d3d11.h>
+
+namespace AX::Video
+{
+    // @note(andrew): Have a single D3D + interop context for all capture sessions
+    class InteropContext
+    {
+    public:
+
+        static void                     StaticInitialize ( );
+        static void                     StaticShutdown ( );
+        static InteropContext&          Get ( );
+
+        InteropContext ( const InteropContext& ) = delete;
+        InteropContext& operator = ( const InteropContext& ) = delete;
+        ~InteropContext ( );
+
+        inline ID3D11Device*            Device ( ) const { return _device.Get ( ); }
+        inline ID3D11DeviceContext*     DeviceContext ( ) const { return _deviceContext.Get ( ); }
+        inline HANDLE                   Handle ( ) const { return _interopHandle; }
+        inline IMFDXGIDeviceManager*    DXGIManager ( ) const { return _dxgiManager.Get ( ); }
+
+        SharedTextureRef                CreateSharedTexture ( const Vec2i& size );
+        inline bool                     IsValid ( ) const { return _isValid; }
+
+    protected:
+
+        InteropContext ( );
+
+        ComPtr<ID3D11Device>            _device{ nullptr };
+        ComPtr<ID3D11DeviceContext>     _deviceContext{ nullptr };
+        ComPtr<IMFDXGIDeviceManager>    _dxgiManager{ nullptr };
+
+        HANDLE                          _interopHandle{ nullptr };
+        bool                            _isValid{ false };
+    };
+
+    class SharedTexture
+    {
+    public:
+
+        SharedTexture               ( const Vec2i& size );
+        ~SharedTexture              ( );
+
+        bool                        Lock ( );
+        bool                        Unlock ( );
+        inline bool                 IsLocked ( ) const { return _isLocked; }
+
+        inline bool                 IsValid ( ) const { return _isValid; }
+        ID3D11Texture2D*            DXTextureHandle ( ) const { return _dxTexture.Get ( ); }
+        const ci::gl::TextureRef&   GLTextureHandle ( ) const { return _glTexture; }
+
+    protected:
+
+        ci::gl::TextureRef          _glTexture;
+        ComPtr<ID3D11Texture2D>     _dxTexture{ nullptr };
+        HANDLE                      _shareHandle{ nullptr };
+        bool                        _isValid{ false };
+        bool                        _isLocked{ false };
+    };
+
+    class DXGIRenderPathFrameLease : public FrameLease
+    {
+    public:
+
+        DXGIRenderPathFrameLease ( const SharedTextureRef& texture, const FlightRecorderRef& recorder = nullptr, int index = 0 )
+            : _texture ( texture )
+            , _recorder ( recorder )
+            , _index ( index )
+        {
+            if ( _texture ) _texture->Lock ( );
+            if ( _recorder ) _recorder->Record ( FlightEvent::LeaseAcquired, _index );
+        }
+
+        inline bool        IsValid ( ) const override { return ToTexture ( ) != nullptr; }
+        ci::gl::TextureRef ToTexture ( ) const override { return _texture ? _texture->GLTextureHandle ( ) : nullptr; };
+
+        ~DXGIRenderPathFrameLease ( )
+        {
+            if ( _texture && _texture->IsLocked ( ) )
+            {
+                _texture->Unlock ( );
+                _texture = nullptr;
+            }
+
+            if ( _recorder ) _recorder->Record ( FlightEvent::LeaseReleased, _index );
+        }
+
+    protected:
+
+        SharedTextureRef    _texture;           // Kept alive if a format change replaces it meanwhile
+        FlightRecorderRef   _recorder;
+        int                 _index{ 0 };
+    };
+}
+
+#endif
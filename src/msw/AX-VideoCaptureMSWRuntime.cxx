@@ -0,0 +1,264 @@
+//
+//  AX-VideoCaptureMSWRuntime.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureMSWImpl.h"
+#include "AX-VideoCaptureMSWCommon.h"
+#include "AX-VideoCaptureMSWInterop.h"
+#include "AX-VideoCaptureRuntime.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+namespace AX::Video
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double MillisecondsSince ( Clock::time_point start )
+        {
+            return std::chrono::duration<double, std::milli> ( Clock::now ( ) - start ).count ( );
+        }
+
+        struct Runtime
+        {
+            std::mutex                  Mutex;
+            int                         NumHolders{ 0 };
+            uint64_t                    Generation{ 0 };    // Bumped by every Acquire, so a pending shutdown can tell it's stale
+            bool                        IsMFRunning{ false };
+            bool                        IsInteropRunning{ false };
+            double                      Linger{ 5.0 };
+            CaptureRuntime::Timings     Timings;
+
+            std::condition_variable     Wake;
+            std::thread                 Thread;
+            bool                        IsRunning{ true };
+            bool                        HasDeadline{ false };
+            Clock::time_point           Deadline;
+
+            ~Runtime ( )
+            {
+                {
+                    std::lock_guard<std::mutex> lock ( Mutex );
+                    IsRunning = false;
+                }
+
+                Wake.notify_all ( );
+                if ( Thread.joinable ( ) ) Thread.join ( );
+
+                // The GL context is most likely gone by now, so the interop context is left be
+                if ( IsMFRunning ) MFShutdown ( );
+            }
+
+            // The rest are called with Mutex held
+            void StartUp ( bool hardwareAccelerated )
+            {
+                if ( IsMFRunning && ( !hardwareAccelerated || IsInteropRunning ) )
+                {
+                    Timings.NumReuses++;
+                }
+
+                if ( !IsMFRunning )
+                {
+                    auto start = Clock::now ( );
+                    HRESULT hr = MFStartup ( MF_VERSION );
+                    if ( SUCCEEDED ( hr ) )
+                    {
+                        IsMFRunning = true;
+                        Timings.NumStartups++;
+                        Timings.StartupMs = MillisecondsSince ( start );
+                        Timings.TotalStartupMs += Timings.StartupMs;
+                        AX_LOG ( LogLevel::Info, "Media Foundation started in %.2fms", Timings.StartupMs );
+                    } else
+                    {
+                        AX_PRINT_HR ( LogLevel::Error, "MFStartup", hr );
+                    }
+                }
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+                if ( hardwareAccelerated && !IsInteropRunning )
+                {
+                    // A failed attempt leaves its (invalid) context behind for Get, so start over
+                    auto start = Clock::now ( );
+                    InteropContext::StaticShutdown ( );
+                    InteropContext::StaticInitialize ( );
+
+                    if ( InteropContext::Get ( ).IsValid ( ) )
+                    {
+                        IsInteropRunning = true;
+                        Timings.NumDeviceStartups++;
+                        Timings.DeviceStartupMs = MillisecondsSince ( start );
+                        Timings.TotalDeviceStartupMs += Timings.DeviceStartupMs;
+                        AX_LOG ( LogLevel::Info, "D3D11 device and GL interop started in %.2fms", Timings.DeviceStartupMs );
+                    } else
+                    {
+                        AX_LOG ( LogLevel::Error, "Unable to start the D3D11 device and GL interop" );
+                    }
+                }
+#endif
+            }
+
+            void ShutDown ( )
+            {
+                HasDeadline = false;
+                if ( !IsMFRunning && !IsInteropRunning ) return;
+
+#ifndef AX_VIDEOCAPTURE_HEADLESS
+                if ( IsInteropRunning )
+                {
+                    InteropContext::StaticShutdown ( );
+                    IsInteropRunning = false;
+                }
+#endif
+
+                if ( IsMFRunning )
+                {
+                    MFShutdown ( );
+                    IsMFRunning = false;
+                }
+
+                Timings.NumShutdowns++;
+                AX_LOG ( LogLevel::Verbose, "Capture runtime shut down" );
+            }
+
+            void ScheduleShutDown ( )
+            {
+                // Media Foundation doesn't mind which thread it's shut down on, the interop
+                // context has to go on the GL thread so always takes the timer's route
+                if ( Linger <= 0.0 && !IsInteropRunning )
+                {
+                    ShutDown ( );
+                    return;
+                }
+
+                Deadline = Clock::now ( ) + std::chrono::duration_cast<Clock::duration> ( std::chrono::duration<double> ( std::max ( 0.0, Linger ) ) );
+                HasDeadline = true;
+
+                if ( !Thread.joinable ( ) ) Thread = std::thread ( [=] { Run ( ); } );
+                Wake.notify_all ( );
+            }
+
+            void ShutDownIfIdle ( uint64_t generation )
+            {
+                std::lock_guard<std::mutex> lock ( Mutex );
+                if ( NumHolders == 0 && Generation == generation ) ShutDown ( );
+            }
+
+            void Run ( );
+        };
+
+        std::atomic_bool kIsShutDown{ false };
+
+        Runtime& GetRuntime ( )
+        {
+            static struct Holder
+            {
+                Runtime Instance;
+                ~Holder ( ) { kIsShutDown = true; }
+            } kHolder;
+
+            return kHolder.Instance;
+        }
+
+        void Runtime::Run ( )
+        {
+            std::unique_lock<std::mutex> lock ( Mutex );
+            while ( IsRunning )
+            {
+                if ( !HasDeadline )
+                {
+                    Wake.wait ( lock );
+                    continue;
+                }
+
+                if ( Clock::now ( ) < Deadline )
+                {
+                    Wake.wait_until ( lock, Deadline );
+                    continue;
+                }
+
+                HasDeadline = false;
+                if ( NumHolders > 0 ) continue;
+
+                if ( IsInteropRunning )
+                {
+                    uint64_t generation = Generation;
+                    lock.unlock ( );
+                    DispatchToMain ( [generation] { GetRuntime ( ).ShutDownIfIdle ( generation ); } );
+                    lock.lock ( );
+                } else
+                {
+                    ShutDown ( );
+                }
+            }
+        }
+    }
+
+    CaptureRuntimeRef CaptureRuntime::Acquire ( bool hardwareAccelerated )
+    {
+#ifdef AX_VIDEOCAPTURE_HEADLESS
+        hardwareAccelerated = false;
+#endif
+
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+
+        runtime.Generation++;
+        runtime.HasDeadline = false;
+        runtime.StartUp ( hardwareAccelerated );
+        runtime.NumHolders++;
+
+        return CaptureRuntimeRef ( new CaptureRuntime ( hardwareAccelerated ) );
+    }
+
+    CaptureRuntime::~CaptureRuntime ( )
+    {
+        if ( kIsShutDown ) return;
+
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        if ( --runtime.NumHolders == 0 ) runtime.ScheduleShutDown ( );
+    }
+
+    void CaptureRuntime::SetLinger ( double seconds )
+    {
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        runtime.Linger = seconds;
+    }
+
+    double CaptureRuntime::GetLinger ( )
+    {
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        return runtime.Linger;
+    }
+
+    void CaptureRuntime::Shutdown ( )
+    {
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        if ( runtime.NumHolders == 0 ) runtime.ShutDown ( );
+    }
+
+    bool CaptureRuntime::IsRunning ( )
+    {
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        return runtime.IsMFRunning;
+    }
+
+    CaptureRuntime::Timings CaptureRuntime::GetTimings ( )
+    {
+        auto& runtime = GetRuntime ( );
+        std::lock_guard<std::mutex> lock ( runtime.Mutex );
+        return runtime.Timings;
+    }
+}
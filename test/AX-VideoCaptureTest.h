@@ -0,0 +1,45 @@
+//
+//  AX-VideoCaptureTest.h
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// Just enough to run a handful of checks and report through ctest's exit code
+namespace AX::Video::Test
+{
+    struct Case
+    {
+        const char *            Name;
+        std::function<void ( )> Run;
+    };
+
+    inline int & Failures ( )
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline int Run ( const std::vector<Case>& cases )
+    {
+        for ( auto& c : cases )
+        {
+            int before = Failures ( );
+            c.Run ( );
+            std::printf ( "%s %s\n", Failures ( ) == before ? "[ PASS ]" : "[ FAIL ]", c.Name );
+        }
+
+        return Failures ( ) == 0 ? 0 : 1;
+    }
+}
+
+#define AX_CHECK(condition) \
+    do { if ( !( condition ) ) { std::printf ( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition ); AX::Video::Test::Failures ( )++; } } while ( 0 )
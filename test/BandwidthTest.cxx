@@ -0,0 +1,245 @@
+//
+//  BandwidthTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureBandwidth.h"
+#include <cmath>
+
+using namespace AX::Video;
+
+namespace
+{
+    DeviceProfile MakeProfile ( int32_t w, int32_t h, int32_t fps, PixelFormat subtype )
+    {
+        DeviceProfile profile;
+        profile.Size = Vec2i ( w, h );
+        profile.FPS = Vec2i ( fps, 1 );
+        profile.Subtype = subtype;
+        return profile;
+    }
+
+    // A fake camera hanging off the given controller (empty for unknown)
+    BandwidthPlanner::PlannerDevice MakeDevice ( const std::string& id, const std::string& controller, BusSpeed speed, const std::vector<DeviceProfile>& profiles )
+    {
+        BandwidthPlanner::PlannerDevice device;
+        device.Descriptor.Name = "Camera " + id;
+        device.Descriptor.ID = id;
+        device.Topology.Controller = controller;
+        device.Topology.Hub = controller.empty ( ) ? "" : controller + "/hub";
+        device.Topology.Speed = speed;
+        device.Profiles = profiles;
+        return device;
+    }
+
+    const DeviceProfile kVGA = MakeProfile ( 640, 480, 30, PixelFormat::YUY2 );         // 18.4 MB/s
+    const DeviceProfile kSVGA = MakeProfile ( 800, 600, 30, PixelFormat::YUY2 );        // 28.8 MB/s
+    const DeviceProfile k720p = MakeProfile ( 1280, 720, 30, PixelFormat::YUY2 );       // 55.3 MB/s
+    const DeviceProfile k1080p = MakeProfile ( 1920, 1080, 30, PixelFormat::YUY2 );     // 124.4 MB/s
+
+    void TestEstimate ( )
+    {
+        AX_CHECK ( BandwidthPlanner::EstimateBandwidth ( kVGA ) == 640.0 * 480.0 * 2.0 * 30.0 );
+        AX_CHECK ( BandwidthPlanner::EstimateBandwidth ( MakeProfile ( 640, 480, 30, PixelFormat::NV12 ) ) == 640.0 * 480.0 * 1.5 * 30.0 );
+
+        auto mjpeg = MakeProfile ( 1280, 720, 30, PixelFormat::MJPEG );
+        auto options = BandwidthPlanner::Options ( ).MJPEGCompression ( 0.1 );
+        AX_CHECK ( std::abs ( BandwidthPlanner::EstimateBandwidth ( mjpeg, options ) - 1280.0 * 720.0 * 0.2 * 30.0 ) < 1.0e-3 );
+    }
+
+    void TestSharedController ( )
+    {
+        // Two cameras on one USB2 controller can't both have SVGA, one of them steps down
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "pci0", BusSpeed::USB2, { kVGA, kSVGA } ),
+            MakeDevice ( "b", "pci0", BusSpeed::USB2, { kVGA, kSVGA } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 1 );
+
+        auto& usage = plan.Buses["pci0"];
+        AX_CHECK ( usage.Devices == 2 );
+        AX_CHECK ( usage.Used <= usage.Budget );
+
+        size_t svga = 0;
+        for ( auto& assignment : plan.Assignments ) svga += assignment.Profile == kSVGA ? 1 : 0;
+        AX_CHECK ( svga == 1 );
+    }
+
+    void TestSeparateControllers ( )
+    {
+        // The same pair on their own controllers both get the better mode
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "pci0", BusSpeed::USB2, { kVGA, kSVGA } ),
+            MakeDevice ( "b", "pci1", BusSpeed::USB2, { kVGA, kSVGA } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 2 );
+        for ( auto& assignment : plan.Assignments ) AX_CHECK ( assignment.Profile == kSVGA );
+    }
+
+    void TestGroupByHub ( )
+    {
+        // Different hubs on the same controller still share the controller's budget
+        auto a = MakeDevice ( "a", "pci0", BusSpeed::USB2, { kVGA, kSVGA } );
+        auto b = MakeDevice ( "b", "pci0", BusSpeed::USB2, { kVGA, kSVGA } );
+        b.Topology.Hub = "pci0/other";
+
+        auto plan = BandwidthPlanner ( BandwidthPlanner::Options ( ).GroupBy ( BandwidthPlanner::Grouping::Hub ) ).Solve ( { a, b } );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 3 );
+        AX_CHECK ( plan.Buses["pci0"].Devices == 2 );
+        AX_CHECK ( plan.Buses["pci0"].Used <= plan.Buses["pci0"].Budget );
+        AX_CHECK ( plan.Find ( a.Descriptor )->Bus == "pci0/hub" );
+
+        size_t svga = 0;
+        for ( auto& assignment : plan.Assignments ) svga += assignment.Profile == kSVGA ? 1 : 0;
+        AX_CHECK ( svga == 1 );
+    }
+
+    void TestHubBudget ( )
+    {
+        // A USB2 hub on a USB3 controller: the controller has room, the hub doesn't
+        auto a = MakeDevice ( "a", "xhci0", BusSpeed::USB2, { kVGA, kSVGA } );
+        auto b = MakeDevice ( "b", "xhci0", BusSpeed::USB2, { kVGA, kSVGA } );
+        auto c = MakeDevice ( "c", "xhci0", BusSpeed::USB3, { kVGA, k1080p } );
+        c.Topology.Hub = "xhci0/other";
+
+        auto plan = BandwidthPlanner ( BandwidthPlanner::Options ( ).GroupBy ( BandwidthPlanner::Grouping::Hub ) ).Solve ( { a, b, c } );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Find ( c.Descriptor )->Profile == k1080p );
+        AX_CHECK ( !( plan.Find ( a.Descriptor )->Profile == plan.Find ( b.Descriptor )->Profile ) );
+        AX_CHECK ( plan.Buses["xhci0/hub"].Used <= plan.Buses["xhci0/hub"].Budget );
+    }
+
+    void TestUSB3 ( )
+    {
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "xhci0", BusSpeed::USB3, { kVGA, k720p, k1080p } ),
+            MakeDevice ( "b", "xhci0", BusSpeed::USB3, { kVGA, k720p, k1080p } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        for ( auto& assignment : plan.Assignments ) AX_CHECK ( assignment.Profile == k1080p );
+    }
+
+    void TestMixedSpeeds ( )
+    {
+        // USB2 cameras on a USB3 controller only get USB2's bandwidth between them, the USB3
+        // camera beside them isn't held back
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "xhci0", BusSpeed::USB2, { kVGA, kSVGA } ),
+            MakeDevice ( "b", "xhci0", BusSpeed::USB2, { kVGA, kSVGA } ),
+            MakeDevice ( "c", "xhci0", BusSpeed::USB3, { kVGA, k1080p } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 2 );
+        AX_CHECK ( plan.Buses["xhci0:usb2"].Devices == 2 );
+        AX_CHECK ( plan.Buses["xhci0:usb2"].Used <= plan.Buses["xhci0:usb2"].Budget );
+        AX_CHECK ( plan.Buses["xhci0"].Budget > plan.Buses["xhci0:usb2"].Budget );
+        AX_CHECK ( plan.Find ( devices[2].Descriptor )->Profile == k1080p );
+
+        size_t svga = 0;
+        for ( auto& assignment : plan.Assignments ) svga += assignment.Profile == kSVGA ? 1 : 0;
+        AX_CHECK ( svga == 1 );
+    }
+
+    void TestOversubscribed ( )
+    {
+        // Nothing any of them offers fits beside the others, so some are left off
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "pci0", BusSpeed::USB2, { kSVGA } ),
+            MakeDevice ( "b", "pci0", BusSpeed::USB2, { kSVGA } ),
+            MakeDevice ( "c", "pci0", BusSpeed::USB2, { kSVGA } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( !plan.IsComplete );
+
+        size_t assigned = 0;
+        for ( auto& assignment : plan.Assignments ) assigned += assignment.IsAssigned ? 1 : 0;
+        AX_CHECK ( assigned == 1 );
+        AX_CHECK ( plan.Buses["pci0"].Used <= plan.Buses["pci0"].Budget );
+    }
+
+    void TestUnknownTopology ( )
+    {
+        // Nothing known about where they sit: they mustn't be lumped onto one shared USB2
+        // budget, and with no speed either there's nothing to hold them to
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "", BusSpeed::Unknown, { kVGA, k1080p } ),
+            MakeDevice ( "b", "", BusSpeed::Unknown, { kVGA, k1080p } ),
+            MakeDevice ( "c", "", BusSpeed::Unknown, { kVGA, k1080p } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 3 );
+        for ( auto& assignment : plan.Assignments )
+        {
+            AX_CHECK ( assignment.Profile == k1080p );
+            AX_CHECK ( !assignment.Bus.empty ( ) );
+        }
+    }
+
+    void TestUnknownTopologyKnownSpeed ( )
+    {
+        // A known speed still budgets the device, just on a link of its own
+        std::vector<BandwidthPlanner::PlannerDevice> devices
+        {
+            MakeDevice ( "a", "", BusSpeed::USB2, { kVGA, kSVGA, k720p } ),
+            MakeDevice ( "b", "", BusSpeed::USB2, { kVGA, kSVGA, k720p } ),
+            MakeDevice ( "c", "pci0", BusSpeed::USB2, { kVGA, kSVGA, k720p } ),
+        };
+
+        auto plan = BandwidthPlanner ( ).Solve ( devices );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Buses.size ( ) == 3 );
+        for ( auto& assignment : plan.Assignments ) AX_CHECK ( assignment.Profile == kSVGA );
+        AX_CHECK ( plan.Find ( devices[0].Descriptor )->Bus != plan.Find ( devices[1].Descriptor )->Bus );
+    }
+
+    void TestMinimumFPS ( )
+    {
+        auto slow = MakeProfile ( 1280, 720, 5, PixelFormat::YUY2 );
+        auto plan = BandwidthPlanner ( BandwidthPlanner::Options ( ).MinimumFPS ( 15.0 ) ).Solve ( { MakeDevice ( "a", "pci0", BusSpeed::USB2, { kVGA, slow } ) } );
+        AX_CHECK ( plan.IsComplete );
+        AX_CHECK ( plan.Assignments[0].Profile == kVGA );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "EstimateBandwidth", TestEstimate },
+        { "SharedController", TestSharedController },
+        { "SeparateControllers", TestSeparateControllers },
+        { "GroupByHub", TestGroupByHub },
+        { "HubBudget", TestHubBudget },
+        { "USB3", TestUSB3 },
+        { "MixedSpeeds", TestMixedSpeeds },
+        { "Oversubscribed", TestOversubscribed },
+        { "UnknownTopology", TestUnknownTopology },
+        { "UnknownTopologyKnownSpeed", TestUnknownTopologyKnownSpeed },
+        { "MinimumFPS", TestMinimumFPS },
+    } );
+}
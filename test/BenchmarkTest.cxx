@@ -0,0 +1,145 @@
+//
+//  BenchmarkTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureBenchmark.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace AX::Video;
+
+namespace
+{
+    ProfileBenchmark::SyntheticMode MakeMode ( int32_t w, int32_t h, int32_t fps )
+    {
+        ProfileBenchmark::SyntheticMode mode;
+        mode.Profile.Size = Vec2i ( w, h );
+        mode.Profile.FPS = Vec2i ( fps, 1 );
+        mode.Profile.Subtype = PixelFormat::YUY2;
+        return mode;
+    }
+
+    std::string ReadFile ( const std::filesystem::path& path )
+    {
+        std::ifstream in ( path );
+        std::stringstream ss;
+        ss << in.rdbuf ( );
+        return ss.str ( );
+    }
+
+    size_t Count ( const std::string& text, const std::string& what )
+    {
+        size_t count = 0;
+        for ( size_t at = text.find ( what ); at != std::string::npos; at = text.find ( what, at + what.size ( ) ) ) count++;
+        return count;
+    }
+
+    void TestSyntheticDevice ( )
+    {
+        std::vector<ProfileBenchmark::SyntheticMode> modes;
+
+        // Delivers what it advertises
+        modes.push_back ( MakeMode ( 640, 480, 30 ) );
+
+        // Advertises 60 but only manages 30, so every other frame goes missing
+        auto slow = MakeMode ( 1280, 720, 60 );
+        slow.SustainedFPS = 30.0;
+        modes.push_back ( slow );
+
+        // Loses a fifth of its frames
+        auto lossy = MakeMode ( 800, 600, 30 );
+        lossy.DropRate = 0.2;
+        modes.push_back ( lossy );
+
+        auto broken = MakeMode ( 1920, 1080, 30 );
+        broken.FailsToStart = true;
+        modes.push_back ( broken );
+
+        auto options = ProfileBenchmark::Options ( ).Duration ( 2.0 ).Warmup ( 0.25 ).StartTimeout ( 1.0 );
+        auto source = ProfileBenchmark::CreateSyntheticSource ( "Synthetic", modes );
+
+        size_t reported = 0;
+        auto results = ProfileBenchmark ( options ).Run ( *source, [&] ( const ProfileBenchmark::Result& ) { reported++; } );
+
+        AX_CHECK ( results.size ( ) == 4 );
+        AX_CHECK ( reported == 4 );
+        if ( results.size ( ) != 4 ) return;
+
+        auto& steady = results[0];
+        AX_CHECK ( steady.Started );
+        AX_CHECK ( steady.AdvertisedFPS == 30.0 );
+        AX_CHECK ( std::abs ( steady.DeliveredFPS - 30.0 ) < 3.0 );
+        AX_CHECK ( steady.Drops <= 2 );
+        AX_CHECK ( steady.LatencyMs > 20.0 && steady.LatencyMs < 40.0 );
+
+        auto& throttled = results[1];
+        AX_CHECK ( throttled.Started );
+        AX_CHECK ( throttled.AdvertisedFPS == 60.0 );
+        AX_CHECK ( std::abs ( throttled.DeliveredFPS - 30.0 ) < 3.0 );
+        AX_CHECK ( throttled.Drops >= throttled.Frames * 8 / 10 );
+
+        auto& dropping = results[2];
+        AX_CHECK ( dropping.Started );
+        // Whatever's lost is counted as dropped, and a couple of seconds is only ~60 frames so
+        // the rate itself is allowed plenty of slack
+        double rate = dropping.ToMeasurement ( ).DropRate;
+        AX_CHECK ( rate > 0.05 && rate < 0.4 );
+        AX_CHECK ( std::abs ( (double)( dropping.Frames + dropping.Drops ) - 60.0 ) <= 6.0 );
+        AX_CHECK ( dropping.DeliveredFPS < steady.DeliveredFPS );
+
+        AX_CHECK ( !results[3].Started );
+        AX_CHECK ( results[3].Frames == 0 );
+
+        // And what it writes out
+        auto dir = std::filesystem::temp_directory_path ( );
+        auto csv = dir / "AX-VideoCapture-BenchmarkTest.csv";
+        auto json = dir / "AX-VideoCapture-BenchmarkTest.json";
+
+        AX_CHECK ( ProfileBenchmark::WriteCSV ( csv.string ( ), results ) );
+        AX_CHECK ( ProfileBenchmark::WriteJSON ( json.string ( ), source->Name ( ), results ) );
+
+        auto csvText = ReadFile ( csv );
+        AX_CHECK ( csvText.rfind ( "profile,width,height,subtype,started,", 0 ) == 0 );
+        AX_CHECK ( Count ( csvText, "\n" ) == 5 );
+        AX_CHECK ( Count ( csvText, ",YUY2,1," ) == 3 );
+        AX_CHECK ( Count ( csvText, ",YUY2,0," ) == 1 );
+
+        auto jsonText = ReadFile ( json );
+        AX_CHECK ( Count ( jsonText, "\"device\": \"Synthetic\"" ) == 1 );
+        AX_CHECK ( Count ( jsonText, "\"delivered_fps\"" ) == 4 );
+        AX_CHECK ( Count ( jsonText, "\"started\": false" ) == 1 );
+
+        std::filesystem::remove ( csv );
+        std::filesystem::remove ( json );
+    }
+
+    void TestStartTimeout ( )
+    {
+        // Never delivers a frame, so it never counts as started
+        auto silent = MakeMode ( 640, 480, 30 );
+        silent.DropRate = 1.0;
+
+        auto source = ProfileBenchmark::CreateSyntheticSource ( "Silent", { silent } );
+        auto results = ProfileBenchmark ( ProfileBenchmark::Options ( ).Duration ( 0.1 ).Warmup ( 0.0 ).StartTimeout ( 0.3 ) ).Run ( *source );
+
+        AX_CHECK ( results.size ( ) == 1 );
+        AX_CHECK ( !results.empty ( ) && !results[0].Started );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "SyntheticDevice", TestSyntheticDevice },
+        { "StartTimeout", TestStartTimeout },
+    } );
+}
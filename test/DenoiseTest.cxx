@@ -0,0 +1,158 @@
+//
+//  DenoiseTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureDenoise.h"
+#include <cmath>
+
+using namespace AX::Video;
+
+namespace
+{
+    // 5 pixels wide so every row takes both the SSE2 path and the scalar tail
+    const Vec2i kSize{ 5, 4 };
+
+    struct Image
+    {
+        std::vector<uint8_t> Pixels = std::vector<uint8_t> ( (size_t)kSize.x * kSize.y * 4, 0 );
+
+        Plane   AsPlane ( ) { return { Pixels.data ( ), (ptrdiff_t)kSize.x * 4, kSize }; }
+    };
+
+    Image Filled ( uint8_t value )
+    {
+        Image image;
+        std::fill ( image.Pixels.begin ( ), image.Pixels.end ( ), value );
+        return image;
+    }
+
+    bool AllEqual ( const Image& image, uint8_t value )
+    {
+        for ( auto p : image.Pixels ) if ( p != value ) return false;
+        return true;
+    }
+
+    void TestStackIsSlidingMean ( )
+    {
+        // A small step, so the motion easing barely touches it. After Frames frames at the new
+        // level none of the old one's left, where an exponential average would still be short.
+        Denoiser denoiser ( DenoiseOptions ( DenoiseMode::Stack ).Frames ( 8 ).MotionThreshold ( 255 ) );
+        Image out;
+
+        auto before = Filled ( 100 );
+        for ( int i = 0; i < 8; i++ ) denoiser.Process ( before.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+        AX_CHECK ( AllEqual ( out, 100 ) );
+
+        auto after = Filled ( 104 );
+        for ( int i = 0; i < 4; i++ ) denoiser.Process ( after.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+        AX_CHECK ( AllEqual ( out, 102 ) );
+
+        for ( int i = 0; i < 4; i++ ) denoiser.Process ( after.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+        AX_CHECK ( AllEqual ( out, 104 ) );
+    }
+
+    void TestStackFillsWindow ( )
+    {
+        // While it fills, it's the mean of what it's seen so far
+        Denoiser denoiser ( DenoiseOptions ( DenoiseMode::Stack ).Frames ( 4 ).MotionThreshold ( 255 ) );
+        Image out;
+
+        const uint8_t levels[] = { 80, 84, 88, 92, 96 };
+        const uint8_t expected[] = { 80, 82, 84, 86, 90 };
+        for ( int i = 0; i < 5; i++ )
+        {
+            auto in = Filled ( levels[i] );
+            denoiser.Process ( in.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+            AX_CHECK ( AllEqual ( out, expected[i] ) );
+        }
+
+        // Reset starts the window again
+        denoiser.Reset ( );
+        auto in = Filled ( 10 );
+        denoiser.Process ( in.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+        AX_CHECK ( AllEqual ( out, 10 ) );
+    }
+
+    void TestRecursiveAndStackConverge ( )
+    {
+        // A static scene under noise: both modes settle on the same picture, close to the
+        // clean one and much quieter than the input. The threshold sits well clear of the noise.
+        constexpr int kTruth = 100;
+        constexpr int kFrames = 120;
+
+        Denoiser recursive ( DenoiseOptions ( DenoiseMode::Recursive ).Strength ( 0.75 ).MotionThreshold ( 96 ) );
+        Denoiser stack ( DenoiseOptions ( DenoiseMode::Stack ).Frames ( 8 ).MotionThreshold ( 96 ) );
+        Image in, a, b;
+
+        uint32_t seed = 12345;
+        auto noise = [&] { seed = seed * 1664525u + 1013904223u; return (int)( ( seed >> 24 ) % 33 ) - 16; };
+
+        double inputError = 0.0, recursiveError = 0.0, stackError = 0.0, difference = 0.0, inputMean = 0.0, recursiveMean = 0.0, stackMean = 0.0;
+        size_t samples = 0;
+
+        for ( int f = 0; f < kFrames; f++ )
+        {
+            for ( auto& p : in.Pixels ) p = (uint8_t)( kTruth + noise ( ) );
+            recursive.Process ( in.Pixels.data ( ), kSize.x * 4, a.AsPlane ( ) );
+            stack.Process ( in.Pixels.data ( ), kSize.x * 4, b.AsPlane ( ) );
+
+            if ( f < kFrames / 2 ) continue;
+            for ( size_t i = 0; i < in.Pixels.size ( ); i++ )
+            {
+                inputError += std::abs ( in.Pixels[i] - kTruth );
+                recursiveError += std::abs ( a.Pixels[i] - kTruth );
+                stackError += std::abs ( b.Pixels[i] - kTruth );
+                difference += std::abs ( a.Pixels[i] - b.Pixels[i] );
+                inputMean += in.Pixels[i];
+                recursiveMean += a.Pixels[i];
+                stackMean += b.Pixels[i];
+                samples++;
+            }
+        }
+
+        inputError /= samples;
+        recursiveError /= samples;
+        stackError /= samples;
+        difference /= samples;
+        inputMean /= samples;
+        recursiveMean /= samples;
+        stackMean /= samples;
+
+        AX_CHECK ( recursiveError < inputError * 0.6 );
+        AX_CHECK ( stackError < inputError * 0.6 );
+        AX_CHECK ( difference < inputError * 0.6 );
+        AX_CHECK ( std::abs ( recursiveMean - inputMean ) < 1.0 );
+        AX_CHECK ( std::abs ( stackMean - inputMean ) < 1.0 );
+    }
+
+    void TestStackPassesMotion ( )
+    {
+        // A change past the threshold is motion, not noise, and comes straight through
+        Denoiser denoiser ( DenoiseOptions ( DenoiseMode::Stack ).Frames ( 8 ).MotionThreshold ( 24 ) );
+        Image out;
+
+        auto dark = Filled ( 20 );
+        for ( int i = 0; i < 8; i++ ) denoiser.Process ( dark.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+
+        auto bright = Filled ( 220 );
+        denoiser.Process ( bright.Pixels.data ( ), kSize.x * 4, out.AsPlane ( ) );
+        for ( auto p : out.Pixels ) AX_CHECK ( p >= 219 );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "StackIsSlidingMean", TestStackIsSlidingMean },
+        { "StackFillsWindow", TestStackFillsWindow },
+        { "RecursiveAndStackConverge", TestRecursiveAndStackConverge },
+        { "StackPassesMotion", TestStackPassesMotion },
+    } );
+}
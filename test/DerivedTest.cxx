@@ -0,0 +1,201 @@
+//
+//  DerivedTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureDerived.h"
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <thread>
+
+using namespace AX::Video;
+
+namespace
+{
+    const Vec2i kSize{ 8, 4 };
+
+    // Written over in place the way a capture reuses the frame it wrote last time round
+    class ReusedFrame : public Frame
+    {
+    public:
+
+        ReusedFrame ( )
+            : Frame ( PixelFormat::RGB32, kSize, std::make_shared<std::vector<uint8_t>> ( (size_t)kSize.x * kSize.y * 4 ) )
+        {
+            auto pixels = std::static_pointer_cast<std::vector<uint8_t>> ( _storage );
+            AddPlane ( { pixels->data ( ), (ptrdiff_t)kSize.x * 4, kSize } );
+        }
+
+        void Write ( uint8_t value, bool isReset )
+        {
+            if ( isReset ) ResetDerived ( );
+            auto& plane = GetPlane ( );
+            std::memset ( plane.Data, value, (size_t)plane.RowBytes * plane.Size.y );
+        }
+    };
+
+    // Non-uniform pixels, wide enough for the SIMD paths and with a tail they leave to scalar
+    FrameRef MakeFrame ( const Vec2i& size, uint32_t seed )
+    {
+        auto pixels = std::make_shared<std::vector<uint8_t>> ( (size_t)size.x * size.y * 4 );
+        for ( auto& p : *pixels )
+        {
+            seed = seed * 1664525u + 1013904223u;
+            p = (uint8_t)( seed >> 24 );
+        }
+
+        auto frame = std::make_shared<Frame> ( PixelFormat::RGB32, size, pixels );
+        frame->AddPlane ( { pixels->data ( ), (ptrdiff_t)size.x * 4, size } );
+        return frame;
+    }
+
+    void TestGrayMatchesScalar ( )
+    {
+        const Vec2i size{ 37, 6 };
+        auto frame = MakeFrame ( size, 7 );
+        auto& plane = frame->GetPlane ( );
+        auto& gray = frame->GetGray ( );
+        AX_CHECK ( gray.Size == size );
+
+        int mismatches = 0;
+        for ( int32_t y = 0; y < size.y; y++ )
+        {
+            for ( int32_t x = 0; x < size.x; x++ )
+            {
+                const uint8_t* p = plane.Data + plane.RowBytes * y + x * 4;
+                const int expected = ( p[0] * 29 + p[1] * 150 + p[2] * 77 + 128 ) >> 8;
+                if ( gray.GetRow ( y )[x] != expected ) mismatches++;
+            }
+        }
+
+        AX_CHECK ( mismatches == 0 );
+    }
+
+    void TestPyramidMatchesScalar ( )
+    {
+        // Level 1 is 18 wide and level 2 is 9, so both take the SIMD path for their first 8 or 16.
+        // It may round up by one more than the scalar box filter.
+        auto frame = MakeFrame ( { 37, 10 }, 11 );
+        for ( size_t level = 1; level <= 2; level++ )
+        {
+            auto& above = frame->GetPyramidLevel ( level - 1 );
+            auto& below = frame->GetPyramidLevel ( level );
+            AX_CHECK ( below.Size.x == above.Size.x / 2 && below.Size.y == above.Size.y / 2 );
+
+            for ( int32_t y = 0; y < below.Size.y; y++ )
+            {
+                const uint8_t* upper = above.GetRow ( y * 2 );
+                const uint8_t* lower = above.GetRow ( y * 2 + 1 );
+                for ( int32_t x = 0; x < below.Size.x; x++ )
+                {
+                    const int expected = ( upper[x * 2] + upper[x * 2 + 1] + lower[x * 2] + lower[x * 2 + 1] + 2 ) / 4;
+                    const int difference = below.GetRow ( y )[x] - expected;
+                    AX_CHECK ( difference >= 0 && difference <= 1 );
+                }
+            }
+        }
+    }
+
+    void TestComputedOnce ( )
+    {
+        // Threads asking for the same frame's gray at once share one computation
+        constexpr int kThreads = 4, kFrames = 20;
+        ResetDerivedStats ( );
+
+        for ( int i = 0; i < kFrames; i++ )
+        {
+            auto frame = MakeFrame ( { 640, 48 }, (uint32_t)i );
+            std::atomic<int> arrived{ 0 };
+            std::array<const GrayPlane*, kThreads> results{ };
+            std::vector<std::thread> threads;
+            for ( int t = 0; t < kThreads; t++ )
+            {
+                threads.emplace_back ( [&, t]
+                {
+                    arrived++;
+                    while ( arrived.load ( ) < kThreads ) std::this_thread::yield ( );
+                    results[t] = &frame->GetGray ( );
+                } );
+            }
+
+            for ( auto& thread : threads ) thread.join ( );
+            for ( auto* result : results ) AX_CHECK ( result == results[0] );
+        }
+
+        auto stats = GetDerivedStats ( );
+        AX_CHECK ( stats.Computed == kFrames );
+        AX_CHECK ( stats.Hits + stats.Waits == (uint64_t)kFrames * ( kThreads - 1 ) );
+    }
+
+    void TestReuseResets ( )
+    {
+        ReusedFrame frame;
+        frame.Write ( 40, true );
+        AX_CHECK ( frame.GetGray ( ).Size == kSize );
+        AX_CHECK ( frame.GetGray ( ).GetRow ( 0 )[0] == 40 );
+        AX_CHECK ( frame.GetHistogram ( ).Mean == 40.0 );
+        AX_CHECK ( frame.GetIntegral ( ).Sum ( 0, 0, kSize.x, kSize.y ) == 40u * kSize.x * kSize.y );
+
+        frame.Write ( 200, true );
+        AX_CHECK ( frame.GetGray ( ).GetRow ( 0 )[0] == 200 );
+        AX_CHECK ( frame.GetPyramidLevel ( 1 ).GetRow ( 0 )[0] == 200 );
+        AX_CHECK ( frame.GetHistogram ( ).Mean == 200.0 );
+        AX_CHECK ( frame.GetIntegral ( ).Sum ( 0, 0, kSize.x, kSize.y ) == 200u * kSize.x * kSize.y );
+    }
+
+    void TestCacheIsKept ( )
+    {
+        // Without the reset the products are served as first computed, which is why a capture
+        // has to reset before writing
+        ReusedFrame frame;
+        frame.Write ( 40, true );
+        const auto* gray = &frame.GetGray ( );
+        AX_CHECK ( gray->GetRow ( 0 )[0] == 40 );
+
+        frame.Write ( 200, false );
+        AX_CHECK ( &frame.GetGray ( ) == gray );
+        AX_CHECK ( frame.GetGray ( ).GetRow ( 0 )[0] == 40 );
+    }
+
+    void TestFailedComputeRetries ( )
+    {
+        // A plane far too large to allocate gray for, so computing it throws. The next ask has to
+        // try again rather than wait on a computation that's never going to finish.
+        auto pixels = std::make_shared<std::vector<uint8_t>> ( (size_t)kSize.x * kSize.y * 4, 90 );
+        auto frame = std::make_shared<Frame> ( PixelFormat::RGB32, kSize, pixels );
+        frame->AddPlane ( { pixels->data ( ), (ptrdiff_t)kSize.x * 4, { 1 << 30, 1 << 30 } } );
+
+        bool isThrown = false;
+        try { frame->GetGray ( ); } catch ( const std::exception& ) { isThrown = true; }
+        AX_CHECK ( isThrown );
+
+        frame->GetPlane ( ).Size = kSize;
+        auto result = std::make_shared<std::promise<int>> ( );
+        auto retried = result->get_future ( );
+        std::thread ( [frame, result] { result->set_value ( frame->GetGray ( ).GetRow ( 0 )[0] ); } ).detach ( );
+
+        // Detached, so a hang fails the check rather than the whole run
+        const bool isReady = retried.wait_for ( std::chrono::seconds ( 5 ) ) == std::future_status::ready;
+        AX_CHECK ( isReady );
+        if ( isReady ) AX_CHECK ( retried.get ( ) == 90 );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "ReuseResets", TestReuseResets },
+        { "CacheIsKept", TestCacheIsKept },
+        { "FailedComputeRetries", TestFailedComputeRetries },
+        { "GrayMatchesScalar", TestGrayMatchesScalar },
+        { "PyramidMatchesScalar", TestPyramidMatchesScalar },
+        { "ComputedOnce", TestComputedOnce },
+    } );
+}
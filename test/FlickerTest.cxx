@@ -0,0 +1,188 @@
+//
+//  FlickerTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureFlicker.h"
+#include <cmath>
+#include <random>
+
+using namespace AX::Video;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    enum class Scene
+    {
+        Flat,
+        Textured,   // Blocks of random brightness
+        Panning,    // The same, moving sideways
+        Tilting,    // The same, moving up
+        Stripes     // Strong static horizontal bands
+    };
+
+    struct Setup
+    {
+        double      LightHz{ 100.0 };   // Twice the line frequency
+        double      FPS{ 30.0 };
+        double      Readout{ 0.8 };     // Fraction of the frame interval
+        double      Modulation{ 0.05 };
+        Scene       Content{ Scene::Textured };
+        bool        IsReversed{ false };
+        int         Frames{ 60 };
+    };
+
+    uint32_t Hash ( uint32_t x )
+    {
+        x ^= x >> 16; x *= 0x7feb352d;
+        x ^= x >> 15; x *= 0x846ca68b;
+        x ^= x >> 16;
+        return x;
+    }
+
+    // Renders a rolling shutter camera's view of the scene under the light and runs the
+    // detector over it.
+    FlickerDetector::Result Run ( const Setup& setup )
+    {
+        const Vec2i size{ 640, 480 };
+        std::vector<uint8_t> pixels ( (size_t)size.x * size.y * 4 );
+
+        FlickerDetector detector ( FlickerOptions ( true ).Frames ( 30 ) );
+        std::mt19937 rng ( 1 );
+        std::uniform_real_distribution<double> jitter ( -0.001, 0.001 );
+
+        // Drawing every pixel's noise from the distribution is most of the run time
+        std::normal_distribution<double> distribution ( 0.0, 3.0 );
+        std::vector<double> noise ( 1 << 16 );
+        for ( auto& n : noise ) n = distribution ( rng );
+
+        const double lineTime = setup.Readout / ( setup.FPS * size.y );
+
+        for ( int f = 0; f < setup.Frames; f++ )
+        {
+            const double timestamp = 12.345 + f / setup.FPS + jitter ( rng );
+            const int shiftX = setup.Content == Scene::Panning ? f * 3 : 0;
+            const int shiftY = setup.Content == Scene::Tilting ? f * 3 : 0;
+
+            for ( int y = 0; y < size.y; y++ )
+            {
+                const int line = setup.IsReversed ? size.y - 1 - y : y;
+                const double gain = 1.0 + setup.Modulation * std::sin ( 2.0 * kPi * setup.LightHz * ( timestamp + line * lineTime ) );
+
+                for ( int x = 0; x < size.x; x++ )
+                {
+                    double base = 120.0;
+                    switch ( setup.Content )
+                    {
+                        case Scene::Flat:       break;
+                        case Scene::Stripes:    base = 120.0 + 60.0 * std::sin ( 2.0 * kPi * y * 3.5 / size.y ); break;
+                        default:                base = 60.0 + Hash ( ( ( x + shiftX ) / 16 ) * 7919 + ( ( y + shiftY ) / 16 ) * 104729 ) % 140 + 0.05 * y; break;
+                    }
+
+                    const auto value = (uint8_t)std::clamp ( base * gain + noise[rng ( ) & 0xFFFF], 0.0, 255.0 );
+                    uint8_t* p = pixels.data ( ) + ( (size_t)y * size.x + x ) * 4;
+                    p[0] = p[1] = p[2] = value;
+                    p[3] = 255;
+                }
+            }
+
+            detector.Process ( pixels.data ( ), size.x * 4, size, timestamp );
+        }
+
+        return detector.GetResult ( );
+    }
+
+    void Expect ( const char * name, const Setup& setup, PowerLineFrequency expected )
+    {
+        auto result = Run ( setup );
+        AX_CHECK ( result.Frequency == expected );
+        if ( result.Frequency != expected ) std::printf ( "  %s: %s, confidence %.2f modulation %.4f\n", name, ToString ( result.Frequency ), result.Confidence, result.Modulation );
+    }
+
+    Setup Make ( double lightHz, double fps, double readout = 0.8, Scene scene = Scene::Textured )
+    {
+        Setup setup;
+        setup.LightHz = lightHz;
+        setup.FPS = fps;
+        setup.Readout = readout;
+        setup.Content = scene;
+        return setup;
+    }
+
+    void TestMovingBands ( )
+    {
+        // Common frame rates, where the bands drift from frame to frame
+        Expect ( "50Hz at 30fps", Make ( 100.0, 30.0 ), PowerLineFrequency::Hz50 );
+        Expect ( "60Hz at 25fps", Make ( 120.0, 25.0 ), PowerLineFrequency::Hz60 );
+        Expect ( "50Hz at 15fps", Make ( 100.0, 15.0, 0.6 ), PowerLineFrequency::Hz50 );
+        Expect ( "50Hz at 24fps", Make ( 100.0, 24.0, 0.7 ), PowerLineFrequency::Hz50 );
+        Expect ( "50Hz at 60fps", Make ( 100.0, 60.0, 0.95 ), PowerLineFrequency::Hz50 );
+        Expect ( "50Hz panning", Make ( 100.0, 30.0, 0.8, Scene::Panning ), PowerLineFrequency::Hz50 );
+
+        auto reversed = Make ( 100.0, 30.0, 0.9 );
+        reversed.IsReversed = true;
+        Expect ( "50Hz read out bottom up", reversed, PowerLineFrequency::Hz50 );
+    }
+
+    void TestStationaryBands ( )
+    {
+        // A whole number of the light's cycles per frame, so the bands stand still. They need
+        // the scene to move past them to be told from stripes.
+        Expect ( "60Hz at 30fps", Make ( 120.0, 30.0, 0.9, Scene::Tilting ), PowerLineFrequency::Hz60 );
+        Expect ( "60Hz at 15fps", Make ( 120.0, 15.0, 0.8, Scene::Tilting ), PowerLineFrequency::Hz60 );
+        Expect ( "50Hz at 25fps", Make ( 100.0, 25.0, 0.9, Scene::Tilting ), PowerLineFrequency::Hz50 );
+    }
+
+    void TestNoFlicker ( )
+    {
+        auto steady = [] ( double fps, Scene scene )
+        {
+            auto setup = Make ( 100.0, fps, 0.8, scene );
+            setup.Modulation = 0.0;
+            return setup;
+        };
+
+        Expect ( "Flat", steady ( 30.0, Scene::Flat ), PowerLineFrequency::Unknown );
+        Expect ( "Textured", steady ( 30.0, Scene::Textured ), PowerLineFrequency::Unknown );
+        Expect ( "Panning", steady ( 30.0, Scene::Panning ), PowerLineFrequency::Unknown );
+        Expect ( "Tilting at 30fps", steady ( 30.0, Scene::Tilting ), PowerLineFrequency::Unknown );
+        Expect ( "Tilting at 25fps", steady ( 25.0, Scene::Tilting ), PowerLineFrequency::Unknown );
+        Expect ( "Static stripes at 30fps", steady ( 30.0, Scene::Stripes ), PowerLineFrequency::Unknown );
+        Expect ( "Static stripes at 25fps", steady ( 25.0, Scene::Stripes ), PowerLineFrequency::Unknown );
+
+        // Below MinModulation
+        auto faint = Make ( 100.0, 30.0 );
+        faint.Modulation = 0.005;
+        Expect ( "Faint 50Hz", faint, PowerLineFrequency::Unknown );
+    }
+
+    void TestExposure ( )
+    {
+        // log2 seconds: -7 is 1/128s. Flicker free needs whole half cycles of the line,
+        // 1/100s multiples under 50Hz and 1/120s under 60Hz.
+        const int32_t at50 = FlickerFreeExposure ( PowerLineFrequency::Hz50, -7, -11, -2, 1.0 / 30.0 );
+        const int32_t at60 = FlickerFreeExposure ( PowerLineFrequency::Hz60, -7, -11, -2, 1.0 / 30.0 );
+        AX_CHECK ( std::pow ( 2.0, at50 ) <= 1.0 / 30.0 );
+        AX_CHECK ( std::pow ( 2.0, at60 ) <= 1.0 / 30.0 );
+
+        // Nothing between -11 and -8 is long enough for a half cycle
+        AX_CHECK ( FlickerFreeExposure ( PowerLineFrequency::Hz50, -9, -11, -8, 1.0 / 30.0 ) == -9 );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "MovingBands", TestMovingBands },
+        { "StationaryBands", TestStationaryBands },
+        { "NoFlicker", TestNoFlicker },
+        { "Exposure", TestExposure },
+    } );
+}
@@ -0,0 +1,73 @@
+//
+//  FlightRecorderTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureFlightRecorder.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace AX::Video;
+
+namespace
+{
+    std::string ReadFile ( const std::filesystem::path& path )
+    {
+        std::ifstream in ( path );
+        std::stringstream contents;
+        contents << in.rdbuf ( );
+        return contents.str ( );
+    }
+
+    void TestRecordsInOrder ( )
+    {
+        auto recorder = FlightRecorder::Create ( 64 );
+        AX_CHECK ( recorder->GetCapacity ( ) == 64 );
+        for ( int64_t i = 0; i < 70; i++ ) recorder->Record ( FlightEvent::Marker, i );
+
+        // Only the last capacity's worth survive, oldest first
+        auto snapshot = recorder->TakeSnapshot ( "test" );
+        AX_CHECK ( snapshot.Records.size ( ) == 64 );
+        for ( size_t i = 0; i < snapshot.Records.size ( ); i++ ) AX_CHECK ( snapshot.Records[i].A == (int64_t)i + 6 );
+    }
+
+    void TestJSONReason ( )
+    {
+        // Host supplied, so long and full of things that need escaping
+        std::string reason = "Watchdog: \"stalled\" \\ ";
+        reason += std::string ( 300, 'x' );
+        reason += '\x01';
+        reason += "\ttail";
+
+        auto recorder = FlightRecorder::Create ( 8 );
+        recorder->Record ( FlightEvent::Marker, 1, 2 );
+
+        auto path = std::filesystem::temp_directory_path ( ) / "AX-VideoCapture-FlightRecorderTest.json";
+        AX_CHECK ( FlightRecorder::WriteJSON ( recorder->TakeSnapshot ( reason ), path.string ( ) ) );
+
+        auto json = ReadFile ( path );
+        std::filesystem::remove ( path );
+
+        std::string escaped = "Watchdog: \\\"stalled\\\" \\\\ " + std::string ( 300, 'x' ) + "\\u0001\\u0009tail";
+        AX_CHECK ( json.find ( "\"reason\": \"" + escaped + "\"," ) != std::string::npos );
+        AX_CHECK ( json.find ( "\"type\": \"Marker\"" ) != std::string::npos );
+        AX_CHECK ( json.size ( ) >= 4 && json.compare ( json.size ( ) - 4, 4, "]\n}\n" ) == 0 );
+
+        for ( char c : json ) AX_CHECK ( (unsigned char)c >= 0x20 || c == '\n' );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "RecordsInOrder", TestRecordsInOrder },
+        { "JSONReason", TestJSONReason },
+    } );
+}
@@ -0,0 +1,141 @@
+//
+//  QueueTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureQueue.h"
+#include <thread>
+
+using namespace AX::Video;
+
+namespace
+{
+    void TestFifo ( )
+    {
+        BoundedQueue<int> queue ( 3 );
+        AX_CHECK ( queue.Capacity ( ) == 4 );
+
+        // Round the ring a few times so the sequences wrap past the capacity
+        int next = 0, expected = 0;
+        for ( int round = 0; round < 5; round++ )
+        {
+            for ( int i = 0; i < 3; i++ )
+            {
+                int value = next++;
+                AX_CHECK ( queue.TryPush ( value ) );
+            }
+
+            AX_CHECK ( queue.Size ( ) == 3 );
+            for ( int i = 0; i < 3; i++ )
+            {
+                int value = -1;
+                AX_CHECK ( queue.TryPop ( value ) && value == expected++ );
+            }
+        }
+
+        AX_CHECK ( queue.Size ( ) == 0 );
+    }
+
+    void TestFullAndEmpty ( )
+    {
+        BoundedQueue<std::shared_ptr<int>> queue ( 2 );
+        std::shared_ptr<int> value;
+        AX_CHECK ( !queue.TryPop ( value ) && !value );
+
+        for ( int i = 0; i < 2; i++ )
+        {
+            value = std::make_shared<int> ( i );
+            AX_CHECK ( queue.TryPush ( value ) && !value );
+        }
+
+        // Turned away and left with the caller
+        value = std::make_shared<int> ( 2 );
+        AX_CHECK ( !queue.TryPush ( value ) && value && *value == 2 );
+        AX_CHECK ( queue.Size ( ) == 2 );
+
+        // Popped slots let go of what they held
+        std::weak_ptr<int> first;
+        AX_CHECK ( queue.TryPop ( value ) && *value == 0 );
+        first = value;
+        value.reset ( );
+        AX_CHECK ( first.expired ( ) );
+
+        AX_CHECK ( queue.TryPop ( value ) && *value == 1 );
+        AX_CHECK ( !queue.TryPop ( value ) );
+        AX_CHECK ( queue.Size ( ) == 0 );
+    }
+
+    void TestConcurrent ( )
+    {
+        // Every value arrives exactly once, and each producer's values in the order pushed
+        constexpr int kProducers = 2, kConsumers = 2, kCount = 20000;
+        BoundedQueue<int> queue ( 64 );
+        std::vector<std::vector<int>> seen ( kConsumers );
+        std::atomic<int> popped{ 0 };
+
+        std::vector<std::thread> threads;
+        for ( int p = 0; p < kProducers; p++ )
+        {
+            threads.emplace_back ( [&, p]
+            {
+                for ( int i = 0; i < kCount; i++ )
+                {
+                    int value = p * kCount + i;
+                    while ( !queue.TryPush ( value ) ) std::this_thread::yield ( );
+                }
+            } );
+        }
+
+        for ( int c = 0; c < kConsumers; c++ )
+        {
+            threads.emplace_back ( [&, c]
+            {
+                int value = 0;
+                while ( popped.load ( ) < kProducers * kCount )
+                {
+                    if ( queue.TryPop ( value ) )
+                    {
+                        seen[c].push_back ( value );
+                        popped++;
+                    } else
+                    {
+                        std::this_thread::yield ( );
+                    }
+                }
+            } );
+        }
+
+        for ( auto& thread : threads ) thread.join ( );
+
+        std::vector<int> counts ( kProducers * kCount, 0 );
+        bool isOrdered = true;
+        for ( auto& values : seen )
+        {
+            std::vector<int> last ( kProducers, -1 );
+            for ( int value : values )
+            {
+                counts[value]++;
+                if ( value <= last[value / kCount] ) isOrdered = false;
+                last[value / kCount] = value;
+            }
+        }
+
+        AX_CHECK ( std::all_of ( counts.begin ( ), counts.end ( ), [] ( int count ) { return count == 1; } ) );
+        AX_CHECK ( isOrdered );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "Fifo", TestFifo },
+        { "FullAndEmpty", TestFullAndEmpty },
+        { "Concurrent", TestConcurrent },
+    } );
+}
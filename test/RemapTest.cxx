@@ -0,0 +1,141 @@
+//
+//  RemapTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureRemap.h"
+#include "AX-VideoCaptureViewport.h"
+#include <cmath>
+#include <cstdlib>
+
+using namespace AX::Video;
+
+namespace
+{
+    const Vec2i kSize{ 320, 240 };
+
+    // A smooth gradient, so resampling differences show up as small value differences
+    struct Image
+    {
+        Image ( const Vec2i& size ) : Size ( size ), Pixels ( (size_t)size.x * size.y * 4 ) { }
+
+        Plane                   GetPlane ( ) { return { Pixels.data ( ), (ptrdiff_t)Size.x * 4, Size }; }
+
+        Vec2i                   Size;
+        std::vector<uint8_t>    Pixels;
+    };
+
+    Image MakeGradient ( )
+    {
+        Image image ( kSize );
+        for ( int32_t y = 0; y < kSize.y; y++ )
+        {
+            for ( int32_t x = 0; x < kSize.x; x++ )
+            {
+                uint8_t* p = &image.Pixels[( (size_t)y * kSize.x + x ) * 4];
+                p[0] = (uint8_t)( x * 255 / ( kSize.x - 1 ) );
+                p[1] = (uint8_t)( y * 255 / ( kSize.y - 1 ) );
+                p[2] = 128;
+                p[3] = 255;
+            }
+        }
+
+        return image;
+    }
+
+    Image Process ( Remapper& remapper, const Image& src )
+    {
+        Image dst ( kSize );
+        remapper.Process ( src.Pixels.data ( ), (ptrdiff_t)src.Size.x * 4, src.Size, dst.GetPlane ( ) );
+        return dst;
+    }
+
+    int MaxDifference ( const Image& a, const Image& b )
+    {
+        int worst = 0;
+        for ( size_t i = 0; i < a.Pixels.size ( ); i++ ) worst = std::max ( worst, std::abs ( (int)a.Pixels[i] - (int)b.Pixels[i] ) );
+        return worst;
+    }
+
+    LensCalibration MakeLens ( )
+    {
+        LensCalibration lens;
+        lens.Fx = lens.Fy = 300.0;
+        lens.Cx = kSize.x * 0.5;
+        lens.Cy = kSize.y * 0.5;
+        lens.K1 = -0.2;
+        lens.K2 = 0.05;
+        return lens;
+    }
+
+    void TestViewThroughModel ( )
+    {
+        // The view re-samples the model's grid rather than evaluating the lens again, which
+        // should land within a step of evaluating it at every pixel
+        const auto src = MakeGradient ( );
+        const auto view = ViewportController::ToMatrix ( { 0.4, 0.6, 2.5 }, kSize );
+
+        Remapper coarse ( RemapOptions ( ).Undistort ( MakeLens ( ) ).Parallel ( false ) );
+        Remapper exact ( RemapOptions ( ).Undistort ( MakeLens ( ) ).GridStep ( 1 ).Parallel ( false ) );
+        coarse.SetView ( view );
+        exact.SetView ( view );
+        AX_CHECK ( MaxDifference ( Process ( coarse, src ), Process ( exact, src ) ) <= 2 );
+    }
+
+    void TestViewMatchesComposed ( )
+    {
+        // An affine model interpolates exactly, so viewing it matches folding the view into it.
+        // A crop takes the separable path, a rotation the general one.
+        const std::array<double, 9> model{ 0.9, 0.1, 12.0, -0.05, 0.95, 6.0, 0.0, 0.0, 1.0 };
+        const double cosine = std::cos ( 0.1 ), sine = std::sin ( 0.1 );
+        const std::array<double, 9> rotation{ cosine, -sine, 160.0 - cosine * 160.0 + sine * 120.0, sine, cosine, 120.0 - sine * 160.0 - cosine * 120.0, 0.0, 0.0, 1.0 };
+        const auto src = MakeGradient ( );
+
+        for ( auto& view : { ViewportController::ToMatrix ( { 0.3, 0.35, 1.7 }, kSize ), rotation } )
+        {
+            std::array<double, 9> composed{ };
+            for ( int r = 0; r < 3; r++ )
+            {
+                for ( int c = 0; c < 3; c++ )
+                {
+                    for ( int k = 0; k < 3; k++ ) composed[r * 3 + c] += model[r * 3 + k] * view[k * 3 + c];
+                }
+            }
+
+            Remapper viewed ( RemapOptions ( ).Homography ( model ).Parallel ( false ) );
+            Remapper folded ( RemapOptions ( ).Homography ( composed ).Parallel ( false ) );
+            viewed.SetView ( view );
+            AX_CHECK ( MaxDifference ( Process ( viewed, src ), Process ( folded, src ) ) <= 1 );
+        }
+    }
+
+    void TestIdentityRestores ( )
+    {
+        const auto src = MakeGradient ( );
+        Remapper fresh ( RemapOptions ( ).Undistort ( MakeLens ( ) ).Parallel ( false ) );
+        Remapper remapper ( RemapOptions ( ).Undistort ( MakeLens ( ) ).Parallel ( false ) );
+
+        Process ( remapper, src );
+        remapper.SetView ( ViewportController::ToMatrix ( { 0.25, 0.25, 2.0 }, kSize ) );
+        AX_CHECK ( MaxDifference ( Process ( remapper, src ), Process ( fresh, src ) ) > 0 );
+
+        remapper.SetView ( { 1, 0, 0, 0, 1, 0, 0, 0, 1 } );
+        AX_CHECK ( MaxDifference ( Process ( remapper, src ), Process ( fresh, src ) ) == 0 );
+        AX_CHECK ( remapper.GetMapBytes ( ) == fresh.GetMapBytes ( ) );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "ViewThroughModel", TestViewThroughModel },
+        { "ViewMatchesComposed", TestViewMatchesComposed },
+        { "IdentityRestores", TestIdentityRestores },
+    } );
+}
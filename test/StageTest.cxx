@@ -0,0 +1,311 @@
+//
+//  StageTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureStage.h"
+#include <thread>
+#include <variant>
+
+using namespace AX::Video;
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    // Holds a stage's first item in its function until opened, so the ones behind it queue up
+    class Gate
+    {
+    public:
+
+        void Enter ( )
+        {
+            std::unique_lock<std::mutex> lock ( _mutex );
+            _entered++;
+            _changed.notify_all ( );
+            _changed.wait ( lock, [&] { return _isOpen; } );
+        }
+
+        bool WaitEntered ( int count )
+        {
+            std::unique_lock<std::mutex> lock ( _mutex );
+            return _changed.wait_for ( lock, 5s, [&] { return _entered >= count; } );
+        }
+
+        void Open ( )
+        {
+            std::lock_guard<std::mutex> lock ( _mutex );
+            _isOpen = true;
+            _changed.notify_all ( );
+        }
+
+    protected:
+
+        std::mutex              _mutex;
+        std::condition_variable _changed;
+        int                     _entered{ 0 };
+        bool                    _isOpen{ false };
+    };
+
+    bool WaitUntil ( const std::function<bool ( )>& condition )
+    {
+        const auto end = std::chrono::steady_clock::now ( ) + 5s;
+        while ( !condition ( ) )
+        {
+            if ( std::chrono::steady_clock::now ( ) > end ) return false;
+            std::this_thread::sleep_for ( 1ms );
+        }
+
+        return true;
+    }
+
+    // Runs item 0 behind a gate, pushes 1 - 4 into a queue of 2 and returns the order items ran in
+    std::vector<int> RunPolicy ( DropPolicy policy, StageStats& stats, std::vector<bool>& pushed )
+    {
+        auto state = std::make_shared<PipelineState> ( );
+        Gate gate;
+        std::mutex mutex;
+        std::vector<int> ran;
+
+        auto stage = std::make_shared<Stage<int, int>> ( state, "stage", StageOptions ( ).Capacity ( 2 ).Drop ( policy ), [&] ( int& value, const StageContext& ) -> std::optional<int>
+        {
+            if ( value == 0 ) gate.Enter ( );
+            std::lock_guard<std::mutex> lock ( mutex );
+            ran.push_back ( value );
+            return value;
+        } );
+
+        pushed.push_back ( stage->Push ( 0 ) );
+        AX_CHECK ( gate.WaitEntered ( 1 ) );
+        for ( int i = 1; i <= 4; i++ ) pushed.push_back ( stage->Push ( i ) );
+
+        gate.Open ( );
+        AX_CHECK ( WaitUntil ( [&] { auto s = stage->GetStats ( ); return s.Processed + s.Dropped + s.Cancelled >= 5 && s.Running == 0; } ) );
+        state->Stop ( );
+
+        stats = stage->GetStats ( );
+        std::lock_guard<std::mutex> lock ( mutex );
+        return ran;
+    }
+
+    void TestDropNewest ( )
+    {
+        StageStats stats;
+        std::vector<bool> pushed;
+        auto ran = RunPolicy ( DropPolicy::DropNewest, stats, pushed );
+        AX_CHECK ( ( pushed == std::vector<bool>{ true, true, true, false, false } ) );
+        AX_CHECK ( ( ran == std::vector<int>{ 0, 1, 2 } ) );
+        AX_CHECK ( stats.Received == 5 && stats.Dropped == 2 && stats.Processed == 3 && stats.Emitted == 3 );
+        AX_CHECK ( stats.MaxQueueDepth == 2 );
+    }
+
+    void TestDropOldest ( )
+    {
+        StageStats stats;
+        std::vector<bool> pushed;
+        auto ran = RunPolicy ( DropPolicy::DropOldest, stats, pushed );
+        AX_CHECK ( ( pushed == std::vector<bool>{ true, true, true, true, true } ) );
+        AX_CHECK ( ( ran == std::vector<int>{ 0, 3, 4 } ) );
+        AX_CHECK ( stats.Dropped == 2 && stats.Processed == 3 && stats.Cancelled == 0 );
+    }
+
+    void TestLatestWins ( )
+    {
+        // The running item and everything queued behind it are superseded by the newest
+        StageStats stats;
+        std::vector<bool> pushed;
+        auto ran = RunPolicy ( DropPolicy::LatestWins, stats, pushed );
+        AX_CHECK ( ( ran == std::vector<int>{ 0, 4 } ) );
+        AX_CHECK ( stats.Dropped == 2 && stats.Processed == 2 && stats.Emitted == 1 );
+        AX_CHECK ( stats.Cancelled == 2 );
+    }
+
+    void TestSinkCancelled ( )
+    {
+        // A sink never has output, its superseded item is still counted
+        auto state = std::make_shared<PipelineState> ( );
+        Gate gate;
+        auto sink = std::make_shared<Stage<int, std::monostate>> ( state, "sink", StageOptions ( ).Drop ( DropPolicy::LatestWins ), [&] ( int& value, const StageContext& ) -> std::optional<std::monostate>
+        {
+            if ( value == 0 ) gate.Enter ( );
+            return std::nullopt;
+        } );
+
+        sink->Push ( 0 );
+        AX_CHECK ( gate.WaitEntered ( 1 ) );
+        sink->Push ( 1 );
+        gate.Open ( );
+        AX_CHECK ( WaitUntil ( [&] { return sink->GetStats ( ).Processed == 2; } ) );
+        state->Stop ( );
+
+        auto stats = sink->GetStats ( );
+        AX_CHECK ( stats.Cancelled == 1 && stats.Emitted == 0 );
+    }
+
+    void TestStaleness ( )
+    {
+        auto state = std::make_shared<PipelineState> ( );
+        Gate gate;
+        std::atomic_bool wasCancelled{ false };
+        auto stage = std::make_shared<Stage<int, int>> ( state, "stage", StageOptions ( ).Drop ( DropPolicy::LatestWins ), [&] ( int& value, const StageContext& context ) -> std::optional<int>
+        {
+            if ( value != 0 ) return value;
+            AX_CHECK ( !context.IsCancelled ( ) );
+            gate.Enter ( );
+            wasCancelled = context.IsCancelled ( );
+            return value;
+        } );
+
+        stage->Push ( 0 );
+        AX_CHECK ( gate.WaitEntered ( 1 ) );
+        AX_CHECK ( !stage->IsStale ( 1 ) );
+
+        stage->Push ( 1 );
+        AX_CHECK ( stage->IsStale ( 1 ) && !stage->IsStale ( 2 ) );
+        gate.Open ( );
+        AX_CHECK ( WaitUntil ( [&] { return stage->GetStats ( ).Processed == 2; } ) );
+        AX_CHECK ( wasCancelled.load ( ) );
+
+        // Only LatestWins makes anything stale
+        stage->SetDropPolicy ( DropPolicy::DropOldest );
+        AX_CHECK ( !stage->IsStale ( 1 ) );
+        state->Stop ( );
+    }
+
+    // Deadlines are measured on the state's clock, which the tests move by hand
+    struct ManualClock
+    {
+        std::shared_ptr<std::atomic<double>> Now{ std::make_shared<std::atomic<double>> ( 10.0 ) };
+        std::function<double ( )> Get ( ) const { return [now = Now] { return now->load ( ); }; }
+    };
+
+    // Item 0 is held until the clock's past both items' deadlines, so it finishes late and
+    // item 1 is reached late
+    StageStats RunDeadline ( DeadlinePolicy policy, bool& wasCancelled )
+    {
+        ManualClock clock;
+        auto state = std::make_shared<PipelineState> ( clock.Get ( ) );
+        Gate gate;
+        std::atomic<int> started{ 0 };
+        auto stage = std::make_shared<Stage<int, int>> ( state, "stage", StageOptions ( ).Budget ( 0.1 ).Deadline ( policy ), [&] ( int& value, const StageContext& context ) -> std::optional<int>
+        {
+            started++;
+            AX_CHECK ( context.GetTimestamp ( ) == 10.0 && context.GetDeadline ( ) == 10.0 + 0.1 );
+            AX_CHECK ( !context.IsLate ( ) );
+            gate.Enter ( );
+            wasCancelled = context.IsCancelled ( );
+            AX_CHECK ( context.IsLate ( ) );
+            return value;
+        } );
+
+        stage->Push ( 0 );
+        AX_CHECK ( gate.WaitEntered ( 1 ) );
+        stage->Push ( 1 );
+        clock.Now->store ( 10.5 );
+        gate.Open ( );
+
+        AX_CHECK ( WaitUntil ( [&] { auto s = stage->GetStats ( ); return s.Processed + s.Expired == 2 && s.Running == 0; } ) );
+        state->Stop ( );
+        AX_CHECK ( started.load ( ) == 1 );
+        return stage->GetStats ( );
+    }
+
+    void TestDeadlineSkip ( )
+    {
+        // Finishing late still emits, reaching an item late skips it
+        bool wasCancelled = true;
+        auto stats = RunDeadline ( DeadlinePolicy::Skip, wasCancelled );
+        AX_CHECK ( !wasCancelled );
+        AX_CHECK ( stats.Processed == 1 && stats.Late == 1 && stats.Emitted == 1 && stats.Expired == 1 );
+    }
+
+    void TestDeadlineCancel ( )
+    {
+        bool wasCancelled = false;
+        auto stats = RunDeadline ( DeadlinePolicy::Cancel, wasCancelled );
+        AX_CHECK ( wasCancelled );
+        AX_CHECK ( stats.Processed == 1 && stats.Late == 1 && stats.Emitted == 0 && stats.Expired == 1 );
+    }
+
+    void TestHostFrameStamped ( )
+    {
+        // A frame the host built has no timestamp, so it's stamped on push rather than being
+        // treated as long past its deadline
+        ManualClock clock;
+        auto state = std::make_shared<PipelineState> ( clock.Get ( ) );
+        std::atomic<double> timestamp{ 0.0 };
+        auto sink = std::make_shared<Stage<FrameRef, std::monostate>> ( state, "sink", StageOptions ( ).Budget ( 0.1 ), [&] ( FrameRef&, const StageContext& context ) -> std::optional<std::monostate>
+        {
+            timestamp = context.GetTimestamp ( );
+            return std::nullopt;
+        } );
+
+        auto frame = std::make_shared<Frame> ( );
+        AX_CHECK ( sink->Push ( frame ) );
+        AX_CHECK ( WaitUntil ( [&] { return sink->GetStats ( ).Processed == 1; } ) );
+        AX_CHECK ( timestamp.load ( ) == 10.0 );
+
+        // A captured frame keeps its own
+        frame->SetTimestamp ( 9.95 );
+        AX_CHECK ( sink->Push ( frame ) );
+        AX_CHECK ( WaitUntil ( [&] { return sink->GetStats ( ).Processed == 2; } ) );
+        AX_CHECK ( timestamp.load ( ) == 9.95 );
+
+        state->Stop ( );
+        AX_CHECK ( sink->GetStats ( ).Expired == 0 );
+    }
+
+    void TestStopWaits ( )
+    {
+        // Stop returns only once the running item's finished, having seen itself cancelled, and
+        // the queued ones are never started
+        auto state = std::make_shared<PipelineState> ( );
+        Gate gate;
+        std::atomic<int> started{ 0 };
+        std::atomic_bool isFinished{ false };
+        auto stage = std::make_shared<Stage<int, int>> ( state, "stage", StageOptions ( ), [&] ( int& value, const StageContext& context ) -> std::optional<int>
+        {
+            started++;
+            if ( value != 0 ) return value;
+
+            gate.Enter ( );
+            while ( !context.IsCancelled ( ) ) std::this_thread::sleep_for ( 1ms );
+            std::this_thread::sleep_for ( 20ms );
+            isFinished = true;
+            return value;
+        } );
+
+        stage->Push ( 0 );
+        AX_CHECK ( gate.WaitEntered ( 1 ) );
+        stage->Push ( 1 );
+        stage->Push ( 2 );
+        gate.Open ( );
+
+        state->Stop ( );
+        AX_CHECK ( isFinished.load ( ) );
+        AX_CHECK ( started.load ( ) == 1 );
+        AX_CHECK ( !stage->Push ( 3 ) );
+        AX_CHECK ( stage->GetStats ( ).Running == 0 );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "DropNewest", TestDropNewest },
+        { "DropOldest", TestDropOldest },
+        { "LatestWins", TestLatestWins },
+        { "SinkCancelled", TestSinkCancelled },
+        { "Staleness", TestStaleness },
+        { "DeadlineSkip", TestDeadlineSkip },
+        { "DeadlineCancel", TestDeadlineCancel },
+        { "HostFrameStamped", TestHostFrameStamped },
+        { "StopWaits", TestStopWaits },
+    } );
+}
@@ -0,0 +1,190 @@
+//
+//  ViewportTest.cxx
+//  AX-VideoCapture
+//
+//  Created by Andrew Wright (@axjxwright) on 18/10/26.
+//  (c) 2026 AX Interactive (axinteractive.com.au)
+//
+//
+
+#include "AX-VideoCaptureTest.h"
+#include "AX-VideoCaptureViewport.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+using namespace AX::Video;
+
+namespace
+{
+    bool Near ( double a, double b, double tolerance = 1.0e-9 )
+    {
+        return std::abs ( a - b ) <= tolerance;
+    }
+
+    void TestEase ( )
+    {
+        for ( auto easing : { Easing::Linear, Easing::EaseIn, Easing::EaseOut, Easing::EaseInOut } )
+        {
+            AX_CHECK ( Ease ( easing, 0.0 ) == 0.0 );
+            AX_CHECK ( Near ( Ease ( easing, 1.0 ), 1.0 ) );
+            AX_CHECK ( Ease ( easing, -1.0 ) == 0.0 );
+            AX_CHECK ( Near ( Ease ( easing, 2.0 ), 1.0 ) );
+
+            double last = 0.0;
+            for ( int i = 1; i <= 100; i++ )
+            {
+                double e = Ease ( easing, i / 100.0 );
+                AX_CHECK ( e >= last );
+                last = e;
+            }
+        }
+
+        AX_CHECK ( Near ( Ease ( Easing::EaseInOut, 0.5 ), 0.5 ) );
+        AX_CHECK ( Ease ( Easing::EaseIn, 0.5 ) < 0.5 );
+        AX_CHECK ( Ease ( Easing::EaseOut, 0.5 ) > 0.5 );
+    }
+
+    void TestClamp ( )
+    {
+        ViewportController controller ( ViewportOptions ( true ).MaxZoom ( 4.0 ) );
+
+        // Pushed back inside the frame at the corner
+        controller.Set ( { 0.0, 1.0, 2.0 } );
+        auto view = controller.Evaluate ( 0.0 );
+        AX_CHECK ( Near ( view.X, 0.25 ) && Near ( view.Y, 0.75 ) && Near ( view.Zoom, 2.0 ) );
+
+        // Zoom is held to 1 .. MaxZoom, and the whole frame can only be centred
+        controller.Set ( { 0.1, 0.1, 100.0 } );
+        view = controller.Evaluate ( 0.1 );
+        AX_CHECK ( Near ( view.Zoom, 4.0 ) && Near ( view.X, 0.125 ) );
+
+        controller.Set ( { 0.1, 0.9, 0.5 } );
+        view = controller.Evaluate ( 0.2 );
+        AX_CHECK ( Near ( view.Zoom, 1.0 ) && Near ( view.X, 0.5 ) && Near ( view.Y, 0.5 ) );
+        AX_CHECK ( ViewportController::IsWholeFrame ( view ) );
+
+        view = controller.GetCurrent ( );
+        AX_CHECK ( Near ( view.Zoom, 1.0 ) && Near ( view.X, 0.5 ) );
+    }
+
+    void TestToMatrix ( )
+    {
+        const Vec2i size{ 640, 480 };
+        auto apply = [] ( const std::array<double, 9>& m, double x, double y )
+        {
+            return std::make_pair ( m[0] * x + m[1] * y + m[2], m[3] * x + m[4] * y + m[5] );
+        };
+
+        auto identity = ViewportController::ToMatrix ( { }, size );
+        auto [x0, y0] = apply ( identity, 0.0, 0.0 );
+        auto [x1, y1] = apply ( identity, 639.0, 479.0 );
+        AX_CHECK ( Near ( x0, 0.0 ) && Near ( y0, 0.0 ) && Near ( x1, 639.0 ) && Near ( y1, 479.0 ) );
+
+        // The top left quarter: first and last output pixels land on the first and last it covers
+        auto quarter = ViewportController::ToMatrix ( { 0.25, 0.25, 2.0 }, size );
+        auto [qx0, qy0] = apply ( quarter, 0.0, 0.0 );
+        auto [qx1, qy1] = apply ( quarter, 639.0, 479.0 );
+        AX_CHECK ( Near ( qx0, 0.0 ) && Near ( qy0, 0.0 ) && Near ( qx1, 319.0 ) && Near ( qy1, 239.0 ) );
+    }
+
+    void TestAnimate ( )
+    {
+        ViewportController controller ( ViewportOptions ( true ) );
+        controller.AnimateTo ( { 0.75, 0.5, 2.0 }, 1.0, Easing::Linear );
+
+        auto view = controller.Evaluate ( 10.0 );
+        AX_CHECK ( Near ( view.X, 0.5 ) && Near ( view.Zoom, 1.0 ) );
+
+        // Zoom is interpolated geometrically
+        view = controller.Evaluate ( 10.5 );
+        AX_CHECK ( Near ( view.X, 0.625 ) && Near ( view.Zoom, std::sqrt ( 2.0 ) ) );
+
+        view = controller.Evaluate ( 11.0 );
+        AX_CHECK ( Near ( view.X, 0.75 ) && Near ( view.Zoom, 2.0 ) );
+
+        view = controller.Evaluate ( 12.0 );
+        AX_CHECK ( Near ( view.X, 0.75 ) && Near ( view.Y, 0.5 ) && Near ( view.Zoom, 2.0 ) );
+
+        // A zero length animation jumps straight there
+        controller.AnimateTo ( { 0.5, 0.5, 1.0 }, 0.0 );
+        view = controller.Evaluate ( 12.1 );
+        AX_CHECK ( Near ( view.X, 0.5 ) && Near ( view.Zoom, 1.0 ) );
+    }
+
+    void TestFollowDeadZone ( )
+    {
+        ViewportController controller ( ViewportOptions ( true ).FollowDeadZone ( 0.1 ).FollowSmoothing ( 0.2 ) );
+        controller.Set ( { 0.5, 0.5, 2.0 } );
+        double time = 0.0;
+        controller.Evaluate ( time );
+
+        // At zoom 2 the dead zone is 0.05 of the frame either side, so this doesn't move it
+        controller.Follow ( { 0.54, 0.47, 0.0 } );
+        Viewport view;
+        for ( int i = 0; i < 120; i++ ) view = controller.Evaluate ( time += 1.0 / 60.0 );
+        AX_CHECK ( Near ( view.X, 0.5 ) && Near ( view.Y, 0.5 ) && Near ( view.Zoom, 2.0 ) );
+
+        // Further out it's followed until the target rests on the dead zone's edge
+        controller.Follow ( { 0.7, 0.5, 0.0 } );
+        view = controller.Evaluate ( time += 1.0 / 60.0 );
+        AX_CHECK ( view.X > 0.5 && view.X < 0.65 );
+
+        for ( int i = 0; i < 300; i++ ) view = controller.Evaluate ( time += 1.0 / 60.0 );
+        AX_CHECK ( Near ( view.X, 0.65, 1.0e-3 ) && Near ( view.Zoom, 2.0 ) );
+    }
+
+    void TestConcurrentPublish ( )
+    {
+        // Every published view has Y == X and Zoom == 2 + X, so a torn read shows up as a
+        // view that breaks that
+        ViewportController controller ( ViewportOptions ( true ) );
+        controller.Set ( { 0.5, 0.5, 2.5 } );
+        controller.Evaluate ( 0.0 );
+        std::atomic_bool isDone{ false };
+
+        auto publish = [&] ( int seed )
+        {
+            uint32_t state = (uint32_t)seed;
+            while ( !isDone.load ( ) )
+            {
+                state = state * 1664525u + 1013904223u;
+                const double v = 0.3 + 0.4 * ( state >> 8 ) / (double)( 1u << 24 );
+                controller.Set ( { v, v, 2.0 + v } );
+            }
+        };
+
+        std::thread a ( publish, 1 );
+        std::thread b ( publish, 2 );
+
+        size_t torn = 0, changes = 0;
+        double last = 0.5;
+        for ( int i = 1; i <= 200000; i++ )
+        {
+            auto view = controller.Evaluate ( i * 1.0e-3 );
+            if ( view.X != view.Y || !Near ( view.Zoom, 2.0 + view.X, 1.0e-12 ) ) torn++;
+            if ( view.X != last ) changes++;
+            last = view.X;
+            if ( ( i & 1023 ) == 0 ) std::this_thread::yield ( );
+        }
+
+        isDone.store ( true );
+        a.join ( );
+        b.join ( );
+        AX_CHECK ( torn == 0 );
+        AX_CHECK ( changes > 0 );
+    }
+}
+
+int main ( )
+{
+    return Test::Run (
+    {
+        { "Ease", TestEase },
+        { "Clamp", TestClamp },
+        { "ToMatrix", TestToMatrix },
+        { "Animate", TestAnimate },
+        { "FollowDeadZone", TestFollowDeadZone },
+        { "ConcurrentPublish", TestConcurrentPublish },
+    } );
+}